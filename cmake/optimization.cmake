@@ -0,0 +1,127 @@
+# Optimization profiles for every target built by this project
+#
+# MULTIPARTY_LTO       Link-time optimization (IPO), so field arithmetic and
+#                      the share loops inline across translation units
+# MULTIPARTY_NATIVE    -march=native: lets the compiler use the build host's
+#                      vector units outside the hand-dispatched SIMD kernels;
+#                      the binaries then only run on that CPU class
+# MULTIPARTY_PGO       OFF, GENERATE or USE. The training workload is the
+#                      benchmark suite:
+#
+#   cmake -S . -B build -DMULTIPARTY_PGO=GENERATE
+#   cmake --build build -j && cmake --build build --target pgo-train
+#   cmake -S . -B build -DMULTIPARTY_PGO=USE && cmake --build build -j
+#
+# GCC names profile files after the object paths, so GENERATE and USE must
+# use the same build directory (the CMakePresets.json "pgo-*" presets do).
+
+option(MULTIPARTY_LTO "Link-time optimization" OFF)
+option(MULTIPARTY_NATIVE "Tune for the build host (-march=native)" OFF)
+set(MULTIPARTY_PGO OFF CACHE STRING "Profile-guided optimization: OFF, GENERATE or USE")
+set_property(CACHE MULTIPARTY_PGO PROPERTY STRINGS OFF GENERATE USE)
+set(MULTIPARTY_PGO_DIR ${PROJECT_BINARY_DIR}/pgo-data CACHE PATH "Where PGO profiles are written and read")
+
+set(MULTIPARTY_PROFILE_COMPILE_OPTIONS)
+set(MULTIPARTY_PROFILE_LINK_OPTIONS)
+
+if(MULTIPARTY_LTO)
+    include(CheckIPOSupported)
+    check_ipo_supported(RESULT ipo_supported OUTPUT ipo_output LANGUAGES CXX)
+    if(NOT ipo_supported)
+        message(FATAL_ERROR "MULTIPARTY_LTO: link-time optimization unavailable: ${ipo_output}")
+    endif()
+endif()
+
+if(MULTIPARTY_NATIVE)
+    include(CheckCXXCompilerFlag)
+    check_cxx_compiler_flag(-march=native HAVE_MARCH_NATIVE)
+    if(NOT HAVE_MARCH_NATIVE)
+        message(FATAL_ERROR "MULTIPARTY_NATIVE: ${CMAKE_CXX_COMPILER_ID} does not accept -march=native")
+    endif()
+    list(APPEND MULTIPARTY_PROFILE_COMPILE_OPTIONS -march=native)
+endif()
+
+set(MULTIPARTY_PGO_PROFDATA ${MULTIPARTY_PGO_DIR}/multiparty.profdata)
+if(MULTIPARTY_PGO STREQUAL "GENERATE")
+    if(CMAKE_CXX_COMPILER_ID STREQUAL "GNU")
+        # Atomic counters: the TLS benchmark runs server and client threads
+        set(pgo_flags -fprofile-generate=${MULTIPARTY_PGO_DIR} -fprofile-update=atomic)
+    elseif(CMAKE_CXX_COMPILER_ID MATCHES "Clang")
+        set(pgo_flags -fprofile-generate=${MULTIPARTY_PGO_DIR})
+        get_filename_component(compiler_dir ${CMAKE_CXX_COMPILER} DIRECTORY)
+        find_program(LLVM_PROFDATA NAMES llvm-profdata HINTS ${compiler_dir})
+        if(NOT LLVM_PROFDATA)
+            message(FATAL_ERROR "MULTIPARTY_PGO: llvm-profdata not found (needed to merge Clang profiles)")
+        endif()
+    else()
+        message(FATAL_ERROR "MULTIPARTY_PGO: unsupported compiler ${CMAKE_CXX_COMPILER_ID}")
+    endif()
+    list(APPEND MULTIPARTY_PROFILE_COMPILE_OPTIONS ${pgo_flags})
+    list(APPEND MULTIPARTY_PROFILE_LINK_OPTIONS ${pgo_flags})
+elseif(MULTIPARTY_PGO STREQUAL "USE")
+    if(CMAKE_CXX_COMPILER_ID STREQUAL "GNU")
+        # Code the training never reached keeps its normal optimization
+        list(APPEND MULTIPARTY_PROFILE_COMPILE_OPTIONS
+             -fprofile-use=${MULTIPARTY_PGO_DIR} -fprofile-partial-training -fprofile-correction
+             -Wno-missing-profile)
+    elseif(CMAKE_CXX_COMPILER_ID MATCHES "Clang")
+        if(NOT EXISTS ${MULTIPARTY_PGO_PROFDATA})
+            message(FATAL_ERROR "MULTIPARTY_PGO=USE: ${MULTIPARTY_PGO_PROFDATA} missing; "
+                                "build with GENERATE and run the pgo-train target first")
+        endif()
+        list(APPEND MULTIPARTY_PROFILE_COMPILE_OPTIONS -fprofile-use=${MULTIPARTY_PGO_PROFDATA})
+    else()
+        message(FATAL_ERROR "MULTIPARTY_PGO: unsupported compiler ${CMAKE_CXX_COMPILER_ID}")
+    endif()
+elseif(MULTIPARTY_PGO)
+    message(FATAL_ERROR "MULTIPARTY_PGO must be OFF, GENERATE or USE (got ${MULTIPARTY_PGO})")
+endif()
+
+message(STATUS "Optimization profile: ${CMAKE_BUILD_TYPE}, LTO ${MULTIPARTY_LTO}, "
+               "native ${MULTIPARTY_NATIVE}, PGO ${MULTIPARTY_PGO}")
+
+#
+# Apply the selected profile to one target
+#
+function(multiparty_apply_profile target)
+    target_compile_options(${target} PRIVATE ${MULTIPARTY_PROFILE_COMPILE_OPTIONS})
+    target_link_options(${target} PRIVATE ${MULTIPARTY_PROFILE_LINK_OPTIONS})
+    if(MULTIPARTY_LTO)
+        set_property(TARGET ${target} PROPERTY INTERPROCEDURAL_OPTIMIZATION ON)
+    endif()
+endfunction()
+
+#
+# pgo-train: run the benchmark suite on the instrumented binaries, starting
+# from empty profiles. Iteration counts are cut down from the benchmark
+# defaults; the point is coverage of the hot paths, not stable timings.
+#
+function(multiparty_add_pgo_training)
+    if(NOT MULTIPARTY_PGO STREQUAL "GENERATE")
+        add_custom_target(pgo-train
+            COMMAND ${CMAKE_COMMAND} -E echo "pgo-train needs a -DMULTIPARTY_PGO=GENERATE build"
+            COMMAND ${CMAKE_COMMAND} -E false)
+        return()
+    endif()
+
+    set(merge_command)
+    if(CMAKE_CXX_COMPILER_ID MATCHES "Clang")
+        set(merge_command COMMAND ${LLVM_PROFDATA} merge -output=${MULTIPARTY_PGO_PROFDATA} ${MULTIPARTY_PGO_DIR})
+    endif()
+
+    add_custom_target(pgo-train
+        COMMAND ${CMAKE_COMMAND} -E rm -rf ${MULTIPARTY_PGO_DIR}
+        COMMAND ${CMAKE_COMMAND} -E make_directory ${MULTIPARTY_PGO_DIR}
+        COMMAND bench_poly_eval 2000
+        COMMAND bench_coefficient_source 2000000
+        COMMAND bench_reconstruct 20000
+        COMMAND bench_chunk_layout 200
+        COMMAND bench_robust_reconstruct 20
+        COMMAND bench_packed_sharing 200
+        COMMAND bench_vss 2
+        COMMAND bench_tls_handshake --key both --connections 16 --duration 2
+        ${merge_command}
+        WORKING_DIRECTORY ${PROJECT_BINARY_DIR}
+        COMMENT "Training PGO profiles with the benchmark suite"
+        USES_TERMINAL)
+endfunction()
@@ -13,13 +13,11 @@ command_exists() {
     command -v "$1" >/dev/null 2>&1
 }
 
-# Check for C++ compiler
-echo "[1/4] Checking for C++ compiler..."
+# Check for C++ compiler and CMake
+echo "[1/4] Checking for C++ compiler and CMake..."
 if command_exists g++; then
-    COMPILER="g++"
     echo "✓ Found g++"
 elif command_exists clang++; then
-    COMPILER="clang++"
     echo "✓ Found clang++"
 else
     echo "✗ No C++ compiler found!"
@@ -30,6 +28,17 @@ else
     echo "  macOS:         xcode-select --install"
     exit 1
 fi
+if command_exists cmake; then
+    echo "✓ Found $(cmake --version | head -n 1)"
+else
+    echo "✗ CMake not found!"
+    echo ""
+    echo "Please install CMake 3.16 or newer:"
+    echo "  Ubuntu/Debian: sudo apt-get install cmake"
+    echo "  Fedora/RHEL:   sudo dnf install cmake"
+    echo "  macOS:         brew install cmake"
+    exit 1
+fi
 
 # Check for OpenSSL
 echo ""
@@ -47,26 +56,24 @@ else
 fi
 
 # Compile
+# Extra CMake options pass through, e.g. ./build.sh -DMULTIPARTY_LTO=ON
+REPO_ROOT="$(cd "$(dirname "$0")/../.." && pwd)"
+BUILD_DIR="${BUILD_DIR:-$REPO_ROOT/build}"
+
 echo ""
 echo "[3/4] Compiling source files..."
-echo "Compiler: $COMPILER"
-echo "Flags: -std=c++17 -Wall -Wextra -O2 -g"
+echo "Build directory: $BUILD_DIR"
 echo ""
 
-$COMPILER -std=c++17 -Wall -Wextra -O2 -g \
-    shamir_secret_sharing.cpp \
-    tls_multiparty.cpp \
-    test_tls_multiparty.cpp \
-    -o test_tls_multiparty \
-    -lssl -lcrypto
+cmake -S "$REPO_ROOT" -B "$BUILD_DIR" "$@" && cmake --build "$BUILD_DIR" -j
 
 if [ $? -eq 0 ]; then
     echo ""
     echo "[4/4] Build successful!"
-    echo "✓ Executable created: ./test_tls_multiparty"
+    echo "✓ Tools, tests and benchmarks are in $BUILD_DIR"
     echo ""
     echo "To run the tests:"
-    echo "  ./test_tls_multiparty"
+    echo "  ctest --test-dir $BUILD_DIR --output-on-failure"
     echo ""
 else
     echo ""
@@ -0,0 +1,121 @@
+/**
+ * Whole-key split and reconstruct for 4096- and 8192-bit private exponents:
+ * one Share vector per chunk distributed into per-party std::vector<Share>
+ * (the previous layout) against splitChunks/reconstructChunks writing
+ * per-party value arrays.
+ *
+ * Usage: bench_chunk_layout [iterations]
+ */
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "shamir_secret_sharing.hpp"
+
+namespace {
+
+using Share = ShamirSecretSharing::Share;
+using PartyShares = ShamirSecretSharing::PartyShares;
+
+const uint64_t PRIME = 2305843009213693951ULL;  // 2^61 - 1
+
+template <class Fn>
+double usPer(size_t iterations, Fn fn) {
+    fn();   // warm-up
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        fn();
+    }
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / iterations;
+}
+
+/**
+ * Split per chunk and push each share into its party's vector
+ */
+std::vector<std::vector<Share>> splitPerChunk(ShamirSecretSharing& sss, const std::vector<uint64_t>& chunks) {
+    std::vector<std::vector<Share>> parties(sss.getNumShares());
+    for (uint64_t chunk : chunks) {
+        auto shares = sss.split(chunk);
+        for (size_t p = 0; p < parties.size(); ++p) {
+            parties[p].push_back(shares[p]);
+        }
+    }
+    return parties;
+}
+
+/**
+ * Gather t shares per chunk and reconstruct it
+ */
+void reconstructPerChunk(ShamirSecretSharing& sss, const std::vector<std::vector<Share>>& parties,
+                         const std::vector<size_t>& indices, uint64_t* out) {
+    std::vector<Share> shares;
+    shares.reserve(indices.size());
+    for (size_t c = 0; c < parties[0].size(); ++c) {
+        shares.clear();
+        for (size_t p : indices) {
+            shares.push_back(parties[p][c]);
+        }
+        out[c] = sss.reconstruct(shares.data(), shares.size());
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t iterations = argc > 1 ? std::stoul(argv[1]) : 2000;
+    std::mt19937_64 rng(48);
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "3-of-5 whole-key sharing, us per key" << std::endl;
+    std::cout << std::left << std::setw(10) << "key bits" << std::setw(8) << "chunks" << std::setw(14) << "operation"
+              << std::right << std::setw(12) << "per-chunk" << std::setw(12) << "per-party" << std::setw(10)
+              << "speedup" << std::setw(16) << "share bytes" << std::endl;
+    for (size_t key_bits : {size_t{4096}, size_t{8192}}) {
+        size_t num_chunks = (key_bits + 60) / 61;
+        ShamirSecretSharing sss(3, 5, PRIME);
+        std::vector<uint64_t> chunks(num_chunks);
+        for (auto& chunk : chunks) {
+            chunk = rng() % PRIME;
+        }
+
+        auto per_chunk = splitPerChunk(sss, chunks);
+        auto per_party = sss.splitChunks(chunks.data(), chunks.size());
+        std::vector<size_t> indices{0, 2, 4};
+        std::vector<const PartyShares*> present{&per_party[0], &per_party[2], &per_party[4]};
+        std::vector<uint64_t> out_chunk(num_chunks), out_party(num_chunks);
+        reconstructPerChunk(sss, per_chunk, indices, out_chunk.data());
+        sss.reconstructChunks(present, out_party.data());
+        if (out_chunk != chunks || out_party != chunks) {
+            std::cerr << "✗ Reconstruction failed at " << key_bits << " bits" << std::endl;
+            return 1;
+        }
+
+        // Timed splits write to scratch copies: present points into per_party
+        std::vector<std::vector<Share>> split_chunk_out;
+        std::vector<PartyShares> split_party_out;
+        double split_chunk_us = usPer(iterations, [&] { split_chunk_out = splitPerChunk(sss, chunks); });
+        double split_party_us = usPer(iterations, [&] {
+            split_party_out = sss.splitChunks(chunks.data(), chunks.size());
+        });
+        double rec_chunk_us = usPer(iterations, [&] { reconstructPerChunk(sss, per_chunk, indices, out_chunk.data()); });
+        double rec_party_us = usPer(iterations, [&] { sss.reconstructChunks(present, out_party.data()); });
+
+        size_t bytes_chunk = num_chunks * sizeof(Share);
+        size_t bytes_party = sizeof(size_t) + num_chunks * sizeof(uint64_t);
+        std::string label = std::to_string(key_bits);
+        std::cout << std::left << std::setw(10) << label << std::setw(8) << num_chunks << std::setw(14) << "split"
+                  << std::right << std::setw(12) << split_chunk_us << std::setw(12) << split_party_us
+                  << std::setw(9) << std::setprecision(2) << split_chunk_us / split_party_us << "x"
+                  << std::setw(16) << (std::to_string(bytes_chunk) + " -> " + std::to_string(bytes_party))
+                  << std::setprecision(1) << std::endl;
+        std::cout << std::left << std::setw(10) << label << std::setw(8) << num_chunks << std::setw(14)
+                  << "reconstruct" << std::right << std::setw(12) << rec_chunk_us << std::setw(12) << rec_party_us
+                  << std::setw(9) << std::setprecision(2) << rec_chunk_us / rec_party_us << "x"
+                  << std::setprecision(1) << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,82 @@
+/**
+ * Coefficient generation throughput: std::mt19937_64 with a per-call
+ * uniform_int_distribution (the previous split() path) against the
+ * buffered DRBG sources, plus end-to-end split() rates.
+ *
+ * Usage: bench_coefficient_source [coefficients]
+ */
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "coefficient_source.hpp"
+#include "shamir_secret_sharing.hpp"
+
+namespace {
+
+const uint64_t PRIME = 2305843009213693951ULL;  // 2^61 - 1
+volatile uint64_t sink;
+
+template <class Fn>
+double perSecond(size_t count, Fn fn) {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return count / seconds;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    using coefficient_source::DrbgSource;
+    size_t count = argc > 1 ? std::stoul(argv[1]) : 20000000;
+    std::vector<uint64_t> out(4096);
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "Coefficients in [1, 2^61 - 2], M/s:" << std::endl;
+
+    std::random_device rd;
+    std::mt19937_64 rng(rd());
+    double mt = perSecond(count, [&] {
+        for (size_t done = 0; done < count; done += out.size()) {
+            for (auto& v : out) {
+                std::uniform_int_distribution<uint64_t> dist(1, PRIME - 1);
+                v = dist(rng);
+            }
+            sink = out[0];
+        }
+    });
+    std::cout << "  mt19937_64 (not a CSPRNG) " << std::setw(8) << mt / 1e6 << std::endl;
+
+    for (auto [cipher, name] : {std::pair{DrbgSource::Cipher::ChaCha20, "ChaCha20 DRBG"},
+                                std::pair{DrbgSource::Cipher::Aes256Ctr, "AES-256-CTR DRBG"}}) {
+        DrbgSource source(cipher);
+        double rate = perSecond(count, [&] {
+            for (size_t done = 0; done < count; done += out.size()) {
+                source.generate(PRIME, out.data(), out.size());
+                sink = out[0];
+            }
+        });
+        std::cout << "  " << std::left << std::setw(25) << name << std::right << std::setw(9)
+                  << rate / 1e6 << "  (" << std::setprecision(2) << rate / mt << "x)" << std::setprecision(1)
+                  << std::endl;
+    }
+
+    std::cout << "\nsplit() with the default source, splits/s:" << std::endl;
+    const std::pair<size_t, size_t> shapes[] = {{3, 5}, {16, 64}, {64, 256}};
+    for (auto [t, n] : shapes) {
+        ShamirSecretSharing sss(t, n, PRIME);
+        size_t splits = 2000000 / n;
+        double rate = perSecond(splits, [&] {
+            for (size_t i = 0; i < splits; ++i) {
+                sink = sss.split(i % PRIME)[0].value;
+            }
+        });
+        std::cout << "  (" << t << ", " << n << ")" << std::setw(14) << rate << std::endl;
+    }
+    return 0;
+}
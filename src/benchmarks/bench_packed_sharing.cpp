@@ -0,0 +1,71 @@
+/**
+ * Packed sharing of a 2048-bit d (34 chunks): bytes each party stores per
+ * pack size k against the CPU cost of splitting and reconstructing.
+ *
+ * Usage: bench_packed_sharing [iterations]
+ */
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "shamir_secret_sharing.hpp"
+
+namespace {
+
+using Share = ShamirSecretSharing::Share;
+
+const uint64_t PRIME = 2305843009213693951ULL;  // 2^61 - 1
+const size_t NUM_CHUNKS = 34;
+const size_t SHARE_BYTES = 16;                    // Share file record: id + value
+
+template <class Fn>
+double usPer(size_t iterations, Fn fn) {
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        fn();
+    }
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / iterations;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t iterations = argc > 1 ? std::stoul(argv[1]) : 2000;
+    std::mt19937_64 rng(43);
+    std::vector<uint64_t> chunks(NUM_CHUNKS);
+    for (auto& chunk : chunks) chunk = rng() % PRIME;
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "Packed sharing, 34 chunks (2048-bit d)" << std::endl;
+    for (auto [t, n] : std::vector<std::pair<size_t, size_t>>{{3, 5}, {3, 9}}) {
+        ShamirSecretSharing sss(t, n, PRIME);
+        std::cout << "\n" << t << "-of-" << n << std::endl;
+        std::cout << std::left << std::setw(4) << "k" << std::setw(10) << "needs" << std::right
+                  << std::setw(14) << "bytes/party" << std::setw(10) << "saved" << std::setw(12)
+                  << "split us" << std::setw(14) << "rebuild us" << std::endl;
+
+        double base_split = 0, base_rebuild = 0;
+        for (size_t k = 1; k + t - 1 <= n; ++k) {
+            std::vector<std::vector<Share>> packed;
+            double split_us = usPer(iterations, [&] { packed = sss.splitPacked(chunks, k); });
+            double rebuild_us = usPer(iterations, [&] { sss.reconstructPacked(packed, k); });
+            if (k == 1) {
+                base_split = split_us;
+                base_rebuild = rebuild_us;
+            }
+            size_t bytes = packed.size() * SHARE_BYTES;
+            std::cout << std::left << std::setw(4) << k << std::setw(10)
+                      << (std::to_string(t + k - 1) + " of " + std::to_string(n)) << std::right
+                      << std::setw(14) << bytes << std::setw(9) << 100.0 * (1.0 - bytes / double(NUM_CHUNKS * SHARE_BYTES))
+                      << "%" << std::setw(8) << split_us << " (" << std::setprecision(2)
+                      << split_us / base_split << "x)" << std::setw(8) << std::setprecision(1) << rebuild_us
+                      << " (" << std::setprecision(2) << rebuild_us / base_rebuild << "x)"
+                      << std::setprecision(1) << std::endl;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,87 @@
+/**
+ * Share generation throughput: per-point generic evaluation (what split()
+ * did before) against the batch Mersenne evaluator on each backend.
+ *
+ * Usage: bench_poly_eval [iterations]
+ */
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "field_ops.hpp"
+#include "poly_eval.hpp"
+
+namespace {
+
+volatile uint64_t sink;
+
+template <class Fn>
+double nsPerShare(size_t iterations, size_t shares_per_iteration, Fn fn) {
+    fn();   // warm-up
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        fn();
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    return ns / (iterations * shares_per_iteration);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    using poly_eval::Backend;
+    size_t iterations = argc > 1 ? std::stoul(argv[1]) : 20000;
+    const uint64_t p = poly_eval::MERSENNE_61;
+    field_ops::FastField fast(p);
+    field_ops::ConstantTimeField constant_time(p);
+    std::mt19937_64 rng(1);
+
+    std::cout << "Polynomial evaluation over GF(2^61 - 1), ns per share (best backend: "
+              << poly_eval::backendName(poly_eval::bestBackend()) << ")" << std::endl;
+    std::cout << std::left << std::setw(10) << "(t, n)" << std::right
+              << std::setw(10) << "Fast" << std::setw(10) << "CT"
+              << std::setw(10) << "scalar" << std::setw(10) << "AVX2" << std::setw(10) << "AVX-512"
+              << std::setw(10) << "speedup" << std::endl;
+
+    const std::pair<size_t, size_t> shapes[] = {{3, 5}, {5, 16}, {16, 64}, {32, 256}, {64, 1024}};
+    for (auto [t, n] : shapes) {
+        std::vector<uint64_t> coefficients(t), xs(n), out(n);
+        for (auto& c : coefficients) c = rng() % p;
+        for (size_t i = 0; i < n; ++i) xs[i] = i + 1;
+        size_t iters = std::max<size_t>(1, iterations * 5 / n);
+
+        auto perPoint = [&](const auto& field) {
+            return nsPerShare(iters, n, [&] {
+                for (size_t i = 0; i < n; ++i) {
+                    out[i] = field_ops::evaluatePolynomial(field, coefficients.data(), t, xs[i]);
+                }
+                sink = out[0];
+            });
+        };
+
+        std::cout << std::left << std::setw(10) << ("(" + std::to_string(t) + ", " + std::to_string(n) + ")")
+                  << std::right << std::fixed << std::setprecision(1);
+        double generic = perPoint(fast);
+        std::cout << std::setw(10) << generic << std::setw(10) << perPoint(constant_time);
+
+        double best = generic;
+        for (Backend backend : {Backend::Scalar, Backend::Avx2, Backend::Avx512}) {
+            if (!poly_eval::backendSupported(backend)) {
+                std::cout << std::setw(10) << "-";
+                continue;
+            }
+            double ns = nsPerShare(iters, n, [&] {
+                poly_eval::evaluateMersenne61(backend, coefficients.data(), t, xs.data(), n, out.data());
+                sink = out[0];
+            });
+            best = std::min(best, ns);
+            std::cout << std::setw(10) << ns;
+        }
+        std::cout << std::setw(9) << generic / best << "x" << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,118 @@
+/**
+ * Per-chunk reconstruction: the library's inline path (bitset duplicate
+ * check, stack scratch space) against the previous std::map duplicate check
+ * and heap-allocated coordinate vectors; then the compile-time 3-of-5
+ * table against interpolating from scratch.
+ *
+ * Usage: bench_reconstruct [iterations]
+ */
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "fixed_threshold.hpp"
+#include "shamir_secret_sharing.hpp"
+
+namespace {
+
+using Share = ShamirSecretSharing::Share;
+
+const uint64_t PRIME = 2305843009213693951ULL;  // 2^61 - 1
+
+template <class Fn>
+double nsPer(size_t iterations, Fn fn) {
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        fn();
+    }
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / iterations;
+}
+
+/**
+ * The allocation-heavy reconstruction this replaces
+ */
+uint64_t mapReconstruct(const field_ops::DefaultField& field, const std::vector<Share>& shares, size_t t) {
+    std::map<size_t, bool> seen;
+    for (const auto& share : shares) {
+        if (seen[share.id]) {
+            throw std::invalid_argument("Duplicate share IDs detected");
+        }
+        seen[share.id] = true;
+    }
+    std::vector<uint64_t> xs(t), ys(t);
+    for (size_t i = 0; i < t; ++i) {
+        xs[i] = field.reduce(shares[i].id);
+        ys[i] = field.reduce(shares[i].value);
+    }
+    return field_ops::interpolateAtZero(field, xs.data(), ys.data(), t);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t iterations = argc > 1 ? std::stoul(argv[1]) : 200000;
+    std::mt19937_64 rng(46);
+    field_ops::DefaultField field(PRIME);
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "Reconstruct one chunk, ns" << std::endl;
+    std::cout << std::left << std::setw(10) << "t-of-n" << std::right << std::setw(12) << "map+vector"
+              << std::setw(12) << "inline" << std::setw(10) << "speedup" << std::endl;
+    for (auto [t, n] : std::vector<std::pair<size_t, size_t>>{{3, 5}, {5, 9}, {16, 20}, {32, 40}}) {
+        ShamirSecretSharing sss(t, n, PRIME);
+        uint64_t secret = rng() % PRIME;
+        auto shares = sss.split(secret);
+        if (sss.reconstruct(shares) != secret || mapReconstruct(field, shares, t) != secret) {
+            std::cerr << "✗ Reconstruction failed at " << t << "-of-" << n << std::endl;
+            return 1;
+        }
+        size_t scaled = std::max<size_t>(iterations * 3 / (t * t), 1);
+        volatile uint64_t sink = 0;
+        double map_ns = nsPer(scaled, [&] { sink = sink + mapReconstruct(field, shares, t); });
+        double inline_ns = nsPer(scaled, [&] { sink = sink + sss.reconstruct(shares); });
+        std::cout << std::left << std::setw(10) << (std::to_string(t) + "-of-" + std::to_string(n)) << std::right
+                  << std::setw(12) << map_ns << std::setw(12) << inline_ns << std::setw(9)
+                  << std::setprecision(2) << map_ns / inline_ns << "x" << std::setprecision(1) << std::endl;
+    }
+
+    // 3-of-5: weights from the constexpr table vs computed per call
+    {
+        static constexpr fixed_threshold::ShamirSecretSharing<3, 5> fixed(PRIME);
+        ShamirSecretSharing sss(3, 5, PRIME);
+        uint64_t secret = rng() % PRIME;
+        auto all = sss.split(secret);
+        std::vector<Share> shares{all[4], all[1], all[2]};
+        uint64_t xs[3], ys[3];
+        for (size_t i = 0; i < 3; ++i) {
+            xs[i] = field.reduce(shares[i].id);
+            ys[i] = field.reduce(shares[i].value);
+        }
+        uint64_t fixed_secret = 0;
+        if (!fixed.reconstruct(shares.data(), fixed_secret) || fixed_secret != secret) {
+            std::cerr << "✗ Fixed 3-of-5 reconstruction failed" << std::endl;
+            return 1;
+        }
+        volatile uint64_t sink = 0;
+        double generic_ns = nsPer(iterations, [&] { sink = sink + field_ops::interpolateAtZero(field, xs, ys, 3); });
+        double fixed_ns = nsPer(iterations, [&] {
+            uint64_t value = 0;
+            fixed.reconstruct(shares.data(), value);
+            sink = sink + value;
+        });
+        double dispatch_ns = nsPer(iterations, [&] { sink = sink + sss.reconstruct(shares); });
+        std::cout << std::endl << "Fixed 3-of-5, ns" << std::endl;
+        std::cout << std::left << std::setw(22) << "interpolateAtZero" << std::right << std::setw(10) << generic_ns
+                  << std::endl;
+        std::cout << std::left << std::setw(22) << "constexpr table" << std::right << std::setw(10) << fixed_ns
+                  << std::setw(9) << std::setprecision(2) << generic_ns / fixed_ns << "x" << std::setprecision(1)
+                  << std::endl;
+        std::cout << std::left << std::setw(22) << "reconstruct (dispatch)" << std::right << std::setw(10)
+                  << dispatch_ns << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,136 @@
+/**
+ * Error-correcting reconstruction of a 2048-bit key (34 chunks): the batched
+ * Reed-Solomon decoder against retrying every t-subset until one agrees with
+ * enough of the other shares.
+ *
+ * Usage: bench_robust_reconstruct [iterations]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "reed_solomon.hpp"
+#include "shamir_secret_sharing.hpp"
+
+namespace {
+
+using Share = ShamirSecretSharing::Share;
+
+const uint64_t PRIME = 2305843009213693951ULL;  // 2^61 - 1
+const size_t NUM_CHUNKS = 34;
+
+template <class Fn>
+double msPer(size_t iterations, Fn fn) {
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        fn();
+    }
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / iterations;
+}
+
+/**
+ * Next t-subset of {0..m-1} in lexicographic order
+ */
+bool nextSubset(std::vector<size_t>& subset, size_t m) {
+    size_t t = subset.size();
+    for (size_t i = t; i-- > 0;) {
+        if (subset[i] < m - t + i) {
+            ++subset[i];
+            for (size_t j = i + 1; j < t; ++j) subset[j] = subset[j - 1] + 1;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Per chunk: interpolate through each t-subset and accept the first one whose
+ * polynomial matches at least m - e shares
+ */
+std::vector<uint64_t> subsetRetry(const std::vector<std::vector<Share>>& chunk_shares, size_t t) {
+    field_ops::DefaultField field(PRIME);
+    size_t m = chunk_shares[0].size();
+    size_t max_errors = (m - t) / 2;
+    std::vector<uint64_t> xs(m), ys(m), subset_xs(t), subset_ys(t), weights(m * t);
+    std::vector<uint64_t> secrets;
+    for (size_t i = 0; i < m; ++i) xs[i] = chunk_shares[0][i].id;
+
+    for (const auto& shares : chunk_shares) {
+        for (size_t i = 0; i < m; ++i) ys[i] = shares[i].value;
+        std::vector<size_t> subset(t);
+        for (size_t j = 0; j < t; ++j) subset[j] = j;
+        do {
+            for (size_t j = 0; j < t; ++j) subset_xs[j] = xs[subset[j]];
+            reed_solomon::lagrangeWeights(field, subset_xs.data(), t, xs.data(), m, weights.data());
+            size_t agreements = 0;
+            for (size_t k = 0; k < m; ++k) {
+                uint64_t predicted = 0;
+                for (size_t j = 0; j < t; ++j) {
+                    predicted = field.add(predicted, field.mul(weights[k * t + j], ys[subset[j]]));
+                }
+                agreements += predicted == ys[k];
+            }
+            if (agreements + max_errors >= m) {
+                for (size_t j = 0; j < t; ++j) subset_ys[j] = ys[subset[j]];
+                secrets.push_back(field_ops::interpolateAtZero(field, subset_xs.data(), subset_ys.data(), t));
+                break;
+            }
+        } while (nextSubset(subset, m));
+    }
+    return secrets;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t iterations = argc > 1 ? std::stoul(argv[1]) : 200;
+    std::mt19937_64 rng(40);
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Robust reconstruction, 34 chunks, ms per key" << std::endl;
+    std::cout << std::left << std::setw(10) << "t-of-m" << std::setw(8) << "wrong" << std::right
+              << std::setw(12) << "plain" << std::setw(12) << "RS batch" << std::setw(16) << "subset retry"
+              << std::setw(12) << "speedup" << std::endl;
+
+    for (auto [t, m] : std::vector<std::pair<size_t, size_t>>{{3, 5}, {3, 9}, {6, 16}}) {
+        ShamirSecretSharing sss(t, m, PRIME);
+        size_t max_errors = (m - t) / 2;
+        for (size_t errors : {size_t{0}, max_errors}) {
+            std::vector<uint64_t> secrets(NUM_CHUNKS);
+            std::vector<std::vector<Share>> chunk_shares;
+            for (auto& secret : secrets) {
+                secret = rng() % PRIME;
+                chunk_shares.push_back(sss.split(secret));
+            }
+            // Worst case for both: the first shares are the wrong ones
+            for (auto& shares : chunk_shares) {
+                for (size_t i = 0; i < errors; ++i) shares[i].value = (shares[i].value + 1) % PRIME;
+            }
+
+            if (sss.reconstructRobust(chunk_shares) != secrets || subsetRetry(chunk_shares, t) != secrets) {
+                std::cerr << "✗ Decoders disagree at " << t << "-of-" << m << std::endl;
+                return 1;
+            }
+
+            double plain_ms = msPer(iterations, [&] {
+                for (const auto& shares : chunk_shares) sss.reconstruct(shares);
+            });
+            double robust_ms = msPer(iterations, [&] { sss.reconstructRobust(chunk_shares); });
+            // Subset retry tries thousands of subsets per chunk at 6-of-16 with errors
+            size_t retry_iterations = errors ? std::max<size_t>(iterations / 100, 1) : iterations;
+            double retry_ms = msPer(retry_iterations, [&] { subsetRetry(chunk_shares, t); });
+
+            std::cout << std::left << std::setw(10) << (std::to_string(t) + "-of-" + std::to_string(m))
+                      << std::setw(8) << errors << std::right << std::setw(12) << plain_ms
+                      << std::setw(12) << robust_ms << std::setw(16) << retry_ms << std::setw(11)
+                      << retry_ms / robust_ms << "x" << std::endl;
+        }
+    }
+    std::cout << "(plain = reconstruct from the first t shares, no error handling)" << std::endl;
+    return 0;
+}
@@ -0,0 +1,618 @@
+/**
+ * TLS Handshake Load Test
+ *
+ * Multi-threaded, epoll-driven TLS server plus a client generator that keeps
+ * up to N connections in flight at a target rate. Reports handshakes/sec and
+ * p50/p99/p999 handshake latency (client side, connect() to Finished).
+ *
+ * The same run is repeated with a local private key and with the multiparty
+ * key (threshold RSA across parties 1, 3, 5 through SSL_MODE_ASYNC), so the
+ * threshold overhead can be read off directly.
+ *
+ * Usage:
+ *   bench_tls_handshake [--key local|multiparty|both] [--connections N]
+ *                       [--rate R] [--duration S] [--server-threads T]
+ *                       [--client-threads C] [--offload-threads W] [--port P]
+ *                       [--resume F]
+ *
+ *   --rate 0 runs closed-loop: a new connection starts as soon as one ends.
+ *   --resume F offers the thread's last session on fraction F of the
+ *   connections (0..1). The server keeps one SSL_CTX with its session cache
+ *   and tickets enabled; resumed handshakes skip the private-key operation.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <openssl/err.h>
+#include <openssl/ssl.h>
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "rsa_key_utils.hpp"
+#include "threshold_rsa.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+const size_t THRESHOLD = 3;
+const size_t NUM_PARTIES = 5;
+const size_t ACTIVE_PARTIES[] = {1, 3, 5};
+
+struct Options {
+    std::string key = "both";
+    size_t connections = 64;
+    double rate = 0;                // Handshakes/sec across all client threads, 0 = closed-loop
+    double duration = 5;            // Seconds
+    size_t server_threads = 2;
+    size_t client_threads = 2;
+    size_t offload_threads = 4;
+    int port = 4443;
+    double resume = 0;              // Fraction of connections offering a session
+};
+
+/**
+ * Handshake outcomes collected by one client thread
+ */
+struct ClientResults {
+    uint64_t completed = 0;
+    uint64_t failed = 0;
+    uint64_t resumed = 0;
+    std::vector<double> latencies_us;
+};
+
+bool setNonBlocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+// ============================================================================
+// SERVER
+// ============================================================================
+
+/**
+ * Event-loop TLS server: one epoll loop per thread, each with its own
+ * SO_REUSEPORT listener so the kernel spreads incoming connections.
+ * The connection is closed as soon as the handshake completes.
+ */
+class LoadServer {
+public:
+    LoadServer(SSL_CTX* ctx, int port, size_t threads)
+        : ctx_(ctx), port_(port), num_threads_(threads) {}
+
+    ~LoadServer() { stop(); }
+
+    bool start() {
+        stopping_ = false;
+        for (size_t i = 0; i < num_threads_; ++i) {
+            int fd = listenSocket();
+            if (fd < 0) {
+                stop();
+                return false;
+            }
+            threads_.emplace_back(&LoadServer::run, this, fd);
+        }
+        return true;
+    }
+
+    void stop() {
+        stopping_ = true;
+        for (auto& t : threads_) {
+            t.join();
+        }
+        threads_.clear();
+    }
+
+    uint64_t handshakes() const { return handshakes_.load(); }
+    uint64_t failures() const { return failures_.load(); }
+    uint64_t asyncYields() const { return async_yields_.load(); }
+
+private:
+    struct Connection {
+        int fd;
+        SSL* ssl;
+        int async_fd;       // Registered job wait fd, -1 if none
+    };
+
+    int listenSocket() {
+        int fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (fd < 0) {
+            return -1;
+        }
+        int opt = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+        setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt));
+
+        struct sockaddr_in addr;
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port_);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+        if (bind(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) < 0 ||
+            listen(fd, 1024) < 0 || !setNonBlocking(fd)) {
+            std::cerr << "[ERROR] Failed to listen on port " << port_ << std::endl;
+            close(fd);
+            return -1;
+        }
+        return fd;
+    }
+
+    void run(int listen_fd) {
+        int ep = epoll_create1(0);
+        struct epoll_event ev;
+        ev.events = EPOLLIN;
+        ev.data.ptr = nullptr;      // nullptr marks the listener
+        epoll_ctl(ep, EPOLL_CTL_ADD, listen_fd, &ev);
+
+        std::vector<Connection*> open;
+        std::vector<Connection*> retry;     // SSL_ERROR_WANT_ASYNC_JOB
+        struct epoll_event events[256];
+
+        while (!stopping_) {
+            int n = epoll_wait(ep, events, 256, retry.empty() ? 100 : 0);
+
+            std::vector<Connection*> ready;
+            ready.swap(retry);
+            for (int i = 0; i < n; ++i) {
+                if (events[i].data.ptr == nullptr) {
+                    acceptAll(ep, listen_fd, open, ready);
+                } else {
+                    ready.push_back(static_cast<Connection*>(events[i].data.ptr));
+                }
+            }
+
+            for (Connection* conn : ready) {
+                if (std::find(open.begin(), open.end(), conn) == open.end()) {
+                    continue;   // Closed earlier in this batch
+                }
+                if (!drive(ep, conn, retry)) {
+                    closeConnection(ep, conn);
+                    open.erase(std::find(open.begin(), open.end(), conn));
+                }
+            }
+        }
+
+        for (Connection* conn : open) {
+            closeConnection(ep, conn);
+        }
+        close(listen_fd);
+        close(ep);
+    }
+
+    void acceptAll(int ep, int listen_fd, std::vector<Connection*>& open,
+                   std::vector<Connection*>& ready) {
+        while (true) {
+            int fd = accept4(listen_fd, nullptr, nullptr, SOCK_NONBLOCK);
+            if (fd < 0) {
+                return;
+            }
+            int opt = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &opt, sizeof(opt));
+
+            Connection* conn = new Connection{fd, SSL_new(ctx_), -1};
+            SSL_set_fd(conn->ssl, fd);
+            SSL_set_accept_state(conn->ssl);
+
+            struct epoll_event ev;
+            ev.events = EPOLLIN;
+            ev.data.ptr = conn;
+            epoll_ctl(ep, EPOLL_CTL_ADD, fd, &ev);
+            open.push_back(conn);
+            ready.push_back(conn);
+        }
+    }
+
+    /**
+     * Advance the handshake; returns false once the connection is finished
+     */
+    bool drive(int ep, Connection* conn, std::vector<Connection*>& retry) {
+        if (conn->async_fd >= 0) {
+            epoll_ctl(ep, EPOLL_CTL_DEL, conn->async_fd, nullptr);
+            conn->async_fd = -1;
+        }
+
+        int ret = SSL_do_handshake(conn->ssl);
+        if (ret == 1) {
+            handshakes_.fetch_add(1, std::memory_order_relaxed);
+            SSL_shutdown(conn->ssl);
+            return false;
+        }
+
+        struct epoll_event ev;
+        ev.data.ptr = conn;
+        switch (SSL_get_error(conn->ssl, ret)) {
+            case SSL_ERROR_WANT_READ:
+                ev.events = EPOLLIN;
+                epoll_ctl(ep, EPOLL_CTL_MOD, conn->fd, &ev);
+                return true;
+            case SSL_ERROR_WANT_WRITE:
+                ev.events = EPOLLOUT;
+                epoll_ctl(ep, EPOLL_CTL_MOD, conn->fd, &ev);
+                return true;
+            case SSL_ERROR_WANT_ASYNC: {
+                async_yields_.fetch_add(1, std::memory_order_relaxed);
+                OSSL_ASYNC_FD fd;
+                size_t num_fds = 1;
+                if (SSL_get_all_async_fds(conn->ssl, &fd, &num_fds) != 1 || num_fds != 1) {
+                    break;
+                }
+                ev.events = EPOLLIN;
+                epoll_ctl(ep, EPOLL_CTL_ADD, fd, &ev);
+                conn->async_fd = fd;
+                return true;
+            }
+            case SSL_ERROR_WANT_ASYNC_JOB:
+                retry.push_back(conn);
+                return true;
+            default:
+                break;
+        }
+
+        failures_.fetch_add(1, std::memory_order_relaxed);
+        ERR_clear_error();
+        return false;
+    }
+
+    void closeConnection(int ep, Connection* conn) {
+        if (conn->async_fd >= 0) {
+            epoll_ctl(ep, EPOLL_CTL_DEL, conn->async_fd, nullptr);
+        }
+        epoll_ctl(ep, EPOLL_CTL_DEL, conn->fd, nullptr);
+        SSL_free(conn->ssl);
+        close(conn->fd);
+        delete conn;
+    }
+
+    SSL_CTX* ctx_;
+    int port_;
+    size_t num_threads_;
+    std::vector<std::thread> threads_;
+    std::atomic<bool> stopping_{false};
+    std::atomic<uint64_t> handshakes_{0};
+    std::atomic<uint64_t> failures_{0};
+    std::atomic<uint64_t> async_yields_{0};
+};
+
+// ============================================================================
+// CLIENT GENERATOR
+// ============================================================================
+
+struct ClientConnection {
+    int fd;
+    SSL* ssl;
+    Clock::time_point started;
+};
+
+/**
+ * One generator thread: opens connections at rate (0 = as fast as the
+ * in-flight limit allows) until the deadline, then drains what is open
+ */
+void clientThread(SSL_CTX* ctx, int port, double rate, size_t max_in_flight, double resume,
+                  Clock::time_point deadline, ClientResults& results) {
+    int ep = epoll_create1(0);
+    struct sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    auto interval = rate > 0 ? std::chrono::duration_cast<Clock::duration>(
+                                   std::chrono::duration<double>(1.0 / rate))
+                             : Clock::duration::zero();
+    Clock::time_point next_start = Clock::now();
+    size_t in_flight = 0;
+    double resume_credit = 0;
+    SSL_SESSION* session = nullptr;     // Most recent session, offered for resumption
+    struct epoll_event events[256];
+
+    auto finish = [&](ClientConnection* conn, bool ok) {
+        if (ok) {
+            ++results.completed;
+            if (SSL_session_reused(conn->ssl)) {
+                ++results.resumed;
+            }
+            SSL_SESSION_free(session);
+            session = SSL_get1_session(conn->ssl);
+            results.latencies_us.push_back(
+                std::chrono::duration<double, std::micro>(Clock::now() - conn->started).count());
+            SSL_shutdown(conn->ssl);
+        } else {
+            ++results.failed;
+            ERR_clear_error();
+        }
+        epoll_ctl(ep, EPOLL_CTL_DEL, conn->fd, nullptr);
+        SSL_free(conn->ssl);
+        close(conn->fd);
+        delete conn;
+        --in_flight;
+    };
+
+    auto drive = [&](ClientConnection* conn) {
+        int ret = SSL_do_handshake(conn->ssl);
+        if (ret == 1) {
+            finish(conn, true);
+            return;
+        }
+        struct epoll_event ev;
+        ev.data.ptr = conn;
+        switch (SSL_get_error(conn->ssl, ret)) {
+            case SSL_ERROR_WANT_READ:
+                ev.events = EPOLLIN;
+                epoll_ctl(ep, EPOLL_CTL_MOD, conn->fd, &ev);
+                break;
+            case SSL_ERROR_WANT_WRITE:
+                ev.events = EPOLLOUT;
+                epoll_ctl(ep, EPOLL_CTL_MOD, conn->fd, &ev);
+                break;
+            default:
+                finish(conn, false);
+                break;
+        }
+    };
+
+    while (true) {
+        Clock::time_point now = Clock::now();
+        bool generating = now < deadline;
+        if (!generating && in_flight == 0) {
+            break;
+        }
+
+        // Start as many connections as the schedule and in-flight cap allow
+        while (generating && in_flight < max_in_flight && now >= next_start) {
+            int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+            int opt = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &opt, sizeof(opt));
+            auto* conn = new ClientConnection{fd, SSL_new(ctx), Clock::now()};
+            SSL_set_fd(conn->ssl, fd);
+            SSL_set_connect_state(conn->ssl);
+            resume_credit += resume;
+            if (session && resume_credit >= 1) {
+                SSL_set_session(conn->ssl, session);
+                resume_credit -= 1;
+            }
+
+            struct epoll_event ev;
+            ev.events = EPOLLOUT;
+            ev.data.ptr = conn;
+            epoll_ctl(ep, EPOLL_CTL_ADD, fd, &ev);
+            ++in_flight;
+
+            if (connect(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) < 0 &&
+                errno != EINPROGRESS) {
+                finish(conn, false);
+            }
+
+            next_start = rate > 0 ? next_start + interval : now;
+        }
+
+        int timeout_ms = 10;
+        if (generating && rate > 0 && in_flight < max_in_flight) {
+            auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(next_start - now).count();
+            timeout_ms = static_cast<int>(std::max<long long>(0, std::min<long long>(wait, 10)));
+        }
+
+        int n = epoll_wait(ep, events, 256, timeout_ms);
+        for (int i = 0; i < n; ++i) {
+            drive(static_cast<ClientConnection*>(events[i].data.ptr));
+        }
+    }
+
+    SSL_SESSION_free(session);
+    close(ep);
+}
+
+double percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) {
+        return 0;
+    }
+    size_t rank = static_cast<size_t>(std::ceil(p * sorted.size()));
+    return sorted[std::min(sorted.size(), std::max<size_t>(rank, 1)) - 1];
+}
+
+// ============================================================================
+// RUNS
+// ============================================================================
+
+SSL_CTX* serverContext(X509* cert, EVP_PKEY* key, bool async) {
+    SSL_CTX* ctx = SSL_CTX_new(TLS_server_method());
+    if (!ctx) {
+        return nullptr;
+    }
+    SSL_CTX_set_min_proto_version(ctx, TLS1_2_VERSION);
+    SSL_CTX_set_max_proto_version(ctx, TLS1_2_VERSION);
+    if (SSL_CTX_use_certificate(ctx, cert) <= 0 || SSL_CTX_use_PrivateKey(ctx, key) <= 0) {
+        ERR_print_errors_fp(stderr);
+        SSL_CTX_free(ctx);
+        return nullptr;
+    }
+    if (async) {
+        SSL_CTX_set_mode(ctx, SSL_MODE_ASYNC);
+    }
+
+    // Shared by all server threads: one session cache, one ticket key
+    static const unsigned char session_id_context[] = "bench_tls_handshake";
+    SSL_CTX_set_session_id_context(ctx, session_id_context, sizeof(session_id_context) - 1);
+    SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_SERVER);
+    SSL_CTX_sess_set_cache_size(ctx, 20480);
+    SSL_CTX_clear_options(ctx, SSL_OP_NO_TICKET);
+    return ctx;
+}
+
+/**
+ * Run the generator against a server using key; prints one result block
+ */
+bool runLoad(const std::string& label, const Options& opts, X509* cert, EVP_PKEY* key, bool async,
+             const threshold_rsa::ThresholdRSAKey* combiner) {
+    SSL_CTX* server_ctx = serverContext(cert, key, async);
+    SSL_CTX* client_ctx = SSL_CTX_new(TLS_client_method());
+    if (!server_ctx || !client_ctx) {
+        SSL_CTX_free(server_ctx);
+        SSL_CTX_free(client_ctx);
+        return false;
+    }
+    SSL_CTX_set_min_proto_version(client_ctx, TLS1_2_VERSION);
+    SSL_CTX_set_max_proto_version(client_ctx, TLS1_2_VERSION);
+    SSL_CTX_set_verify(client_ctx, SSL_VERIFY_NONE, nullptr);
+    SSL_CTX_set_session_cache_mode(client_ctx, SSL_SESS_CACHE_CLIENT);
+
+    LoadServer server(server_ctx, opts.port, opts.server_threads);
+    if (!server.start()) {
+        SSL_CTX_free(server_ctx);
+        SSL_CTX_free(client_ctx);
+        return false;
+    }
+
+    std::vector<ClientResults> results(opts.client_threads);
+    std::vector<std::thread> clients;
+    auto start = Clock::now();
+    auto deadline = start + std::chrono::duration_cast<Clock::duration>(
+                                std::chrono::duration<double>(opts.duration));
+    size_t per_thread = std::max<size_t>(1, opts.connections / opts.client_threads);
+    double rate_per_thread = opts.rate / opts.client_threads;
+    for (size_t i = 0; i < opts.client_threads; ++i) {
+        clients.emplace_back(clientThread, client_ctx, opts.port, rate_per_thread, per_thread,
+                             opts.resume, deadline, std::ref(results[i]));
+    }
+    for (auto& t : clients) {
+        t.join();
+    }
+    double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    server.stop();
+
+    ClientResults total;
+    for (auto& r : results) {
+        total.completed += r.completed;
+        total.failed += r.failed;
+        total.resumed += r.resumed;
+        total.latencies_us.insert(total.latencies_us.end(), r.latencies_us.begin(), r.latencies_us.end());
+    }
+    std::sort(total.latencies_us.begin(), total.latencies_us.end());
+
+    std::cout << "\n=== " << label << " ===" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "Handshakes:      " << total.completed << " ok, " << total.failed << " failed"
+              << " (server: " << server.handshakes() << " ok, " << server.failures() << " failed)" << std::endl;
+    std::cout << "Rate:            " << total.completed / elapsed << " handshakes/sec" << std::endl;
+    std::cout << "Resumed:         " << total.resumed << " of " << total.completed << " ("
+              << (total.completed ? 100.0 * total.resumed / total.completed : 0.0) << "%), full: "
+              << total.completed - total.resumed << std::endl;
+    std::cout << "Latency (ms):    p50 " << percentile(total.latencies_us, 0.50) / 1000.0
+              << "  p99 " << percentile(total.latencies_us, 0.99) / 1000.0
+              << "  p999 " << percentile(total.latencies_us, 0.999) / 1000.0 << std::endl;
+    if (combiner) {
+        auto stats = combiner->stats();
+        std::cout << "Threshold ops:   " << stats.operations << " (failures: " << stats.failures
+                  << ", offloaded: " << stats.offloaded << ", WANT_ASYNC yields: "
+                  << server.asyncYields() << ")" << std::endl;
+        if (stats.operations > 0) {
+            std::cout << "Op latency (ms): mean " << stats.total_ns / stats.operations / 1e6
+                      << "  max " << stats.max_ns / 1e6 << std::endl;
+        }
+    }
+
+    SSL_CTX_free(server_ctx);
+    SSL_CTX_free(client_ctx);
+    return total.completed > 0 && total.failed == 0;
+}
+
+void printUsage(const char* program_name) {
+    std::cout << "Usage: " << program_name
+              << " [--key local|multiparty|both] [--connections N] [--rate R] [--duration S]\n"
+              << "       [--server-threads T] [--client-threads C] [--offload-threads W] [--port P]\n"
+              << "       [--resume F]" << std::endl;
+}
+
+bool parseOptions(int argc, char* argv[], Options& opts) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            return false;
+        }
+        std::string value = argv[++i];
+        try {
+            if (arg == "--key") opts.key = value;
+            else if (arg == "--connections") opts.connections = std::stoul(value);
+            else if (arg == "--rate") opts.rate = std::stod(value);
+            else if (arg == "--duration") opts.duration = std::stod(value);
+            else if (arg == "--server-threads") opts.server_threads = std::stoul(value);
+            else if (arg == "--client-threads") opts.client_threads = std::stoul(value);
+            else if (arg == "--offload-threads") opts.offload_threads = std::stoul(value);
+            else if (arg == "--port") opts.port = std::stoi(value);
+            else if (arg == "--resume") opts.resume = std::stod(value);
+            else return false;
+        } catch (const std::logic_error&) {
+            // std::invalid_argument or std::out_of_range from the conversion
+            std::cerr << "[ERROR] Invalid value for " << arg << ": " << value << std::endl;
+            return false;
+        }
+    }
+    return (opts.key == "local" || opts.key == "multiparty" || opts.key == "both") &&
+           opts.connections > 0 && opts.server_threads > 0 && opts.client_threads > 0 &&
+           opts.resume >= 0 && opts.resume <= 1;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options opts;
+    if (!parseOptions(argc, argv, opts)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    std::cout << "TLS 1.2 handshake load test: " << opts.connections << " connections in flight, "
+              << (opts.rate > 0 ? std::to_string(static_cast<long>(opts.rate)) + "/s target" : "closed-loop")
+              << ", " << opts.duration << " s, " << opts.server_threads << " server / "
+              << opts.client_threads << " client threads, resume " << opts.resume * 100 << "%" << std::endl;
+
+    EVP_PKEY* pkey = rsa_key_utils::generateKey(2048);
+    X509* cert = pkey ? rsa_key_utils::selfSignedCertificate(pkey, "localhost") : nullptr;
+    if (!cert) {
+        std::cerr << "[ERROR] Failed to create key and certificate" << std::endl;
+        EVP_PKEY_free(pkey);
+        return 1;
+    }
+
+    bool ok = true;
+    if (opts.key != "multiparty") {
+        ok = runLoad("Local key", opts, cert, pkey, false, nullptr) && ok;
+    }
+
+    if (opts.key != "local") {
+        auto key_shares = threshold_rsa::dealExponentShares(pkey, THRESHOLD, NUM_PARTIES);
+        std::vector<std::unique_ptr<threshold_rsa::PartyBackend>> parties;
+        for (size_t id : ACTIVE_PARTIES) {
+            parties.push_back(std::make_unique<threshold_rsa::LocalParty>(key_shares.at(id - 1)));
+        }
+        threshold_rsa::ThresholdRSAKey combiner(pkey, THRESHOLD, NUM_PARTIES, std::move(parties));
+        combiner.startOffload(opts.offload_threads);
+        EVP_PKEY* threshold_key = combiner.makeEvpPkey();
+
+        ok = threshold_key &&
+             runLoad("Multiparty key (3-of-5 threshold RSA, parties 1, 3, 5)", opts, cert,
+                     threshold_key, true, &combiner) && ok;
+        EVP_PKEY_free(threshold_key);
+    }
+
+    X509_free(cert);
+    EVP_PKEY_free(pkey);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,84 @@
+/**
+ * Pedersen VSS cost: dealing, one-by-one share checks, per-party batched
+ * checks and the all-party batch used by reconstruct --vss. Exits 1 if the
+ * all-party batch is not faster than checking every share on its own.
+ *
+ * Usage: bench_vss [iterations]
+ */
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "vss.hpp"
+
+namespace {
+
+const uint64_t PRIME = 2305843009213693951ULL;  // 2^61 - 1
+
+template <class Fn>
+double msPer(size_t iterations, Fn fn) {
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        fn();
+    }
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / iterations;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t iterations = argc > 1 ? std::stoul(argv[1]) : 20;
+    std::mt19937_64 rng(3);
+    bool regressions = false;
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Pedersen VSS, 3-of-5, ms per operation" << std::endl;
+    std::cout << std::left << std::setw(12) << "d bits" << std::right << std::setw(10) << "deal"
+              << std::setw(14) << "one-by-one" << std::setw(14) << "per-party" << std::setw(14) << "all-party"
+              << std::setw(10) << "speedup" << std::endl;
+
+    for (size_t bits : {2048, 3072, 4096}) {
+        size_t num_chunks = (bits + 60) / 61;
+        std::vector<uint64_t> chunks(num_chunks);
+        for (auto& chunk : chunks) chunk = rng() % PRIME;
+        ShamirSecretSharing sss(3, 5, PRIME);
+
+        vss::Dealing dealing;
+        double deal_ms = msPer(iterations, [&] { dealing = vss::deal(sss, chunks); });
+
+        std::vector<vss::PartyShares> parties;
+        for (size_t i = 0; i < 5; ++i) {
+            parties.push_back({i + 1, &dealing.shares[i], &dealing.blinding[i].values});
+        }
+
+        double single_ms = msPer(iterations, [&] {
+            for (size_t i = 0; i < 5; ++i) {
+                for (size_t c = 0; c < num_chunks; ++c) {
+                    vss::verifyShare(dealing.commitments, c, {i + 1, dealing.shares[i].values[c]},
+                                     dealing.blinding[i].values[c]);
+                }
+            }
+        });
+        double party_ms = msPer(iterations, [&] {
+            for (const auto& party : parties) {
+                vss::verify(dealing.commitments, party);
+            }
+        });
+        double all_ms = msPer(iterations, [&] { vss::findInvalidParties(dealing.commitments, parties); });
+
+        std::cout << std::left << std::setw(12) << bits << std::right << std::setw(10) << deal_ms
+                  << std::setw(14) << single_ms << std::setw(14) << party_ms << std::setw(14) << all_ms
+                  << std::setw(9) << single_ms / all_ms << "x" << std::endl;
+        if (all_ms >= single_ms) {
+            // The batch exists to beat one-by-one checks; say so if it stops doing that
+            std::cout << "[WARNING] All-party batch is not faster than one-by-one checks at "
+                      << bits << " bits" << std::endl;
+            regressions = true;
+        }
+    }
+    return regressions ? 1 : 0;
+}
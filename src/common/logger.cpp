@@ -0,0 +1,210 @@
+#include "logger.hpp"
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+namespace mplog {
+
+namespace {
+
+const char* levelName(Level level) {
+    switch (level) {
+        case Level::Trace: return "TRACE";
+        case Level::Debug: return "DEBUG";
+        case Level::Info:  return "INFO ";
+        case Level::Warn:  return "WARN ";
+        case Level::Error: return "ERROR";
+        default:           return "?????";
+    }
+}
+
+/**
+ * Fixed-capacity ring of formatted records drained by one writer thread.
+ * Producers never block on I/O: when the ring is full the record is dropped
+ * and counted, so logging can never stall a handshake.
+ */
+class Logger {
+public:
+    static constexpr size_t CAPACITY = 1024;
+
+    struct Slot {
+        Level level;
+        const char* component;
+        size_t length;
+        char text[Record::MAX_LENGTH];
+    };
+
+    ~Logger() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        ready_.notify_all();
+        if (writer_.joinable()) {
+            writer_.join();
+        }
+        drainLocked();
+    }
+
+    void submit(Level level, const char* component, const char* text, size_t length) {
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        if (!async_) {
+            writeRecord(level, component, text, length);
+            fflush(sink_);
+            return;
+        }
+
+        if (count_ == CAPACITY) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        Slot& slot = ring_[(head_ + count_) % CAPACITY];
+        slot.level = level;
+        slot.component = component;
+        slot.length = length;
+        std::memcpy(slot.text, text, length);
+        ++count_;
+
+        if (!writer_.joinable()) {
+            writer_ = std::thread(&Logger::run, this);
+        }
+        lock.unlock();
+        ready_.notify_one();
+    }
+
+    void flush() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (!writer_.joinable()) {
+            drainLocked();
+            return;
+        }
+        drained_.wait(lock, [this] { return count_ == 0 && !writing_; });
+    }
+
+    void setSink(FILE* sink) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        sink_ = sink ? sink : stderr;
+    }
+
+    void setAsync(bool async) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        async_ = async;
+    }
+
+    std::atomic<int> level{static_cast<int>(Level::Warn)};
+    std::atomic<size_t> dropped_{0};
+
+private:
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            ready_.wait(lock, [this] { return count_ > 0 || stopping_; });
+            if (count_ == 0 && stopping_) {
+                break;
+            }
+
+            size_t n = 0;
+            while (count_ > 0 && n < batch_.size()) {
+                batch_[n++] = ring_[head_];
+                head_ = (head_ + 1) % CAPACITY;
+                --count_;
+            }
+            writing_ = true;
+            FILE* sink = sink_;
+            lock.unlock();
+
+            for (size_t i = 0; i < n; ++i) {
+                writeRecord(batch_[i].level, batch_[i].component, batch_[i].text, batch_[i].length, sink);
+            }
+            fflush(sink);
+
+            lock.lock();
+            writing_ = false;
+            if (count_ == 0) {
+                drained_.notify_all();
+            }
+        }
+    }
+
+    void drainLocked() {
+        while (count_ > 0) {
+            const Slot& slot = ring_[head_];
+            writeRecord(slot.level, slot.component, slot.text, slot.length);
+            head_ = (head_ + 1) % CAPACITY;
+            --count_;
+        }
+        fflush(sink_);
+    }
+
+    void writeRecord(Level lvl, const char* component, const char* text, size_t length) {
+        writeRecord(lvl, component, text, length, sink_);
+    }
+
+    static void writeRecord(Level lvl, const char* component, const char* text,
+                            size_t length, FILE* sink) {
+        fprintf(sink, "[%s] %s: %.*s\n", levelName(lvl), component,
+                static_cast<int>(length), text);
+    }
+
+    std::mutex mutex_;
+    std::condition_variable ready_;
+    std::condition_variable drained_;
+    std::thread writer_;
+    std::array<Slot, CAPACITY> ring_;
+    std::array<Slot, 64> batch_;  // Records copied out so I/O happens unlocked
+    size_t head_ = 0;
+    size_t count_ = 0;
+    bool writing_ = false;
+    bool stopping_ = false;
+    bool async_ = true;
+    FILE* sink_ = stderr;
+};
+
+Logger& logger() {
+    static Logger instance;
+    return instance;
+}
+
+} // namespace
+
+void setLevel(Level level) {
+    logger().level.store(static_cast<int>(level), std::memory_order_relaxed);
+}
+
+Level getLevel() {
+    return static_cast<Level>(logger().level.load(std::memory_order_relaxed));
+}
+
+bool enabled(Level level) {
+    return static_cast<int>(level) >= logger().level.load(std::memory_order_relaxed);
+}
+
+void setSink(FILE* sink) {
+    logger().setSink(sink);
+}
+
+void setAsync(bool async) {
+    logger().setAsync(async);
+}
+
+void flush() {
+    logger().flush();
+}
+
+size_t droppedRecords() {
+    return logger().dropped_.load(std::memory_order_relaxed);
+}
+
+Record::Record(Level level, const char* component)
+    : level_(level), component_(component), buf_(buffer_, sizeof(buffer_)), stream_(&buf_) {}
+
+Record::~Record() {
+    logger().submit(level_, component_, buffer_, buf_.length());
+}
+
+} // namespace mplog
@@ -0,0 +1,119 @@
+#ifndef MULTIPARTY_LOGGER_HPP
+#define MULTIPARTY_LOGGER_HPP
+
+#include <cstddef>
+#include <cstdio>
+#include <ostream>
+#include <streambuf>
+
+/**
+ * Leveled logging for the multi-party TLS library
+ *
+ * Library code logs through the MPLOG_* macros instead of std::cout:
+ *   - Sites below MPLOG_COMPILED_LEVEL are removed at compile time
+ *   - Sites below the runtime level cost one integer compare
+ *   - Records are formatted into a fixed-size buffer (no heap allocation)
+ *     and handed to a ring buffer drained by a background writer thread
+ *
+ * The default runtime level is Warn, so the library is silent unless an
+ * application opts in with mplog::setLevel().
+ */
+
+// Compile-time floor: 0=Trace 1=Debug 2=Info 3=Warn 4=Error 5=Off
+// Trace sites (share values, key material) are stripped unless requested.
+#ifndef MPLOG_COMPILED_LEVEL
+#ifdef NDEBUG
+#define MPLOG_COMPILED_LEVEL 2
+#else
+#define MPLOG_COMPILED_LEVEL 1
+#endif
+#endif
+
+namespace mplog {
+
+enum class Level : int {
+    Trace = 0,
+    Debug = 1,
+    Info = 2,
+    Warn = 3,
+    Error = 4,
+    Off = 5
+};
+
+/**
+ * Whether sites at this level survive compilation
+ */
+constexpr bool compiled(Level level) {
+    return static_cast<int>(level) >= MPLOG_COMPILED_LEVEL;
+}
+
+/**
+ * Runtime level control (default: Warn)
+ */
+void setLevel(Level level);
+Level getLevel();
+bool enabled(Level level);
+
+/**
+ * Output configuration
+ * @param sink Destination stream (default: stderr)
+ * @param async true: ring buffer + writer thread, false: write inline
+ */
+void setSink(FILE* sink);
+void setAsync(bool async);
+
+/**
+ * Block until every queued record has been written
+ */
+void flush();
+
+/**
+ * Number of records discarded because the ring buffer was full
+ */
+size_t droppedRecords();
+
+/**
+ * A single log record; formats into a fixed buffer and submits on destruction
+ */
+class Record {
+public:
+    static constexpr size_t MAX_LENGTH = 240;
+
+    Record(Level level, const char* component);
+    ~Record();
+
+    Record(const Record&) = delete;
+    Record& operator=(const Record&) = delete;
+
+    std::ostream& stream() { return stream_; }
+
+private:
+    // Truncating streambuf over a caller-owned array
+    class FixedBuf : public std::streambuf {
+    public:
+        FixedBuf(char* begin, size_t size) { setp(begin, begin + size); }
+        size_t length() const { return static_cast<size_t>(pptr() - pbase()); }
+    protected:
+        int_type overflow(int_type ch) override { return traits_type::not_eof(ch); }
+    };
+
+    Level level_;
+    const char* component_;
+    char buffer_[MAX_LENGTH];
+    FixedBuf buf_;
+    std::ostream stream_;
+};
+
+} // namespace mplog
+
+#define MPLOG(level, component) \
+    if (!::mplog::compiled(level) || !::mplog::enabled(level)) {} \
+    else ::mplog::Record(level, component).stream()
+
+#define MPLOG_TRACE(component) MPLOG(::mplog::Level::Trace, component)
+#define MPLOG_DEBUG(component) MPLOG(::mplog::Level::Debug, component)
+#define MPLOG_INFO(component)  MPLOG(::mplog::Level::Info, component)
+#define MPLOG_WARN(component)  MPLOG(::mplog::Level::Warn, component)
+#define MPLOG_ERROR(component) MPLOG(::mplog::Level::Error, component)
+
+#endif // MULTIPARTY_LOGGER_HPP
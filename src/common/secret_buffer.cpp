@@ -0,0 +1,65 @@
+#include "secret_buffer.hpp"
+#include "secure_arena.hpp"
+#include <openssl/crypto.h>
+#include <cstring>
+#include <utility>
+
+namespace secure_arena {
+
+SecretBuffer::SecretBuffer(size_t size) : data_(inline_), size_(0) {
+    allocate(size);
+    memset(data_, 0, size_);
+}
+
+SecretBuffer::SecretBuffer(ByteSpan bytes) : data_(inline_), size_(0) {
+    allocate(bytes.size());
+    if (!bytes.empty()) {
+        memcpy(data_, bytes.data(), bytes.size());
+    }
+}
+
+SecretBuffer::SecretBuffer(SecretBuffer&& other) noexcept : data_(inline_), size_(0) {
+    *this = std::move(other);
+}
+
+SecretBuffer& SecretBuffer::operator=(SecretBuffer&& other) noexcept {
+    if (this == &other) {
+        return *this;
+    }
+    clear();
+    if (other.isInline()) {
+        memcpy(inline_, other.inline_, other.size_);
+        size_ = other.size_;
+        other.clear();
+    } else {
+        // Arena block changes hands; nothing to copy or wipe
+        data_ = other.data_;
+        size_ = other.size_;
+        other.data_ = other.inline_;
+        other.size_ = 0;
+    }
+    return *this;
+}
+
+void SecretBuffer::allocate(size_t size) {
+    if (size > INLINE_CAPACITY) {
+        data_ = static_cast<uint8_t*>(defaultArena().allocate(size));
+    }
+    size_ = size;
+}
+
+void SecretBuffer::clear() noexcept {
+    if (isInline()) {
+        OPENSSL_cleanse(inline_, size_);
+    } else {
+        defaultArena().deallocate(data_, size_);   // Wiped by the arena
+        data_ = inline_;
+    }
+    size_ = 0;
+}
+
+bool operator==(ByteSpan a, ByteSpan b) noexcept {
+    return a.size() == b.size() && (a.empty() || CRYPTO_memcmp(a.data(), b.data(), a.size()) == 0);
+}
+
+} // namespace secure_arena
@@ -0,0 +1,104 @@
+#ifndef MULTIPARTY_SECRET_BUFFER_HPP
+#define MULTIPARTY_SECRET_BUFFER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Owning and non-owning byte ranges for key material
+ *
+ * ByteSpan is a read-only view (pointer + length) that APIs take instead of
+ * const std::vector<uint8_t>&, so callers can pass any buffer without a copy.
+ * SecretBuffer owns secret bytes: it is move-only (copies must be explicit),
+ * stores up to INLINE_CAPACITY bytes inside the object - enough for a TLS
+ * random, pre-master secret or master secret - and anything larger in the
+ * secure arena. Its bytes are wiped when it is cleared, moved from or
+ * destroyed.
+ */
+namespace secure_arena {
+
+class ByteSpan {
+public:
+    constexpr ByteSpan() noexcept : data_(nullptr), size_(0) {}
+    constexpr ByteSpan(const uint8_t* data, size_t size) noexcept : data_(data), size_(size) {}
+    template <class Alloc>
+    ByteSpan(const std::vector<uint8_t, Alloc>& bytes) noexcept : data_(bytes.data()), size_(bytes.size()) {}
+
+    constexpr const uint8_t* data() const noexcept { return data_; }
+    constexpr size_t size() const noexcept { return size_; }
+    constexpr bool empty() const noexcept { return size_ == 0; }
+    constexpr const uint8_t* begin() const noexcept { return data_; }
+    constexpr const uint8_t* end() const noexcept { return data_ + size_; }
+    constexpr uint8_t operator[](size_t i) const noexcept { return data_[i]; }
+
+private:
+    const uint8_t* data_;
+    size_t size_;
+};
+
+class SecretBuffer {
+public:
+    static constexpr size_t INLINE_CAPACITY = 48;
+
+    SecretBuffer() noexcept : data_(inline_), size_(0) {}
+
+    /**
+     * size zero bytes
+     */
+    explicit SecretBuffer(size_t size);
+
+    /**
+     * Copy of bytes (the only way to copy into a SecretBuffer)
+     */
+    explicit SecretBuffer(ByteSpan bytes);
+
+    SecretBuffer(SecretBuffer&& other) noexcept;
+    SecretBuffer& operator=(SecretBuffer&& other) noexcept;
+    ~SecretBuffer() { clear(); }
+
+    SecretBuffer(const SecretBuffer&) = delete;
+    SecretBuffer& operator=(const SecretBuffer&) = delete;
+
+    /**
+     * Explicit deep copy
+     */
+    SecretBuffer clone() const { return SecretBuffer(ByteSpan(*this)); }
+
+    /**
+     * Wipe the bytes and release any arena block
+     */
+    void clear() noexcept;
+
+    uint8_t* data() noexcept { return data_; }
+    const uint8_t* data() const noexcept { return data_; }
+    size_t size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+    bool isInline() const noexcept { return data_ == inline_; }
+
+    uint8_t* begin() noexcept { return data_; }
+    uint8_t* end() noexcept { return data_ + size_; }
+    const uint8_t* begin() const noexcept { return data_; }
+    const uint8_t* end() const noexcept { return data_ + size_; }
+    uint8_t& operator[](size_t i) noexcept { return data_[i]; }
+    uint8_t operator[](size_t i) const noexcept { return data_[i]; }
+
+    operator ByteSpan() const noexcept { return ByteSpan(data_, size_); }
+
+private:
+    void allocate(size_t size);
+
+    uint8_t* data_;
+    size_t size_;
+    alignas(16) uint8_t inline_[INLINE_CAPACITY];
+};
+
+/**
+ * Constant-time comparison (the length is not secret)
+ */
+bool operator==(ByteSpan a, ByteSpan b) noexcept;
+inline bool operator!=(ByteSpan a, ByteSpan b) noexcept { return !(a == b); }
+
+} // namespace secure_arena
+
+#endif // MULTIPARTY_SECRET_BUFFER_HPP
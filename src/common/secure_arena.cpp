@@ -0,0 +1,189 @@
+#include "secure_arena.hpp"
+#include "logger.hpp"
+#include <openssl/crypto.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+
+namespace secure_arena {
+
+namespace {
+
+size_t pageSize() {
+    static const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    return page;
+}
+
+size_t roundUp(size_t value, size_t multiple) {
+    return (value + multiple - 1) / multiple * multiple;
+}
+
+} // namespace
+
+Arena::Arena(size_t region_bytes)
+    : region_bytes_(roundUp(region_bytes < MAX_BLOCK ? MAX_BLOCK : region_bytes, pageSize())) {
+}
+
+Arena::~Arena() {
+    for (auto& region : regions_) {
+        unmapRegion(region);
+    }
+    for (auto& region : dedicated_) {
+        unmapRegion(region);
+    }
+}
+
+Arena::Region Arena::mapRegion(size_t bytes) {
+    const size_t page = pageSize();
+    Region region;
+    region.size = roundUp(bytes, page);
+    region.mapped = region.size + 2 * page;
+
+    void* mapping = mmap(nullptr, region.mapped, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mapping == MAP_FAILED) {
+        throw std::bad_alloc();
+    }
+    region.mapping = static_cast<uint8_t*>(mapping);
+    region.data = region.mapping + page;
+    if (mprotect(region.data, region.size, PROT_READ | PROT_WRITE) != 0) {
+        munmap(region.mapping, region.mapped);
+        throw std::bad_alloc();
+    }
+
+    // Locking is best effort: RLIMIT_MEMLOCK may be small, and an unlocked
+    // region is still guarded, non-dumpable and wiped
+    if (mlock(region.data, region.size) != 0) {
+        if (locked_) {
+            MPLOG_WARN("secure-arena") << "mlock failed (" << strerror(errno)
+                                       << "); key material may be swapped to disk";
+        }
+        locked_ = false;
+    }
+#ifdef MADV_DONTDUMP
+    madvise(region.data, region.size, MADV_DONTDUMP);
+#endif
+    return region;
+}
+
+void Arena::unmapRegion(Region& region) noexcept {
+    OPENSSL_cleanse(region.data, region.size);
+    munlock(region.data, region.size);
+    munmap(region.mapping, region.mapped);
+    region.mapping = region.data = nullptr;
+}
+
+size_t Arena::sizeClass(size_t bytes) {
+    size_t index = 0;
+    while ((MIN_BLOCK << index) < bytes) {
+        ++index;
+    }
+    return index;
+}
+
+void* Arena::allocate(size_t bytes) {
+    if (bytes == 0) {
+        bytes = 1;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (bytes > MAX_BLOCK) {
+        // End the block at the trailing guard page so an overrun faults at once
+        dedicated_.reserve(dedicated_.size() + 1);
+        Region region = mapRegion(bytes);
+        dedicated_.push_back(region);
+        size_t rounded = roundUp(bytes, MIN_BLOCK);
+        in_use_ += rounded;
+        return region.data + region.size - rounded;
+    }
+
+    size_t index = sizeClass(bytes);
+    size_t block_size = MIN_BLOCK << index;
+    in_use_ += block_size;
+    if (void* block = free_lists_[index]) {
+        memcpy(&free_lists_[index], block, sizeof(void*));
+        memset(block, 0, sizeof(void*));
+        return block;
+    }
+    if (regions_.empty() || bump_ + block_size > regions_.back().size) {
+        regions_.reserve(regions_.size() + 1);
+        regions_.push_back(mapRegion(region_bytes_));
+        bump_ = 0;
+    }
+    void* block = regions_.back().data + bump_;
+    bump_ += block_size;
+    return block;
+}
+
+void Arena::deallocate(void* block, size_t bytes) noexcept {
+    if (!block) {
+        return;
+    }
+    if (bytes == 0) {
+        bytes = 1;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (bytes > MAX_BLOCK) {
+        uint8_t* p = static_cast<uint8_t*>(block);
+        for (size_t i = 0; i < dedicated_.size(); ++i) {
+            if (p >= dedicated_[i].data && p < dedicated_[i].data + dedicated_[i].size) {
+                in_use_ -= roundUp(bytes, MIN_BLOCK);
+                unmapRegion(dedicated_[i]);
+                dedicated_[i] = dedicated_.back();
+                dedicated_.pop_back();
+                return;
+            }
+        }
+        return;
+    }
+
+    size_t index = sizeClass(bytes);
+    OPENSSL_cleanse(block, MIN_BLOCK << index);
+    memcpy(block, &free_lists_[index], sizeof(void*));
+    free_lists_[index] = block;
+    in_use_ -= MIN_BLOCK << index;
+}
+
+void Arena::reset() noexcept {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Keep the first shared region mapped (and locked) for reuse
+    for (size_t i = 1; i < regions_.size(); ++i) {
+        unmapRegion(regions_[i]);
+    }
+    if (!regions_.empty()) {
+        OPENSSL_cleanse(regions_[0].data, regions_[0].size);
+        regions_.resize(1);
+    }
+    for (auto& region : dedicated_) {
+        unmapRegion(region);
+    }
+    dedicated_.clear();
+    bump_ = 0;
+    for (auto& head : free_lists_) {
+        head = nullptr;
+    }
+    in_use_ = 0;
+}
+
+bool Arena::locked() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return locked_;
+}
+
+size_t Arena::regionCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return regions_.size() + dedicated_.size();
+}
+
+size_t Arena::bytesInUse() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return in_use_;
+}
+
+Arena& defaultArena() {
+    static Arena* arena = new Arena();
+    return *arena;
+}
+
+} // namespace secure_arena
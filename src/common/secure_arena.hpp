@@ -0,0 +1,158 @@
+#ifndef MULTIPARTY_SECURE_ARENA_HPP
+#define MULTIPARTY_SECURE_ARENA_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+/**
+ * Locked, non-dumpable memory for key material
+ *
+ * An Arena hands out blocks from page-aligned regions that are
+ *   - mlock'ed, so secrets never reach swap
+ *   - marked MADV_DONTDUMP, so they are left out of core dumps
+ *   - bracketed by PROT_NONE guard pages, so running off either end faults
+ *
+ * Blocks are recycled through per-size free lists instead of being returned
+ * to the system: a buffer freed in one handshake is reused by the next, so
+ * steady-state loops make no malloc/mmap calls. Every block is wiped when
+ * it is freed and every region is wiped again when the arena goes away.
+ *
+ * Containers use it through ArenaAllocator (SecureBytes, SecureVector).
+ */
+namespace secure_arena {
+
+class Arena {
+public:
+    // Largest size class carved from shared regions; bigger requests get a
+    // region of their own that ends at a guard page
+    static constexpr size_t MAX_BLOCK = 16 * 1024;
+
+    /**
+     * @param region_bytes Usable bytes per shared region (rounded up to pages)
+     */
+    explicit Arena(size_t region_bytes = 64 * 1024);
+    ~Arena();
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    /**
+     * @return A block of at least bytes bytes, 16-byte aligned
+     * @throws std::bad_alloc if a new region cannot be mapped
+     */
+    void* allocate(size_t bytes);
+
+    /**
+     * Wipe a block and return it to its free list
+     * @param bytes The size passed to allocate
+     */
+    void deallocate(void* block, size_t bytes) noexcept;
+
+    /**
+     * Wipe every region and forget all blocks (outstanding pointers become
+     * invalid). For arenas owned by one operation, not defaultArena().
+     */
+    void reset() noexcept;
+
+    /**
+     * Whether every region so far could be mlock'ed (RLIMIT_MEMLOCK)
+     */
+    bool locked() const;
+
+    /**
+     * Regions mapped so far (shared and dedicated)
+     */
+    size_t regionCount() const;
+
+    /**
+     * Bytes currently handed out (after rounding to size classes)
+     */
+    size_t bytesInUse() const;
+
+private:
+    struct Region {
+        uint8_t* mapping;    // Guard page, usable pages, guard page
+        size_t mapped;
+        uint8_t* data;       // First usable byte
+        size_t size;         // Usable bytes
+    };
+
+    static constexpr size_t MIN_BLOCK = 16;
+    static constexpr size_t NUM_CLASSES = 11;   // 16 B .. 16 KiB
+
+    Region mapRegion(size_t bytes);
+    void unmapRegion(Region& region) noexcept;
+    static size_t sizeClass(size_t bytes);
+
+    mutable std::mutex mutex_;
+    size_t region_bytes_;
+    std::vector<Region> regions_;          // Shared, carved by bump allocation
+    std::vector<Region> dedicated_;        // One per block above MAX_BLOCK
+    size_t bump_ = 0;                      // Next free byte in regions_.back()
+    void* free_lists_[NUM_CLASSES] = {};
+    size_t in_use_ = 0;
+    bool locked_ = true;
+};
+
+/**
+ * Process-wide arena behind the default-constructed allocators. Never
+ * destroyed, so containers in static storage stay valid during exit.
+ */
+Arena& defaultArena();
+
+/**
+ * Standard allocator over an Arena
+ */
+template <class T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    ArenaAllocator() noexcept : arena_(&defaultArena()) {}
+    explicit ArenaAllocator(Arena& arena) noexcept : arena_(&arena) {}
+    template <class U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept : arena_(other.arena()) {}
+
+    T* allocate(size_t n) {
+        if (n > std::numeric_limits<size_t>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<T*>(arena_->allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T* block, size_t n) noexcept {
+        arena_->deallocate(block, n * sizeof(T));
+    }
+
+    Arena* arena() const noexcept { return arena_; }
+
+private:
+    Arena* arena_;
+};
+
+template <class T, class U>
+bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) noexcept {
+    return a.arena() == b.arena();
+}
+
+template <class T, class U>
+bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) noexcept {
+    return !(a == b);
+}
+
+template <class T>
+using SecureVector = std::vector<T, ArenaAllocator<T>>;
+
+using SecureBytes = SecureVector<uint8_t>;
+
+} // namespace secure_arena
+
+#endif // MULTIPARTY_SECURE_ARENA_HPP
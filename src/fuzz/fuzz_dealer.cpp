@@ -0,0 +1,403 @@
+/**
+ * Dealer fuzz and property target
+ *
+ * Each input fixes a prime, (t, n), a secret, the polynomial coefficients
+ * (replayed from the input, so a failing input reproduces exactly), which
+ * shares reach the combiner and in what order, and which of them are
+ * corrupted. The properties checked are:
+ *   - every share equals the polynomial evaluated with BIGNUM arithmetic
+ *   - reconstruct, reconstructWithWeights and reconstructChunks return the
+ *     secret from any t or more shares in any order, and lagrangeWeights
+ *     matches a BIGNUM Lagrange computation
+ *   - reconstructRobust corrects up to (m - t) / 2 corrupted shares and
+ *     names exactly the corrupted ids
+ *   - fewer than t shares, repeated ids, secrets >= p and n >= p are rejected
+ * The input space covers the 2^61 - 1 SIMD evaluator, the compiled 3-of-5
+ * table, inline and heap reconstruction, and primes near 2^64.
+ *
+ * Build with -fsanitize=fuzzer -DSSS_LIBFUZZER for a libFuzzer target.
+ * Otherwise a driver runs a fixed pseudo-random corpus and reports
+ * executions per second, the throughput metric to watch for regressions.
+ * The rate is also printed as a CTest measurement (execs_per_sec, shown on
+ * CDash). A run below min_execs_per_sec (default 0, no floor) fails; ctest
+ * applies a floor only in the opt-in timing test fuzz_dealer_throughput:
+ *
+ *   fuzz_dealer [executions [min_execs_per_sec]]
+ *   fuzz_dealer input_file...          (replay inputs, e.g. a crash)
+ */
+
+#include <openssl/bn.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "poly_eval.hpp"
+#include "shamir_secret_sharing.hpp"
+
+namespace {
+
+using Share = ShamirSecretSharing::Share;
+using PartyShares = ShamirSecretSharing::PartyShares;
+
+// Tiny fields, the deployed Mersenne prime, and primes either side of 2^63
+// (the constant-time backend's limit) up to the largest 64-bit prime
+const uint64_t PRIMES[] = {
+    3ULL, 257ULL, 65537ULL, 2147483647ULL,
+    2305843009213693951ULL,    // 2^61 - 1
+    4611686018427387847ULL,    // 2^62 - 57
+    9223372036854775783ULL,    // 2^63 - 25
+    18446744073709551557ULL,   // 2^64 - 59
+};
+
+/**
+ * Sequential reader over the fuzz input; reads past the end return zeros
+ */
+class FuzzInput {
+public:
+    FuzzInput(const uint8_t* data, size_t size) : data_(data), size_(size), pos_(0) {}
+
+    uint64_t take(size_t bytes) {
+        uint64_t value = 0;
+        for (size_t i = 0; i < bytes; ++i) {
+            value = (value << 8) | (pos_ < size_ ? data_[pos_] : 0);
+            ++pos_;
+        }
+        return value;
+    }
+
+    bool exhausted() const { return pos_ >= size_; }
+
+private:
+    const uint8_t* data_;
+    size_t size_;
+    size_t pos_;
+};
+
+/**
+ * Coefficients in [1, p - 1] read from the input, then from a splitmix64
+ * stream seeded by what was read once the input runs out
+ */
+class ReplaySource : public coefficient_source::CoefficientSource {
+public:
+    explicit ReplaySource(FuzzInput& input) : input_(input), state_(0x9e3779b97f4a7c15ULL) {}
+
+    void generate(uint64_t prime, uint64_t* out, size_t count) override {
+        for (size_t i = 0; i < count; ++i) {
+            uint64_t word = input_.exhausted() ? splitmix() : input_.take(8);
+            state_ ^= word;
+            out[i] = 1 + word % (prime - 1);
+        }
+    }
+
+private:
+    FuzzInput& input_;
+    uint64_t state_;
+
+    uint64_t splitmix() {
+        uint64_t z = (state_ += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+};
+
+const uint8_t* g_data = nullptr;
+size_t g_size = 0;
+
+/**
+ * Report a violated property with the input that caused it, then crash so
+ * libFuzzer saves the input
+ */
+void check(bool condition, const char* property) {
+    if (condition) {
+        return;
+    }
+    std::cerr << "✗ " << property << "\n  input (" << g_size << " bytes): ";
+    for (size_t i = 0; i < g_size; ++i) {
+        std::cerr << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(g_data[i]);
+    }
+    std::cerr << std::dec << std::endl;
+    abort();
+}
+
+template <class Fn>
+bool throwsInvalid(Fn fn) {
+    try {
+        fn();
+        return false;
+    } catch (const std::invalid_argument&) {
+        return true;
+    }
+}
+
+/**
+ * Reference arithmetic mod p on BIGNUMs
+ */
+class BnField {
+public:
+    explicit BnField(uint64_t p) : ctx_(BN_CTX_new()), p_(word(p)) {}
+    ~BnField() {
+        BN_free(p_);
+        BN_CTX_free(ctx_);
+    }
+
+    BnField(const BnField&) = delete;
+    BnField& operator=(const BnField&) = delete;
+
+    /**
+     * f(x) for f given by its coefficients
+     */
+    uint64_t evaluate(const std::vector<uint64_t>& coefficients, uint64_t x) {
+        BIGNUM* result = BN_new();
+        BIGNUM* bn_x = word(x);
+        BIGNUM* term = BN_new();
+        BN_zero(result);
+        for (size_t i = coefficients.size(); i-- > 0;) {
+            BN_mod_mul(result, result, bn_x, p_, ctx_);
+            BN_set_word(term, coefficients[i]);
+            BN_mod_add(result, result, term, p_, ctx_);
+        }
+        uint64_t value = BN_get_word(result);
+        BN_free(term);
+        BN_free(bn_x);
+        BN_free(result);
+        return value;
+    }
+
+    /**
+     * L_j(0) = prod_{k != j} x_k / (x_k - x_j)
+     */
+    std::vector<uint64_t> lagrangeWeights(const std::vector<size_t>& ids) {
+        std::vector<uint64_t> weights;
+        BIGNUM* numerator = BN_new();
+        BIGNUM* denominator = BN_new();
+        BIGNUM* xj = BN_new();
+        BIGNUM* xk = BN_new();
+        BIGNUM* diff = BN_new();
+        for (size_t j = 0; j < ids.size(); ++j) {
+            BN_one(numerator);
+            BN_one(denominator);
+            BN_set_word(xj, ids[j]);
+            for (size_t k = 0; k < ids.size(); ++k) {
+                if (k == j) {
+                    continue;
+                }
+                BN_set_word(xk, ids[k]);
+                BN_mod_mul(numerator, numerator, xk, p_, ctx_);
+                BN_mod_sub(diff, xk, xj, p_, ctx_);
+                BN_mod_mul(denominator, denominator, diff, p_, ctx_);
+            }
+            BN_mod_inverse(denominator, denominator, p_, ctx_);
+            BN_mod_mul(numerator, numerator, denominator, p_, ctx_);
+            weights.push_back(BN_get_word(numerator));
+        }
+        BN_free(diff);
+        BN_free(xk);
+        BN_free(xj);
+        BN_free(denominator);
+        BN_free(numerator);
+        return weights;
+    }
+
+    /**
+     * sum weights[j] * values[j]
+     */
+    uint64_t combine(const std::vector<uint64_t>& weights, const std::vector<uint64_t>& values) {
+        BIGNUM* sum = BN_new();
+        BIGNUM* a = BN_new();
+        BIGNUM* b = BN_new();
+        BN_zero(sum);
+        for (size_t j = 0; j < weights.size(); ++j) {
+            BN_set_word(a, weights[j]);
+            BN_set_word(b, values[j]);
+            BN_mod_mul(a, a, b, p_, ctx_);
+            BN_mod_add(sum, sum, a, p_, ctx_);
+        }
+        uint64_t value = BN_get_word(sum);
+        BN_free(b);
+        BN_free(a);
+        BN_free(sum);
+        return value;
+    }
+
+private:
+    BN_CTX* ctx_;
+    BIGNUM* p_;
+
+    static BIGNUM* word(uint64_t value) {
+        BIGNUM* bn = BN_new();
+        BN_set_word(bn, value);
+        return bn;
+    }
+};
+
+void runOne(const uint8_t* data, size_t size) {
+    g_data = data;
+    g_size = size;
+    FuzzInput input(data, size);
+
+    // Configuration: a shape byte of 0xf0 or above forces the deployed 3-of-5
+    uint64_t prime = PRIMES[input.take(1) % (sizeof(PRIMES) / sizeof(PRIMES[0]))];
+    uint64_t shape = input.take(1);
+    size_t t = 2 + shape % 15;
+    size_t n = t + input.take(1) % 9;
+    if (shape >= 0xf0) {
+        prime = poly_eval::MERSENNE_61;
+        t = 3;
+        n = 5;
+    }
+
+    std::unique_ptr<ShamirSecretSharing> sss;
+    try {
+        sss = std::make_unique<ShamirSecretSharing>(t, n, prime, std::make_unique<ReplaySource>(input));
+    } catch (const std::invalid_argument&) {
+        bool field_limit = std::is_same<ShamirSecretSharing::Field, field_ops::ConstantTimeField>::value &&
+                           (prime >> 63) != 0;
+        check(n >= prime || field_limit, "valid parameters rejected");
+        return;
+    }
+    check(n < prime, "share ids 1..n not distinct mod p, yet accepted");
+
+    // Secret: reduced unless the flag asks for an out-of-range value
+    uint64_t raw_secret = input.take(8);
+    if (input.take(1) & 1) {
+        check(raw_secret < prime || throwsInvalid([&] { sss->split(raw_secret); }),
+              "secret >= p accepted");
+    }
+    uint64_t secret = raw_secret % prime;
+
+    std::vector<uint64_t> coefficients;
+    std::vector<Share> shares = sss->split(secret, coefficients);
+    check(shares.size() == n && coefficients.size() == t && coefficients[0] == secret, "split shape");
+
+    BnField reference(prime);
+    for (size_t i = 0; i < n; ++i) {
+        check(shares[i].id == i + 1, "share ids are 1..n");
+        check(shares[i].value == reference.evaluate(coefficients, i + 1), "share differs from BIGNUM evaluation");
+    }
+
+    // m of the n shares, in an input-chosen order
+    std::vector<Share> chosen = shares;
+    for (size_t i = n; i > 1; --i) {
+        std::swap(chosen[i - 1], chosen[input.take(1) % i]);
+    }
+    size_t m = t + input.take(1) % (n - t + 1);
+    chosen.resize(m);
+
+    std::vector<size_t> ids;
+    std::vector<uint64_t> values;
+    for (const auto& share : chosen) {
+        ids.push_back(share.id);
+        values.push_back(share.value);
+    }
+    std::vector<uint64_t> weights = sss->lagrangeWeights(ids);
+    check(weights == reference.lagrangeWeights(ids), "Lagrange weights differ from BIGNUM");
+    check(reference.combine(weights, values) == secret, "BIGNUM interpolation misses the secret");
+    check(sss->reconstruct(chosen) == secret, "reconstruct");
+    check(sss->reconstruct(chosen.data(), t) == secret, "reconstruct from exactly t shares");
+    check(sss->reconstructWithWeights(weights, chosen) == secret, "reconstructWithWeights");
+
+    // Rejections
+    check(throwsInvalid([&] { sss->reconstruct(chosen.data(), t - 1); }), "fewer than t shares accepted");
+    std::vector<Share> repeated(chosen.begin(), chosen.begin() + t);
+    repeated.back().id = repeated.front().id;
+    check(throwsInvalid([&] { sss->reconstruct(repeated); }), "repeated id accepted");
+
+    // Per-party arrays over a few chunks derived from the secret
+    {
+        std::vector<uint64_t> chunks{secret, (secret + 1) % prime, prime - 1};
+        std::vector<PartyShares> parties = sss->splitChunks(chunks.data(), chunks.size());
+        std::vector<const PartyShares*> present;
+        for (size_t id : ids) {
+            present.push_back(&parties[id - 1]);
+        }
+        std::vector<uint64_t> out(chunks.size());
+        sss->reconstructChunks(present, out.data());
+        check(out == chunks, "reconstructChunks");
+    }
+
+    // Corrupt up to (m - t) / 2 shares and decode all m
+    size_t max_errors = (m - t) / 2;
+    size_t errors = max_errors ? input.take(1) % (max_errors + 1) : 0;
+    std::vector<size_t> corrupted;
+    std::vector<Share> received = chosen;
+    for (size_t e = 0; e < errors; ++e) {
+        received[e].value = (received[e].value + 1 + input.take(8) % (prime - 1)) % prime;
+        corrupted.push_back(received[e].id);
+    }
+    std::sort(corrupted.begin(), corrupted.end());
+    std::vector<size_t> bad_ids;
+    check(sss->reconstructRobust(received, &bad_ids) == secret, "reconstructRobust");
+    check(bad_ids == corrupted, "reconstructRobust blamed the wrong shares");
+}
+
+} // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    runOne(data, size);
+    return 0;
+}
+
+#ifndef SSS_LIBFUZZER
+
+int main(int argc, char* argv[]) {
+    // Replay mode
+    if (argc > 1 && !isdigit(static_cast<unsigned char>(argv[1][0]))) {
+        for (int i = 1; i < argc; ++i) {
+            std::ifstream in(argv[i], std::ios::binary);
+            if (!in) {
+                std::cerr << "[ERROR] Cannot read " << argv[i] << std::endl;
+                return 1;
+            }
+            std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+            runOne(bytes.data(), bytes.size());
+            std::cout << "  ✓ " << argv[i] << std::endl;
+        }
+        std::cout << "Test passed!" << std::endl;
+        return 0;
+    }
+
+    size_t executions = argc > 1 ? std::stoul(argv[1]) : 5000;
+    double min_rate = argc > 2 ? std::stod(argv[2]) : 0;
+    std::cout << "Fuzzing the dealer with " << executions << " generated inputs" << std::endl;
+
+    // Fixed seed: the same corpus every run, so rates are comparable
+    std::mt19937_64 rng(49);
+    std::vector<uint8_t> bytes;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < executions; ++i) {
+        bytes.resize(16 + rng() % 241);
+        for (auto& byte : bytes) {
+            byte = static_cast<uint8_t>(rng());
+        }
+        runOne(bytes.data(), bytes.size());
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double rate = executions / seconds;
+
+    std::cout << std::fixed << std::setprecision(0);
+    std::cout << "  ✓ " << executions << " executions in " << std::setprecision(2) << seconds << " s"
+              << std::setprecision(0) << " (" << rate << " execs/s)" << std::endl;
+    std::cout << "<CTestMeasurement type=\"numeric/double\" name=\"execs_per_sec\">" << rate
+              << "</CTestMeasurement>" << std::endl;
+    if (rate < min_rate) {
+        std::cerr << "✗ Throughput regression: " << rate << " execs/s, expected at least " << min_rate << std::endl;
+        return 1;
+    }
+    std::cout << "Test passed!" << std::endl;
+    return 0;
+}
+
+#endif // SSS_LIBFUZZER
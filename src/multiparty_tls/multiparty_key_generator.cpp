@@ -2,10 +2,10 @@
  * Multi-Party TLS Key Generator for Rsyslog
  * 
  * Purpose: Generate RSA private key using threshold cryptography for secure syslog
- * Usage: ./multiparty_key_generator <output_key_file> <num_parties> <threshold>
+ * Usage: ./multiparty_key_generator <output_key_file> <num_parties> <threshold> [rsa_bits]
  * 
  * Flow:
- * 1. Generate RSA-2048 key pair
+ * 1. Generate RSA key pair (2048 bits unless given; 4096 and 8192 supported)
  * 2. Split private key using Shamir's Secret Sharing (t-of-n)
  * 3. Distribute shares to parties
  * 4. Reconstruct key from threshold parties
@@ -13,7 +13,9 @@
  */
 
 #include "shamir_secret_sharing.hpp"
-#include <openssl/rsa.h>
+#include "rsa_key_utils.hpp"
+#include "secure_arena.hpp"
+#include <openssl/core_names.h>
 #include <openssl/pem.h>
 #include <openssl/err.h>
 #include <openssl/bn.h>
@@ -26,45 +28,36 @@
 
 class MultiPartyKeyGenerator {
 private:
-    static constexpr size_t RSA_BITS = 2048;
     static constexpr size_t CHUNK_BITS = 61;
     static constexpr uint64_t PRIME = 2305843009213693951ULL;  // 2^61 - 1
     
-    RSA* rsa;
+    EVP_PKEY* pkey;
     size_t num_parties;
     size_t threshold;
+    size_t rsa_bits;
     ShamirSecretSharing* sss;
     
-    struct PartyShares {
-        size_t party_id;
-        std::vector<ShamirSecretSharing::Share> shares;
-    };
-    
-    std::vector<PartyShares> all_party_shares;
+    // Per party: its id once and one value per chunk (135 for an 8192-bit key)
+    std::vector<ShamirSecretSharing::PartyShares> all_party_shares;
     
 public:
-    MultiPartyKeyGenerator(size_t n, size_t t) 
-        : rsa(nullptr), num_parties(n), threshold(t), sss(nullptr) {
+    MultiPartyKeyGenerator(size_t n, size_t t, size_t bits = 2048) 
+        : pkey(nullptr), num_parties(n), threshold(t), rsa_bits(bits), sss(nullptr) {
         sss = new ShamirSecretSharing(t, n, PRIME);
     }
     
     ~MultiPartyKeyGenerator() {
-        if (rsa) RSA_free(rsa);
+        if (pkey) EVP_PKEY_free(pkey);
         if (sss) delete sss;
     }
     
     // Step 1: Generate RSA key pair
     bool generateRSAKey() {
-        std::cout << "[1/4] Generating RSA-" << RSA_BITS << " key pair..." << std::endl;
-        
-        rsa = RSA_new();
-        BIGNUM* e = BN_new();
-        BN_set_word(e, RSA_F4);
+        std::cout << "[1/4] Generating RSA-" << rsa_bits << " key pair..." << std::endl;
         
-        int result = RSA_generate_key_ex(rsa, RSA_BITS, e, nullptr);
-        BN_free(e);
+        pkey = rsa_key_utils::generateKey(rsa_bits);
         
-        if (result != 1) {
+        if (!pkey) {
             std::cerr << "ERROR: RSA key generation failed" << std::endl;
             return false;
         }
@@ -78,8 +71,7 @@ public:
         std::cout << "[2/4] Splitting private key using (" << threshold 
                   << "," << num_parties << ")-threshold SSS..." << std::endl;
         
-        const BIGNUM *n, *e, *d;
-        RSA_get0_key(rsa, &n, &e, &d);
+        BIGNUM* d = rsa_key_utils::getParam(pkey, OSSL_PKEY_PARAM_RSA_D);
         
         if (!d) {
             std::cerr << "ERROR: Cannot access private exponent" << std::endl;
@@ -93,33 +85,20 @@ public:
         std::cout << "      Private key: " << d_bits << " bits" << std::endl;
         std::cout << "      Chunks: " << num_chunks << " × " << CHUNK_BITS << " bits" << std::endl;
         
-        // Initialize party shares
-        all_party_shares.clear();
-        for (size_t p = 0; p < num_parties; ++p) {
-            PartyShares ps;
-            ps.party_id = p + 1;
-            all_party_shares.push_back(ps);
-        }
-        
-        // Split each chunk independently
+        // Extract chunks
+        secure_arena::SecureVector<uint64_t> chunks(num_chunks);
         BIGNUM* chunk_bn = BN_new();
         for (size_t chunk_id = 0; chunk_id < num_chunks; ++chunk_id) {
-            // Extract chunk
             BN_copy(chunk_bn, d);
             BN_rshift(chunk_bn, chunk_bn, chunk_id * CHUNK_BITS);
             BN_mask_bits(chunk_bn, CHUNK_BITS);
-            
-            uint64_t chunk_value = BN_get_word(chunk_bn);
-            
-            // Split chunk using SSS
-            auto shares = sss->split(chunk_value);
-            
-            // Distribute to parties
-            for (size_t p = 0; p < num_parties; ++p) {
-                all_party_shares[p].shares.push_back(shares[p]);
-            }
+            chunks[chunk_id] = BN_get_word(chunk_bn);
         }
-        BN_free(chunk_bn);
+        BN_clear_free(chunk_bn);
+        BN_clear_free(d);
+        
+        // Split every chunk straight into the parties' arrays
+        all_party_shares = sss->splitChunks(chunks.data(), chunks.size());
         
         std::cout << "      ✓ Private key split into " << num_chunks * num_parties 
                   << " shares (" << num_chunks << " chunks × " << num_parties << " parties)" << std::endl;
@@ -137,24 +116,28 @@ public:
             return nullptr;
         }
         
-        // Get number of chunks
-        size_t num_chunks = all_party_shares[0].shares.size();
+        // Gather participating parties
+        std::vector<const ShamirSecretSharing::PartyShares*> parties;
+        for (size_t party_id : party_ids) {
+            if (party_id > 0 && party_id <= num_parties) {
+                parties.push_back(&all_party_shares[party_id - 1]);
+            }
+        }
+        
+        // Reconstruct all chunks at once (weights computed once)
+        size_t num_chunks = all_party_shares[0].values.size();
+        secure_arena::SecureVector<uint64_t> chunk_values(num_chunks);
+        try {
+            sss->reconstructChunks(parties, chunk_values.data());
+        } catch (const std::invalid_argument& ex) {
+            std::cerr << "ERROR: " << ex.what() << std::endl;
+            return nullptr;
+        }
         
         BIGNUM* reconstructed_d = BN_new();
         BN_zero(reconstructed_d);
-        
-        // Reconstruct each chunk
         for (size_t chunk_id = 0; chunk_id < num_chunks; ++chunk_id) {
-            // Gather shares from participating parties
-            std::vector<ShamirSecretSharing::Share> chunk_shares;
-            for (size_t party_id : party_ids) {
-                if (party_id > 0 && party_id <= num_parties) {
-                    chunk_shares.push_back(all_party_shares[party_id - 1].shares[chunk_id]);
-                }
-            }
-            
-            // Reconstruct chunk value
-            uint64_t chunk_value = sss->reconstruct(chunk_shares);
+            uint64_t chunk_value = chunk_values[chunk_id];
             
             // Add to reconstructed key
             BIGNUM* temp = BN_new();
@@ -174,17 +157,18 @@ public:
     bool writePEMKey(const std::string& filename, BIGNUM* d_reconstructed) {
         std::cout << "[4/4] Writing private key to " << filename << "..." << std::endl;
         
-        // Create EVP_PKEY from RSA structure
-        EVP_PKEY* pkey = EVP_PKEY_new();
-        if (!pkey) {
-            std::cerr << "ERROR: EVP_PKEY_new failed" << std::endl;
-            return false;
-        }
+        // Import (n, e, reconstructed d) through OSSL_PARAM; CRT parameters
+        // are recovered from d so the written key is a complete PKCS#8 key
+        BIGNUM* n = rsa_key_utils::getParam(pkey, OSSL_PKEY_PARAM_RSA_N);
+        BIGNUM* e = rsa_key_utils::getParam(pkey, OSSL_PKEY_PARAM_RSA_E);
+        EVP_PKEY* reconstructed = (n && e)
+            ? rsa_key_utils::importPrivateKey(n, e, d_reconstructed)
+            : nullptr;
+        BN_free(n);
+        BN_free(e);
         
-        // Assign RSA key to EVP_PKEY (EVP_PKEY takes a reference, not ownership)
-        if (EVP_PKEY_assign_RSA(pkey, RSAPrivateKey_dup(rsa)) != 1) {
-            std::cerr << "ERROR: EVP_PKEY_assign_RSA failed" << std::endl;
-            EVP_PKEY_free(pkey);
+        if (!reconstructed) {
+            std::cerr << "ERROR: Failed to import reconstructed key" << std::endl;
             return false;
         }
         
@@ -192,11 +176,11 @@ public:
         BIO* bio = BIO_new_file(filename.c_str(), "w");
         if (!bio) {
             std::cerr << "ERROR: Cannot open file " << filename << std::endl;
-            EVP_PKEY_free(pkey);
+            EVP_PKEY_free(reconstructed);
             return false;
         }
         
-        int result = PEM_write_bio_PrivateKey(bio, pkey, nullptr, nullptr, 0, nullptr, nullptr);
+        int result = PEM_write_bio_PrivateKey(bio, reconstructed, nullptr, nullptr, 0, nullptr, nullptr);
         BIO_free(bio);
         
         if (result != 1) {
@@ -204,7 +188,7 @@ public:
             char err_buf[256];
             ERR_error_string_n(ERR_get_error(), err_buf, sizeof(err_buf));
             std::cerr << "       OpenSSL error: " << err_buf << std::endl;
-            EVP_PKEY_free(pkey);
+            EVP_PKEY_free(reconstructed);
             return false;
         }
         
@@ -223,12 +207,12 @@ public:
         
         bio = BIO_new_file(pub_filename.c_str(), "w");
         if (bio) {
-            PEM_write_bio_PUBKEY(bio, pkey);
+            PEM_write_bio_PUBKEY(bio, reconstructed);
             BIO_free(bio);
             std::cout << "      ✓ Public key written to " << pub_filename << std::endl;
         }
         
-        EVP_PKEY_free(pkey);
+        EVP_PKEY_free(reconstructed);
         return true;
     }
     
@@ -246,13 +230,14 @@ public:
             }
             
             // Write number of shares
-            size_t num_shares = all_party_shares[p].shares.size();
+            const auto& party = all_party_shares[p];
+            size_t num_shares = party.values.size();
             ofs.write(reinterpret_cast<const char*>(&num_shares), sizeof(num_shares));
             
-            // Write each share
-            for (const auto& share : all_party_shares[p].shares) {
-                ofs.write(reinterpret_cast<const char*>(&share.id), sizeof(share.id));
-                ofs.write(reinterpret_cast<const char*>(&share.value), sizeof(share.value));
+            // Write each share as (id, value), as before the compact layout
+            for (uint64_t value : party.values) {
+                ofs.write(reinterpret_cast<const char*>(&party.id), sizeof(party.id));
+                ofs.write(reinterpret_cast<const char*>(&value), sizeof(value));
             }
             
             ofs.close();
@@ -272,9 +257,9 @@ int main(int argc, char* argv[]) {
     
     // Parse arguments
     if (argc < 2) {
-        std::cerr << "\nUsage: " << argv[0] << " <output_key_file> [num_parties] [threshold]" << std::endl;
-        std::cerr << "Example: " << argv[0] << " server-key.pem 5 3" << std::endl;
-        std::cerr << "\nDefault: 5 parties, threshold = 3" << std::endl;
+        std::cerr << "\nUsage: " << argv[0] << " <output_key_file> [num_parties] [threshold] [rsa_bits]" << std::endl;
+        std::cerr << "Example: " << argv[0] << " server-key.pem 5 3 4096" << std::endl;
+        std::cerr << "\nDefault: 5 parties, threshold = 3, 2048-bit key" << std::endl;
         return 1;
     }
     
@@ -284,6 +269,7 @@ int main(int argc, char* argv[]) {
     
     if (argc >= 3) num_parties = std::stoul(argv[2]);
     if (argc >= 4) threshold = std::stoul(argv[3]);
+    size_t rsa_bits = argc >= 5 ? std::stoul(argv[4]) : 2048;
     
     if (threshold > num_parties) {
         std::cerr << "ERROR: Threshold cannot exceed number of parties" << std::endl;
@@ -294,10 +280,11 @@ int main(int argc, char* argv[]) {
     std::cout << "  Output file: " << output_file << std::endl;
     std::cout << "  Parties: " << num_parties << std::endl;
     std::cout << "  Threshold: " << threshold << std::endl;
+    std::cout << "  Key size: " << rsa_bits << " bits" << std::endl;
     std::cout << std::string(70, '-') << std::endl;
     
     // Create generator
-    MultiPartyKeyGenerator generator(num_parties, threshold);
+    MultiPartyKeyGenerator generator(num_parties, threshold, rsa_bits);
     
     // Step 1: Generate RSA key
     if (!generator.generateRSAKey()) {
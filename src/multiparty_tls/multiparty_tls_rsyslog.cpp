@@ -10,7 +10,13 @@
  */
 
 #include "shamir_secret_sharing.hpp"
-#include <openssl/rsa.h>
+#include "rsa_key_utils.hpp"
+#include "threshold_rsa.hpp"
+#include "share_archive.hpp"
+#include "vss.hpp"
+#include "secure_arena.hpp"
+#include <openssl/core_names.h>
+#include <openssl/evp.h>
 #include <openssl/pem.h>
 #include <openssl/err.h>
 #include <openssl/bn.h>
@@ -21,6 +27,17 @@
 #include <vector>
 #include <memory>
 #include <cstring>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <endian.h>
 #include <sys/socket.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
@@ -44,6 +61,13 @@ const char* PARTY_NAMES[NUM_PARTIES] = {
     "Independent Auditor"
 };
 
+// Optional access policy (split --policy judiciary): the Judicial Authority
+// plus any two others, as levels and cumulative thresholds for
+// ShamirSecretSharing::setHierarchy. Recorded in POLICY_FILE next to the shares.
+const std::vector<size_t> JUDICIARY_PARTY_LEVELS = {0, 1, 1, 1, 1};
+const std::vector<size_t> JUDICIARY_LEVEL_THRESHOLDS = {1, THRESHOLD};
+const char* POLICY_FILE = "access.policy";
+
 // Party network endpoints (for distributed deployment)
 struct PartyEndpoint {
     size_t id;
@@ -60,7 +84,7 @@ struct KeyShareData {
     size_t party_id;
     std::string party_name;
     size_t num_chunks;
-    std::vector<ShamirSecretSharing::Share> shares;
+    ShamirSecretSharing::PartyShares shares;   // shares.id == party_id, one value per chunk
     
     bool saveToFile(const std::string& filename) const {
         std::ofstream file(filename, std::ios::binary);
@@ -73,10 +97,10 @@ struct KeyShareData {
         file.write(party_name.c_str(), name_len);
         file.write(reinterpret_cast<const char*>(&num_chunks), sizeof(num_chunks));
         
-        // Write shares
-        for (const auto& share : shares) {
-            file.write(reinterpret_cast<const char*>(&share.id), sizeof(share.id));
-            file.write(reinterpret_cast<const char*>(&share.value), sizeof(share.value));
+        // Write shares as (id, value) pairs
+        for (uint64_t value : shares.values) {
+            file.write(reinterpret_cast<const char*>(&shares.id), sizeof(shares.id));
+            file.write(reinterpret_cast<const char*>(&value), sizeof(value));
         }
         
         return file.good();
@@ -94,19 +118,171 @@ struct KeyShareData {
         file.read(&party_name[0], name_len);
         file.read(reinterpret_cast<char*>(&num_chunks), sizeof(num_chunks));
         
-        // Read shares
-        shares.clear();
-        for (size_t i = 0; i < num_chunks; ++i) {
-            ShamirSecretSharing::Share share;
-            file.read(reinterpret_cast<char*>(&share.id), sizeof(share.id));
-            file.read(reinterpret_cast<char*>(&share.value), sizeof(share.value));
-            shares.push_back(share);
+        // Read shares; every chunk must be at the same x
+        shares.id = 0;
+        shares.values.clear();
+        for (size_t i = 0; i < num_chunks && file.good(); ++i) {
+            size_t id;
+            uint64_t value;
+            file.read(reinterpret_cast<char*>(&id), sizeof(id));
+            file.read(reinterpret_cast<char*>(&value), sizeof(value));
+            if (i == 0) {
+                shares.id = id;
+            } else if (id != shares.id) {
+                return false;
+            }
+            shares.values.push_back(value);
         }
         
         return file.good();
     }
 };
 
+/**
+ * Refresh sub-shares dealt by one party to one recipient (one per chunk)
+ */
+struct SubShareData {
+    std::string round;          // Refresh round label; all files of a round share it
+    size_t dealer_id;
+    size_t recipient_id;
+    std::vector<uint64_t> values;
+    
+    bool saveToFile(const std::string& filename) const {
+        std::ofstream file(filename, std::ios::binary);
+        if (!file.is_open()) return false;
+        
+        size_t round_len = round.size();
+        file.write(reinterpret_cast<const char*>(&round_len), sizeof(round_len));
+        file.write(round.c_str(), round_len);
+        file.write(reinterpret_cast<const char*>(&dealer_id), sizeof(dealer_id));
+        file.write(reinterpret_cast<const char*>(&recipient_id), sizeof(recipient_id));
+        size_t num_chunks = values.size();
+        file.write(reinterpret_cast<const char*>(&num_chunks), sizeof(num_chunks));
+        file.write(reinterpret_cast<const char*>(values.data()), num_chunks * sizeof(uint64_t));
+        
+        return file.good();
+    }
+    
+    bool loadFromFile(const std::string& filename) {
+        std::ifstream file(filename, std::ios::binary);
+        if (!file.is_open()) return false;
+        
+        size_t round_len = 0;
+        file.read(reinterpret_cast<char*>(&round_len), sizeof(round_len));
+        if (!file.good() || round_len > 4096) return false;
+        round.resize(round_len);
+        file.read(&round[0], round_len);
+        file.read(reinterpret_cast<char*>(&dealer_id), sizeof(dealer_id));
+        file.read(reinterpret_cast<char*>(&recipient_id), sizeof(recipient_id));
+        size_t num_chunks = 0;
+        file.read(reinterpret_cast<char*>(&num_chunks), sizeof(num_chunks));
+        if (!file.good() || num_chunks > (1u << 20)) return false;
+        values.resize(num_chunks);
+        file.read(reinterpret_cast<char*>(values.data()), num_chunks * sizeof(uint64_t));
+        
+        return file.good();
+    }
+};
+
+// ============================================================================
+// CHUNK DEALING
+// ============================================================================
+
+/**
+ * 16 little-endian bytes as an integer, independent of host byte order
+ * (le64toh/htole64 are no-ops on little-endian targets)
+ */
+__uint128_t loadWindow(const uint8_t* bytes) {
+    uint64_t lo, hi;
+    memcpy(&lo, bytes, sizeof(lo));
+    memcpy(&hi, bytes + 8, sizeof(hi));
+    return static_cast<__uint128_t>(le64toh(hi)) << 64 | le64toh(lo);
+}
+
+void storeWindow(uint8_t* bytes, __uint128_t window) {
+    uint64_t lo = htole64(static_cast<uint64_t>(window));
+    uint64_t hi = htole64(static_cast<uint64_t>(window >> 64));
+    memcpy(bytes, &lo, sizeof(lo));
+    memcpy(bytes + 8, &hi, sizeof(hi));
+}
+
+/**
+ * Cut d into CHUNK_BITS-bit chunks, least significant first
+ */
+std::vector<uint64_t> extractChunks(const BIGNUM* d) {
+    size_t num_chunks = (BN_num_bits(d) + CHUNK_BITS - 1) / CHUNK_BITS;
+    std::vector<uint64_t> chunks(num_chunks);
+    
+    // One little-endian export, then chunks are read straight from the bytes
+    // (padding so every 16-byte window stays in bounds)
+    std::vector<uint8_t> bytes(BN_num_bytes(d) + 16, 0);
+    BN_bn2lebinpad(d, bytes.data(), static_cast<int>(bytes.size()));
+    
+    for (size_t chunk_id = 0; chunk_id < num_chunks; ++chunk_id) {
+        size_t bit = chunk_id * CHUNK_BITS;
+        __uint128_t window = loadWindow(&bytes[bit / 8]);
+        chunks[chunk_id] = static_cast<uint64_t>(window >> (bit % 8)) & ((1ULL << CHUNK_BITS) - 1);
+    }
+    OPENSSL_cleanse(bytes.data(), bytes.size());
+    return chunks;
+}
+
+/**
+ * Inverse of extractChunks: d = sum chunks[i] * 2^(i * CHUNK_BITS)
+ * @return New BIGNUM (BN_clear_free), or nullptr on failure
+ */
+BIGNUM* assembleChunks(const secure_arena::SecureVector<uint64_t>& chunks) {
+    // Chunks are below 2^CHUNK_BITS, so OR-ing them into a little-endian
+    // buffer is the same as adding the shifted values
+    secure_arena::SecureBytes bytes((chunks.size() * CHUNK_BITS + 7) / 8 + 16, 0);
+    for (size_t chunk_id = 0; chunk_id < chunks.size(); ++chunk_id) {
+        size_t bit = chunk_id * CHUNK_BITS;
+        __uint128_t window = loadWindow(&bytes[bit / 8]);
+        window |= static_cast<__uint128_t>(chunks[chunk_id]) << (bit % 8);
+        storeWindow(&bytes[bit / 8], window);
+    }
+    return BN_lebin2bn(bytes.data(), static_cast<int>(bytes.size()), nullptr);
+}
+
+/**
+ * Next k-subset of {0..n-1} in lexicographic order
+ * @return false after the last subset
+ */
+bool nextSubset(std::vector<size_t>& subset, size_t n) {
+    size_t k = subset.size();
+    for (size_t i = k; i-- > 0;) {
+        if (subset[i] < n - k + i) {
+            ++subset[i];
+            for (size_t j = i + 1; j < k; ++j) {
+                subset[j] = subset[j - 1] + 1;
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Access policy recorded next to a share file ("threshold" if none)
+ */
+std::string readPolicy(const std::string& share_file) {
+    std::filesystem::path dir = std::filesystem::path(share_file).parent_path();
+    std::ifstream in(dir / POLICY_FILE);
+    std::string policy;
+    return (in >> policy) ? policy : "threshold";
+}
+
+/**
+ * Split d into chunks and share each
+ * @return party_shares[i] holds the chunk shares of party i + 1
+ */
+std::vector<ShamirSecretSharing::PartyShares> dealChunks(const BIGNUM* d, ShamirSecretSharing& sss) {
+    std::vector<uint64_t> chunks = extractChunks(d);
+    auto party_shares = sss.splitChunks(chunks.data(), chunks.size());
+    OPENSSL_cleanse(chunks.data(), chunks.size() * sizeof(uint64_t));
+    return party_shares;
+}
+
 // ============================================================================
 // MULTI-PARTY KEY MANAGER
 // ============================================================================
@@ -115,32 +291,47 @@ class MultiPartyKeyManager {
 public:
     MultiPartyKeyManager() : sss_(THRESHOLD, NUM_PARTIES, PRIME) {}
     
+    /**
+     * Select the access policy: "threshold" (any THRESHOLD parties) or
+     * "judiciary" (the Judicial Authority plus any two others)
+     * @return false for an unknown policy name
+     */
+    bool setPolicy(const std::string& policy) {
+        if (policy == "judiciary") {
+            sss_.setHierarchy(JUDICIARY_PARTY_LEVELS, JUDICIARY_LEVEL_THRESHOLDS);
+            return true;
+        }
+        return policy == "threshold" && !sss_.isHierarchical();
+    }
+    
+    bool isHierarchical() const { return sss_.isHierarchical(); }
+    
     /**
      * Split RSA private key into shares for N parties
+     * @param commitments Public VSS commitments to every chunk polynomial
+     * @param blinding Per-party VSS blinding shares (kept with the share files)
      */
     bool splitPrivateKey(const std::string& private_key_path, 
-                        std::vector<KeyShareData>& party_shares) {
+                        std::vector<KeyShareData>& party_shares,
+                        vss::Commitments& commitments,
+                        std::vector<vss::BlindingShares>& blinding) {
         std::cout << "[INFO] Loading private key from: " << private_key_path << std::endl;
         
         // Load RSA private key
-        FILE* fp = fopen(private_key_path.c_str(), "r");
-        if (!fp) {
-            std::cerr << "[ERROR] Failed to open private key file" << std::endl;
+        EVP_PKEY* pkey = rsa_key_utils::loadPrivateKey(private_key_path);
+        if (!pkey) {
+            std::cerr << "[ERROR] Failed to read RSA private key" << std::endl;
             return false;
         }
         
-        RSA* rsa = PEM_read_RSAPrivateKey(fp, nullptr, nullptr, nullptr);
-        fclose(fp);
-        
-        if (!rsa) {
-            std::cerr << "[ERROR] Failed to read RSA private key" << std::endl;
+        // Export private exponent through OSSL_PARAM
+        BIGNUM* d = rsa_key_utils::getParam(pkey, OSSL_PKEY_PARAM_RSA_D);
+        EVP_PKEY_free(pkey);
+        if (!d) {
+            std::cerr << "[ERROR] Key has no RSA private exponent" << std::endl;
             return false;
         }
         
-        // Get private exponent
-        const BIGNUM *n, *e, *d;
-        RSA_get0_key(rsa, &n, &e, &d);
-        
         int d_bits = BN_num_bits(d);
         std::cout << "[INFO] Private key size: " << d_bits << " bits" << std::endl;
         
@@ -149,55 +340,81 @@ public:
         std::cout << "[INFO] Splitting into " << num_chunks << " chunks of " 
                   << CHUNK_BITS << " bits each" << std::endl;
         
-        // Initialize party shares
+        // Deal every chunk with commitments, then hand each party its column.
+        // Hierarchical shares are derivatives, which the VSS check does not
+        // cover; those are dealt without commitments.
+        std::vector<ShamirSecretSharing::PartyShares> shares;
+        if (sss_.isHierarchical()) {
+            shares = dealChunks(d, sss_);
+            BN_clear_free(d);
+        } else {
+            std::vector<uint64_t> chunks = extractChunks(d);
+            BN_clear_free(d);
+            vss::Dealing dealing = vss::deal(sss_, chunks);
+            OPENSSL_cleanse(chunks.data(), chunks.size() * sizeof(uint64_t));
+            shares = std::move(dealing.shares);
+            commitments = std::move(dealing.commitments);
+            blinding = std::move(dealing.blinding);
+        }
         party_shares.resize(NUM_PARTIES);
         for (size_t i = 0; i < NUM_PARTIES; ++i) {
             party_shares[i].party_id = i + 1;
             party_shares[i].party_name = PARTY_NAMES[i];
             party_shares[i].num_chunks = num_chunks;
-            party_shares[i].shares.clear();
+            party_shares[i].shares = std::move(shares[i]);
         }
         
-        // Split each chunk using SSS
-        BIGNUM* chunk_bn = BN_new();
-        for (size_t chunk_id = 0; chunk_id < num_chunks; ++chunk_id) {
-            // Extract chunk from private key
-            BN_copy(chunk_bn, d);
-            BN_rshift(chunk_bn, chunk_bn, chunk_id * CHUNK_BITS);
-            BN_mask_bits(chunk_bn, CHUNK_BITS);
-            
-            uint64_t chunk_value = BN_get_word(chunk_bn);
-            
-            // Split this chunk using Shamir's Secret Sharing
-            auto shares = sss_.split(chunk_value);
-            
-            // Distribute shares to parties
-            for (size_t party_id = 0; party_id < NUM_PARTIES; ++party_id) {
-                party_shares[party_id].shares.push_back(shares[party_id]);
-            }
-            
-            if ((chunk_id + 1) % 10 == 0) {
-                std::cout << "  Progress: " << (chunk_id + 1) << "/" << num_chunks 
-                          << " chunks processed" << std::endl;
-            }
-        }
-        
-        BN_free(chunk_bn);
-        RSA_free(rsa);
-        
         std::cout << "[SUCCESS] Private key split into " << num_chunks 
                   << " chunks, distributed to " << NUM_PARTIES << " parties" << std::endl;
         std::cout << "[INFO] Each party has " << num_chunks << " shares" << std::endl;
-        std::cout << "[INFO] Threshold: " << THRESHOLD << " parties required for reconstruction" << std::endl;
+        if (sss_.isHierarchical()) {
+            std::cout << "[INFO] Policy: " << PARTY_NAMES[0] << " plus any " << THRESHOLD - 1
+                      << " other parties required for reconstruction" << std::endl;
+        } else {
+            std::cout << "[INFO] Threshold: " << THRESHOLD << " parties required for reconstruction" << std::endl;
+        }
         
         return true;
     }
     
+    /**
+     * Drop parties whose shares do not match the VSS commitments
+     * @param blinding Blinding shares in the same order as parties
+     * @return Number of parties dropped
+     */
+    size_t dropInvalidParties(std::vector<KeyShareData>& parties,
+                              const std::vector<vss::BlindingShares>& blinding,
+                              const vss::Commitments& commitments) {
+        std::vector<vss::PartyShares> claimed;
+        for (size_t i = 0; i < parties.size(); ++i) {
+            claimed.push_back({parties[i].party_id, &parties[i].shares, &blinding[i].values});
+        }
+        std::vector<size_t> invalid = vss::findInvalidParties(commitments, claimed);
+        
+        std::vector<KeyShareData> valid;
+        for (auto& party : parties) {
+            if (std::find(invalid.begin(), invalid.end(), party.party_id) == invalid.end()) {
+                valid.push_back(std::move(party));
+            } else {
+                std::cerr << "[WARNING] Party " << party.party_id << " (" << party.party_name
+                          << ") failed VSS verification; dropped" << std::endl;
+            }
+        }
+        parties = std::move(valid);
+        return invalid.size();
+    }
+    
     /**
      * Reconstruct RSA private key from threshold parties
+     *
+     * With more than THRESHOLD parties the shares are error-corrected first;
+     * if that still gives no working key, THRESHOLD-subsets are retried
+     * (see retrySubsets).
+     * @param check Fast round-trip validation (default) or opt-in deep EVP_PKEY_check
      */
-    RSA* reconstructPrivateKey(const std::vector<KeyShareData>& participating_parties,
-                              const std::string& public_key_path) {
+    EVP_PKEY* reconstructPrivateKey(const std::vector<KeyShareData>& participating_parties,
+                              const std::string& public_key_path,
+                              rsa_key_utils::KeyCheck check = rsa_key_utils::KeyCheck::Fast) {
         if (participating_parties.size() < THRESHOLD) {
             std::cerr << "[ERROR] Insufficient parties: " << participating_parties.size() 
                       << " (need " << THRESHOLD << ")" << std::endl;
@@ -210,76 +427,510 @@ public:
             std::cout << "  - Party " << party.party_id << ": " << party.party_name << std::endl;
         }
         
-        size_t num_chunks = participating_parties[0].num_chunks;
+        // Every path below (and retrySubsets) reads num_chunks values from each party
+        size_t num_chunks = participating_parties[0].shares.values.size();
+        for (const auto& party : participating_parties) {
+            if (party.shares.values.size() != num_chunks) {
+                std::cerr << "[ERROR] Party " << party.party_id << " has " << party.shares.values.size()
+                          << " chunk shares, expected " << num_chunks << std::endl;
+                return nullptr;
+            }
+        }
+        
+        // Load public key components
+        EVP_PKEY* pub = rsa_key_utils::loadPublicKey(public_key_path);
+        if (!pub) {
+            std::cerr << "[ERROR] Failed to read RSA public key" << std::endl;
+            return nullptr;
+        }
         
-        // Reconstruct each chunk
-        BIGNUM* d_reconstructed = BN_new();
-        BN_zero(d_reconstructed);
+        BIGNUM* n = rsa_key_utils::getParam(pub, OSSL_PKEY_PARAM_RSA_N);
+        BIGNUM* e = rsa_key_utils::getParam(pub, OSSL_PKEY_PARAM_RSA_E);
+        EVP_PKEY_free(pub);
         
-        for (size_t chunk_id = 0; chunk_id < num_chunks; ++chunk_id) {
-            // Gather shares for this chunk from participating parties
-            std::vector<ShamirSecretSharing::Share> chunk_shares;
+        // With more than THRESHOLD parties, decode all shares together so up to
+        // (m - THRESHOLD) / 2 corrupted parties are corrected instead of the
+        // extra shares being ignored
+        // d's chunks are sized once in the secure arena (wiped when freed)
+        secure_arena::SecureVector<uint64_t> chunk_values;
+        chunk_values.reserve(num_chunks);
+        std::vector<size_t> used_ids;
+        bool decoded = true;
+        if (participating_parties.size() > THRESHOLD && !sss_.isHierarchical()) {
+            std::vector<std::vector<ShamirSecretSharing::Share>> chunk_shares(num_chunks);
+            for (size_t chunk_id = 0; chunk_id < num_chunks; ++chunk_id) {
+                chunk_shares[chunk_id].reserve(participating_parties.size());
+                for (const auto& party : participating_parties) {
+                    chunk_shares[chunk_id].push_back({party.shares.id, party.shares.values[chunk_id]});
+                }
+            }
+            std::vector<size_t> bad_ids;
+            try {
+                std::vector<uint64_t> decoded_values = sss_.reconstructRobust(chunk_shares, &bad_ids);
+                chunk_values.assign(decoded_values.begin(), decoded_values.end());
+                OPENSSL_cleanse(decoded_values.data(), decoded_values.size() * sizeof(uint64_t));
+            } catch (const std::invalid_argument& ex) {
+                std::cerr << "[ERROR] " << ex.what() << std::endl;
+                BN_free(n);
+                BN_free(e);
+                return nullptr;
+            } catch (const std::runtime_error& ex) {
+                std::cerr << "[WARNING] " << ex.what() << " (at most "
+                          << (participating_parties.size() - THRESHOLD) / 2
+                          << " corrupted parties can be corrected)" << std::endl;
+                decoded = false;
+            }
+            for (size_t id : bad_ids) {
+                std::cerr << "[WARNING] Party " << id << " supplied wrong shares; corrected" << std::endl;
+            }
             for (const auto& party : participating_parties) {
-                if (chunk_id < party.shares.size()) {
-                    chunk_shares.push_back(party.shares[chunk_id]);
+                if (std::find(bad_ids.begin(), bad_ids.end(), party.party_id) == bad_ids.end()) {
+                    used_ids.push_back(party.party_id);
                 }
             }
-            
-            // Reconstruct chunk value using Lagrange interpolation
-            uint64_t chunk_value = sss_.reconstruct(chunk_shares);
-            
-            // Add chunk to reconstructed private key
-            BIGNUM* chunk_bn = BN_new();
-            BN_set_word(chunk_bn, chunk_value);
-            BN_lshift(chunk_bn, chunk_bn, chunk_id * CHUNK_BITS);
-            BN_add(d_reconstructed, d_reconstructed, chunk_bn);
-            BN_free(chunk_bn);
+        } else {
+            try {
+                if (participating_parties.size() == THRESHOLD) {
+                    // Weights for the party ids once, then one party's contiguous values per pass
+                    std::vector<const ShamirSecretSharing::PartyShares*> columns;
+                    for (const auto& party : participating_parties) {
+                        columns.push_back(&party.shares);
+                    }
+                    chunk_values.resize(num_chunks);
+                    sss_.reconstructChunks(columns, chunk_values.data());
+                } else {
+                    // Extra parties under a policy: reconstruct picks an authorized
+                    // subset per chunk. One share buffer reused for every chunk.
+                    secure_arena::SecureVector<ShamirSecretSharing::Share> shares;
+                    shares.reserve(participating_parties.size());
+                    for (size_t chunk_id = 0; chunk_id < num_chunks; ++chunk_id) {
+                        shares.clear();
+                        for (const auto& party : participating_parties) {
+                            shares.push_back({party.shares.id, party.shares.values[chunk_id]});
+                        }
+                        chunk_values.push_back(sss_.reconstruct(shares.data(), shares.size()));
+                    }
+                }
+            } catch (const std::invalid_argument& ex) {
+                std::cerr << "[ERROR] " << ex.what() << std::endl;
+                BN_free(n);
+                BN_free(e);
+                return nullptr;
+            }
+            for (const auto& party : participating_parties) {
+                used_ids.push_back(party.party_id);
+            }
         }
         
-        std::cout << "[INFO] Private exponent reconstructed: " 
-                  << BN_num_bits(d_reconstructed) << " bits" << std::endl;
+        BIGNUM* d_reconstructed = decoded ? assembleChunks(chunk_values) : nullptr;
+        OPENSSL_cleanse(chunk_values.data(), chunk_values.size() * sizeof(uint64_t));
         
-        // Load public key components
-        FILE* fp = fopen(public_key_path.c_str(), "r");
-        if (!fp) {
-            std::cerr << "[ERROR] Failed to open public key file" << std::endl;
-            BN_clear_free(d_reconstructed);
-            return nullptr;
-        }
-        
-        RSA* rsa_pub = PEM_read_RSA_PUBKEY(fp, nullptr, nullptr, nullptr);
-        fclose(fp);
+        // Verify the reconstructed key: a single round-trip proves d matches (n, e);
+        // the primality tests in EVP_PKEY_check only run when explicitly requested
+        rsa_key_utils::RoundTripCheck round_trip(n, e);
+        bool valid = d_reconstructed && round_trip.matches(d_reconstructed);
         
-        if (!rsa_pub) {
-            std::cerr << "[ERROR] Failed to read RSA public key" << std::endl;
+        // Extra parties but no working key: look for a good THRESHOLD-subset
+        if (!valid && participating_parties.size() > THRESHOLD) {
+            std::cerr << "[WARNING] Combined shares do not give a valid key; trying subsets of "
+                      << THRESHOLD << " parties" << std::endl;
             BN_clear_free(d_reconstructed);
-            return nullptr;
+            d_reconstructed = retrySubsets(participating_parties, round_trip, used_ids);
+            valid = d_reconstructed != nullptr;
+        }
+        if (valid) {
+            recordSuccess(used_ids);
+            std::cout << "[INFO] Private exponent reconstructed: "
+                      << BN_num_bits(d_reconstructed) << " bits" << std::endl;
         }
         
-        // Create new RSA key with reconstructed private key
-        const BIGNUM *n, *e;
-        RSA_get0_key(rsa_pub, &n, &e, nullptr);
-        
-        BIGNUM* n_copy = BN_dup(n);
-        BIGNUM* e_copy = BN_dup(e);
+        // Import (n, e, d) together with the recovered p, q and CRT exponents
+        // so later decryptions take the CRT path (~3-4x faster than bare d)
+        EVP_PKEY* key_reconstructed = nullptr;
+        bool has_crt = false;
+        if (valid) {
+            key_reconstructed = rsa_key_utils::importPrivateKey(n, e, d_reconstructed, &has_crt);
+            if (key_reconstructed && !has_crt) {
+                std::cerr << "[WARNING] Could not recover CRT parameters; key has (n, e, d) only" << std::endl;
+            }
+        }
         
-        RSA* rsa_reconstructed = RSA_new();
-        RSA_set0_key(rsa_reconstructed, n_copy, e_copy, d_reconstructed);
+        BN_free(n);
+        BN_free(e);
+        BN_clear_free(d_reconstructed);
         
-        RSA_free(rsa_pub);
+        if (key_reconstructed && check == rsa_key_utils::KeyCheck::Deep) {
+            valid = rsa_key_utils::deepCheck(key_reconstructed);
+        }
         
-        // Verify the reconstructed key is valid
-        if (RSA_check_key(rsa_reconstructed) == 1) {
+        if (valid && key_reconstructed) {
             std::cout << "[SUCCESS] Private key successfully reconstructed and verified" << std::endl;
         } else {
             std::cerr << "[WARNING] Reconstructed key failed validation" << std::endl;
         }
         
-        return rsa_reconstructed;
+        return key_reconstructed;
+    }
+    
+    /**
+     * Proactive refresh, dealer side: a sharing of zero for every chunk
+     * @return One SubShareData per recipient party
+     */
+    std::vector<SubShareData> dealRefresh(const KeyShareData& own, const std::string& round) {
+        auto sub_shares = sss_.dealZeroSharing(own.shares.values.size());
+        std::vector<SubShareData> out(NUM_PARTIES);
+        for (size_t j = 0; j < NUM_PARTIES; ++j) {
+            out[j].round = round;
+            out[j].dealer_id = own.party_id;
+            out[j].recipient_id = j + 1;
+            out[j].values = std::move(sub_shares[j]);
+        }
+        return out;
+    }
+    
+    /**
+     * Proactive refresh, recipient side: add every dealer's sub-shares
+     *
+     * All parties must apply the same set of dealers for the same round,
+     * otherwise their refreshed shares no longer lie on common polynomials.
+     */
+    bool applyRefresh(KeyShareData& own, const std::vector<SubShareData>& subs) {
+        if (subs.empty()) {
+            std::cerr << "[ERROR] No sub-shares given" << std::endl;
+            return false;
+        }
+        std::set<size_t> dealers;
+        for (const auto& sub : subs) {
+            if (sub.round != subs[0].round) {
+                std::cerr << "[ERROR] Sub-shares from different rounds: '" << sub.round
+                          << "' and '" << subs[0].round << "'" << std::endl;
+                return false;
+            }
+            if (sub.recipient_id != own.party_id) {
+                std::cerr << "[ERROR] Sub-share from Party " << sub.dealer_id << " is addressed to Party "
+                          << sub.recipient_id << ", not " << own.party_id << std::endl;
+                return false;
+            }
+            if (sub.values.size() != own.shares.values.size()) {
+                std::cerr << "[ERROR] Sub-share from Party " << sub.dealer_id << " covers "
+                          << sub.values.size() << " chunks, shares have " << own.shares.values.size() << std::endl;
+                return false;
+            }
+            if (sub.dealer_id < 1 || sub.dealer_id > NUM_PARTIES || !dealers.insert(sub.dealer_id).second) {
+                std::cerr << "[ERROR] Invalid or repeated dealer: Party " << sub.dealer_id << std::endl;
+                return false;
+            }
+            for (uint64_t value : sub.values) {
+                if (value >= PRIME) {
+                    std::cerr << "[ERROR] Sub-share from Party " << sub.dealer_id << " is not a field element" << std::endl;
+                    return false;
+                }
+            }
+        }
+        
+        for (const auto& sub : subs) {
+            sss_.addSubShares(own.shares, sub.values);
+        }
+        return true;
     }
     
+    /**
+     * Remember which parties gave a working key (subset retry tries them first)
+     * @param path Text file of "party_id sequence" lines; empty disables it
+     */
+    void setHistoryFile(const std::string& path) { history_path_ = path; }
+    
 private:
     ShamirSecretSharing sss_;
+    std::string history_path_;
+    
+    /**
+     * Last success sequence number per party id (0 = never)
+     */
+    std::map<size_t, uint64_t> loadHistory() const {
+        std::map<size_t, uint64_t> history;
+        std::ifstream in(history_path_);
+        size_t party_id;
+        uint64_t sequence;
+        while (in >> party_id >> sequence) {
+            history[party_id] = sequence;
+        }
+        return history;
+    }
+    
+    void recordSuccess(const std::vector<size_t>& party_ids) const {
+        if (history_path_.empty()) {
+            return;
+        }
+        auto history = loadHistory();
+        uint64_t next = 1;
+        for (const auto& entry : history) {
+            next = std::max(next, entry.second + 1);
+        }
+        for (size_t id : party_ids) {
+            history[id] = next;
+        }
+        std::ofstream out(history_path_, std::ios::trunc);
+        for (const auto& entry : history) {
+            out << entry.first << " " << entry.second << "\n";
+        }
+        if (!out) {
+            std::cerr << "[WARNING] Could not update reconstruction history: " << history_path_ << std::endl;
+        }
+    }
+    
+    /**
+     * Try THRESHOLD-subsets of the parties until one passes the round-trip check
+     *
+     * Parties are ordered by their last success (most recent first) and
+     * subsets enumerated lexicographically in that order, so the set that
+     * worked last time is tried first. Each subset costs one set of Lagrange
+     * weights (computed once and reused for all its chunks), t
+     * multiplications per chunk and one c^d mod n.
+     * Every party must hold the same number of chunk shares.
+     * @param used_ids Receives the ids of the working subset
+     * @return d (BN_clear_free), or nullptr if no subset works
+     */
+    BIGNUM* retrySubsets(const std::vector<KeyShareData>& parties, rsa_key_utils::RoundTripCheck& round_trip,
+                         std::vector<size_t>& used_ids) {
+        auto history = loadHistory();
+        std::vector<size_t> order(parties.size());
+        for (size_t i = 0; i < order.size(); ++i) {
+            order[i] = i;
+        }
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            return history[parties[a].party_id] > history[parties[b].party_id];
+        });
+        
+        size_t num_chunks = parties[0].shares.values.size();
+        std::vector<size_t> subset(THRESHOLD);
+        for (size_t j = 0; j < THRESHOLD; ++j) {
+            subset[j] = j;
+        }
+        secure_arena::SecureVector<ShamirSecretSharing::Share> shares(THRESHOLD);
+        secure_arena::SecureVector<uint64_t> chunk_values(num_chunks);
+        std::vector<uint64_t> weights;
+        size_t attempts = 0;
+        auto start = std::chrono::steady_clock::now();
+        
+        do {
+            std::vector<size_t> ids(THRESHOLD);
+            for (size_t j = 0; j < THRESHOLD; ++j) {
+                ids[j] = parties[order[subset[j]]].party_id;
+            }
+            try {
+                weights = sss_.lagrangeWeights(ids);
+            } catch (const std::invalid_argument&) {
+                continue;   // Duplicate party ids, or a subset the policy does not authorize
+            }
+            
+            for (size_t chunk_id = 0; chunk_id < num_chunks; ++chunk_id) {
+                for (size_t j = 0; j < THRESHOLD; ++j) {
+                    const auto& party = parties[order[subset[j]]].shares;
+                    shares[j] = {party.id, party.values[chunk_id]};
+                }
+                chunk_values[chunk_id] = sss_.reconstructWithWeights(weights, shares.data(), shares.size());
+            }
+            BIGNUM* d = assembleChunks(chunk_values);
+            ++attempts;
+            
+            std::string names;
+            for (size_t id : ids) {
+                names += (names.empty() ? "" : ", ") + std::to_string(id);
+            }
+            if (d && round_trip.matches(d)) {
+                double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+                std::cout << "[INFO] Parties " << names << " give a valid key (" << attempts
+                          << " subsets tried, " << ms << " ms)" << std::endl;
+                OPENSSL_cleanse(chunk_values.data(), chunk_values.size() * sizeof(uint64_t));
+                used_ids = ids;
+                return d;
+            }
+            std::cerr << "[INFO] Parties " << names << ": no valid key" << std::endl;
+            BN_clear_free(d);
+        } while (nextSubset(subset, parties.size()));
+        
+        OPENSSL_cleanse(chunk_values.data(), chunk_values.size() * sizeof(uint64_t));
+        std::cerr << "[ERROR] No subset of " << THRESHOLD << " parties gives a valid key" << std::endl;
+        return nullptr;
+    }
+};
+
+// ============================================================================
+// BATCH SPLITTING (fleet key rotation)
+// ============================================================================
+
+/**
+ * Splits many PEM keys into one indexed share archive per party
+ *
+ * Worker threads pull keys from a shared counter, parse the PEM and deal the
+ * chunks with their own ShamirSecretSharing instance. Finished keys go
+ * through a bounded queue to the calling thread, which appends them to the
+ * party archives; only that thread touches the files, so writes stay
+ * sequential and large.
+ */
+class BatchSplitter {
+public:
+    struct Input {
+        std::string name;   // Archive key (file name without .pem)
+        std::string path;
+    };
+    
+    struct Report {
+        size_t split = 0;
+        size_t failed = 0;
+        double seconds = 0;
+    };
+    
+    /**
+     * Collect inputs from a directory (every *.pem) or a manifest (one path
+     * per line, # comments)
+     */
+    static bool collectInputs(const std::string& source, std::vector<Input>& inputs) {
+        namespace fs = std::filesystem;
+        std::vector<std::string> paths;
+        std::error_code ec;
+        if (fs::is_directory(source, ec)) {
+            for (const auto& entry : fs::directory_iterator(source, ec)) {
+                if (entry.is_regular_file() && entry.path().extension() == ".pem") {
+                    paths.push_back(entry.path().string());
+                }
+            }
+            std::sort(paths.begin(), paths.end());
+        } else {
+            std::ifstream manifest(source);
+            if (!manifest.is_open()) {
+                std::cerr << "[ERROR] Cannot open key directory or manifest: " << source << std::endl;
+                return false;
+            }
+            std::string line;
+            while (std::getline(manifest, line)) {
+                line.erase(0, line.find_first_not_of(" \t"));
+                line.erase(line.find_last_not_of(" \t\r") + 1);
+                if (!line.empty() && line[0] != '#') {
+                    paths.push_back(line);
+                }
+            }
+        }
+        
+        std::set<std::string> names;
+        for (const auto& path : paths) {
+            std::string name = fs::path(path).stem().string();
+            if (!names.insert(name).second) {
+                std::cerr << "[ERROR] Duplicate key name '" << name << "' (" << path << ")" << std::endl;
+                return false;
+            }
+            inputs.push_back({name, path});
+        }
+        return true;
+    }
+    
+    /**
+     * Split every input into output_dir/party_N.sharearchive
+     */
+    static bool run(const std::vector<Input>& inputs, const std::string& output_dir,
+                    size_t num_threads, Report& report) {
+        share_archive::Writer archives[NUM_PARTIES];
+        for (size_t i = 0; i < NUM_PARTIES; ++i) {
+            std::string filename = output_dir + "/party_" + std::to_string(i + 1) + ".sharearchive";
+            if (!archives[i].open(filename, i + 1, PARTY_NAMES[i])) {
+                std::cerr << "[ERROR] Cannot create archive: " << filename << std::endl;
+                return false;
+            }
+        }
+        
+        auto start = std::chrono::steady_clock::now();
+        std::atomic<size_t> next{0};
+        std::mutex mutex;
+        std::condition_variable ready, space;
+        std::deque<Result> queue;
+        size_t workers_left = num_threads;
+        const size_t queue_limit = 4 * num_threads;
+        
+        std::vector<std::thread> workers;
+        for (size_t w = 0; w < num_threads; ++w) {
+            workers.emplace_back([&] {
+                ShamirSecretSharing sss(THRESHOLD, NUM_PARTIES, PRIME);
+                for (size_t i; (i = next.fetch_add(1)) < inputs.size();) {
+                    Result result = splitOne(inputs[i], i, sss);
+                    std::unique_lock<std::mutex> lock(mutex);
+                    space.wait(lock, [&] { return queue.size() < queue_limit; });
+                    queue.push_back(std::move(result));
+                    ready.notify_one();
+                }
+                std::lock_guard<std::mutex> lock(mutex);
+                --workers_left;
+                ready.notify_one();
+            });
+        }
+        
+        bool written = true;
+        size_t done = 0;
+        while (true) {
+            std::unique_lock<std::mutex> lock(mutex);
+            ready.wait(lock, [&] { return !queue.empty() || workers_left == 0; });
+            if (queue.empty()) {
+                break;
+            }
+            Result result = std::move(queue.front());
+            queue.pop_front();
+            space.notify_one();
+            lock.unlock();
+            
+            const Input& input = inputs[result.index];
+            if (!result.ok) {
+                std::cerr << "  ✗ " << input.path << ": " << result.error << std::endl;
+                report.failed++;
+            } else {
+                for (size_t p = 0; p < NUM_PARTIES; ++p) {
+                    written = archives[p].append(input.name, result.party_shares[p]) && written;
+                }
+                report.split++;
+            }
+            if (++done % 1000 == 0) {
+                std::cout << "  Progress: " << done << "/" << inputs.size() << " keys" << std::endl;
+            }
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        for (auto& archive : archives) {
+            written = archive.close() && written;
+        }
+        report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        
+        if (!written) {
+            std::cerr << "[ERROR] Writing share archives failed" << std::endl;
+        }
+        return written;
+    }
+    
+private:
+    struct Result {
+        size_t index;
+        bool ok;
+        std::string error;
+        std::vector<ShamirSecretSharing::PartyShares> party_shares;
+    };
+    
+    static Result splitOne(const Input& input, size_t index, ShamirSecretSharing& sss) {
+        Result result{index, false, "", {}};
+        EVP_PKEY* pkey = rsa_key_utils::loadPrivateKey(input.path);
+        if (!pkey) {
+            result.error = "not a readable private key";
+            return result;
+        }
+        BIGNUM* d = rsa_key_utils::getParam(pkey, OSSL_PKEY_PARAM_RSA_D);
+        EVP_PKEY_free(pkey);
+        if (!d) {
+            result.error = "key has no RSA private exponent";
+            return result;
+        }
+        result.party_shares = dealChunks(d, sss);
+        BN_clear_free(d);
+        result.ok = true;
+        return result;
+    }
 };
 
 // ============================================================================
@@ -289,7 +940,15 @@ private:
 class PartyShareServer {
 public:
     PartyShareServer(int port, const KeyShareData& shares) 
-        : port_(port), shares_(shares), running_(false) {}
+        : port_(port), shares_(shares), has_exponent_share_(false), running_(false) {}
+    
+    /**
+     * Also answer PARTIALEXP requests (threshold RSA, d never leaves the party)
+     */
+    void setExponentShare(const threshold_rsa::PartyKeyShare& share) {
+        exponent_share_ = share;
+        has_exponent_share_ = true;
+    }
     
     bool start() {
         // Create socket
@@ -341,20 +1000,28 @@ public:
         
         std::cout << "[INFO] Connection from " << inet_ntoa(client_addr.sin_addr) << std::endl;
         
-        // Read request (simple protocol: send shares)
-        char buffer[1024];
-        ssize_t n = read(client_fd, buffer, sizeof(buffer));
+        // Fixed-length command word, followed by a command-specific body
+        char buffer[threshold_rsa::REQUEST_WORD_LENGTH];
+        ssize_t n = recv(client_fd, buffer, sizeof(buffer), MSG_WAITALL);
+        bool complete = n == static_cast<ssize_t>(sizeof(buffer));
         
-        if (n > 0 && strncmp(buffer, "GET_SHARES", 10) == 0) {
+        if (complete && has_exponent_share_ &&
+            memcmp(buffer, threshold_rsa::PARTIAL_REQUEST, sizeof(buffer)) == 0) {
+            if (threshold_rsa::servePartialRequest(client_fd, exponent_share_)) {
+                std::cout << "[SUCCESS] Partial exponentiation served" << std::endl;
+            } else {
+                std::cerr << "[ERROR] Partial exponentiation request failed" << std::endl;
+            }
+        } else if (complete && memcmp(buffer, "GET_SHARES", sizeof(buffer)) == 0) {
             std::cout << "[INFO] Providing shares to requester" << std::endl;
             
             // Send shares (in production, add authentication & authorization here)
-            size_t num_shares = shares_.shares.size();
+            size_t num_shares = shares_.shares.values.size();
             write(client_fd, &num_shares, sizeof(num_shares));
             
-            for (const auto& share : shares_.shares) {
-                write(client_fd, &share.id, sizeof(share.id));
-                write(client_fd, &share.value, sizeof(share.value));
+            for (uint64_t value : shares_.shares.values) {
+                write(client_fd, &shares_.shares.id, sizeof(shares_.shares.id));
+                write(client_fd, &value, sizeof(value));
             }
             
             std::cout << "[SUCCESS] Shares sent (" << num_shares << " chunks)" << std::endl;
@@ -371,6 +1038,8 @@ public:
 private:
     int port_;
     KeyShareData shares_;
+    threshold_rsa::PartyKeyShare exponent_share_;
+    bool has_exponent_share_;
     bool running_;
     int server_fd_;
 };
@@ -383,13 +1052,23 @@ void printUsage(const char* program_name) {
     std::cout << "Multi-Party Threshold TLS for Rsyslog\n" << std::endl;
     std::cout << "Usage:" << std::endl;
     std::cout << "  1. Split private key:" << std::endl;
-    std::cout << "     " << program_name << " split <private_key.pem> <output_dir>" << std::endl;
+    std::cout << "     " << program_name << " split <private_key.pem> <output_dir> [--policy threshold|judiciary]" << std::endl;
     std::cout << std::endl;
     std::cout << "  2. Run party share server:" << std::endl;
-    std::cout << "     " << program_name << " server <party_id> <share_file> <port>" << std::endl;
+    std::cout << "     " << program_name << " server <party_id> <share_file> <port> [tkey_file]" << std::endl;
     std::cout << std::endl;
     std::cout << "  3. Reconstruct key (for testing):" << std::endl;
-    std::cout << "     " << program_name << " reconstruct <share_file1> <share_file2> <share_file3> <public_key.pem> <output.pem>" << std::endl;
+    std::cout << "     " << program_name << " reconstruct <share_file1> <share_file2> <share_file3> [share_file...] <public_key.pem> <output.pem> [--deep-check] [--vss <commitments.vss>] [--history <file>]" << std::endl;
+    std::cout << std::endl;
+    std::cout << "  4. Split many keys into one share archive per party:" << std::endl;
+    std::cout << "     " << program_name << " split-batch <key_dir|manifest> <output_dir> [threads]" << std::endl;
+    std::cout << std::endl;
+    std::cout << "  5. List an archive, or extract one key's share file from it:" << std::endl;
+    std::cout << "     " << program_name << " extract <archive> [<key_name> <output.share>]" << std::endl;
+    std::cout << std::endl;
+    std::cout << "  6. Refresh shares without reconstructing the key (every party deals, then applies):" << std::endl;
+    std::cout << "     " << program_name << " refresh-deal <share_file> <round> <output_dir>" << std::endl;
+    std::cout << "     " << program_name << " refresh-apply <share_file> <sub_file>..." << std::endl;
     std::cout << std::endl;
     std::cout << "Authorization Parties:" << std::endl;
     for (size_t i = 0; i < NUM_PARTIES; ++i) {
@@ -397,6 +1076,7 @@ void printUsage(const char* program_name) {
     }
     std::cout << std::endl;
     std::cout << "Threshold: " << THRESHOLD << " parties required" << std::endl;
+    std::cout << "Policy 'judiciary': " << PARTY_NAMES[0] << " plus any " << THRESHOLD - 1 << " others" << std::endl;
 }
 
 int main(int argc, char* argv[]) {
@@ -409,20 +1089,28 @@ int main(int argc, char* argv[]) {
     MultiPartyKeyManager key_manager;
     
     if (command == "split") {
-        if (argc != 4) {
-            std::cerr << "Usage: " << argv[0] << " split <private_key.pem> <output_dir>" << std::endl;
+        bool has_policy = argc == 6 && std::string(argv[4]) == "--policy";
+        if (argc != 4 && !has_policy) {
+            std::cerr << "Usage: " << argv[0] << " split <private_key.pem> <output_dir> [--policy threshold|judiciary]" << std::endl;
             return 1;
         }
         
         std::string private_key_path = argv[2];
         std::string output_dir = argv[3];
+        std::string policy = has_policy ? argv[5] : "threshold";
+        if (!key_manager.setPolicy(policy)) {
+            std::cerr << "[ERROR] Unknown policy: " << policy << std::endl;
+            return 1;
+        }
         
         std::cout << "========================================" << std::endl;
         std::cout << "RSA PRIVATE KEY SPLITTING" << std::endl;
         std::cout << "========================================" << std::endl;
         
         std::vector<KeyShareData> party_shares;
-        if (!key_manager.splitPrivateKey(private_key_path, party_shares)) {
+        vss::Commitments commitments;
+        std::vector<vss::BlindingShares> blinding;
+        if (!key_manager.splitPrivateKey(private_key_path, party_shares, commitments, blinding)) {
             std::cerr << "[ERROR] Failed to split private key" << std::endl;
             return 1;
         }
@@ -438,15 +1126,203 @@ int main(int argc, char* argv[]) {
             }
         }
         
+        // Hierarchical shares: record the policy for reconstruct and refresh-deal.
+        // Neither VSS nor the (plain 3-of-5) threshold RSA pieces apply to them.
+        if (key_manager.isHierarchical()) {
+            std::string policy_file = output_dir + "/" + POLICY_FILE;
+            std::ofstream out(policy_file);
+            out << policy << "\n";
+            if (!out) {
+                std::cerr << "[ERROR] Failed to save access policy to: " << policy_file << std::endl;
+                return 1;
+            }
+            std::cout << "  ✓ Access policy saved to: " << policy_file << std::endl;
+            std::cout << "[INFO] No VSS commitments or threshold RSA pieces under a hierarchical policy" << std::endl;
+            std::cout << "\n[SUCCESS] Key splitting complete!" << std::endl;
+            return 0;
+        }
+        
+        // Verifiable secret sharing: public commitments plus a private blinding file per party
+        std::string commitments_file = output_dir + "/commitments.vss";
+        if (commitments.saveToFile(commitments_file)) {
+            std::cout << "  ✓ VSS commitments (public) saved to: " << commitments_file << std::endl;
+        } else {
+            std::cerr << "  ✗ Failed to save VSS commitments" << std::endl;
+        }
+        for (const auto& party_blinding : blinding) {
+            std::string filename = output_dir + "/party_" + std::to_string(party_blinding.party_id) + ".blind";
+            if (!party_blinding.saveToFile(filename)) {
+                std::cerr << "  ✗ Failed to save VSS blinding shares for Party " << party_blinding.party_id << std::endl;
+            }
+        }
+        
+        // Exponent pieces for online threshold RSA (signing without reconstruction)
+        EVP_PKEY* pkey = rsa_key_utils::loadPrivateKey(private_key_path);
+        auto exponent_shares = pkey ? threshold_rsa::dealExponentShares(pkey, THRESHOLD, NUM_PARTIES)
+                                    : std::vector<threshold_rsa::PartyKeyShare>();
+        EVP_PKEY_free(pkey);
+        if (exponent_shares.empty()) {
+            std::cerr << "[ERROR] Failed to deal threshold RSA exponent shares" << std::endl;
+            return 1;
+        }
+        for (const auto& share : exponent_shares) {
+            std::string filename = output_dir + "/party_" + std::to_string(share.party_id) + ".tkey";
+            if (share.saveToFile(filename)) {
+                std::cout << "  ✓ Party " << share.party_id << " exponent pieces saved to: " << filename << std::endl;
+            } else {
+                std::cerr << "  ✗ Failed to save exponent pieces for Party " << share.party_id << std::endl;
+            }
+        }
+        
         std::cout << "\n[SUCCESS] Key splitting complete!" << std::endl;
         std::cout << "\nNext steps:" << std::endl;
         std::cout << "1. Distribute share files to respective authorization parties" << std::endl;
-        std::cout << "2. Each party runs: " << argv[0] << " server <party_id> <share_file> <port>" << std::endl;
+        std::cout << "2. Each party runs: " << argv[0] << " server <party_id> <share_file> <port> [tkey_file]" << std::endl;
         std::cout << "3. Configure rsyslog to use multi-party TLS module" << std::endl;
         
-    } else if (command == "server") {
+    } else if (command == "split-batch") {
+        if (argc != 4 && argc != 5) {
+            std::cerr << "Usage: " << argv[0] << " split-batch <key_dir|manifest> <output_dir> [threads]" << std::endl;
+            return 1;
+        }
+        
+        size_t num_threads = argc == 5 ? std::stoul(argv[4]) : std::thread::hardware_concurrency();
+        num_threads = std::max<size_t>(1, num_threads);
+        
+        std::cout << "========================================" << std::endl;
+        std::cout << "BATCH RSA PRIVATE KEY SPLITTING" << std::endl;
+        std::cout << "========================================" << std::endl;
+        
+        std::vector<BatchSplitter::Input> inputs;
+        if (!BatchSplitter::collectInputs(argv[2], inputs)) {
+            return 1;
+        }
+        std::cout << "[INFO] " << inputs.size() << " keys, " << num_threads << " worker threads" << std::endl;
+        
+        BatchSplitter::Report report;
+        if (!BatchSplitter::run(inputs, argv[3], num_threads, report)) {
+            return 1;
+        }
+        
+        std::cout << "[SUCCESS] " << report.split << " keys split in " << report.seconds << " s ("
+                  << (report.seconds > 0 ? report.split / report.seconds : 0) << " keys/sec)" << std::endl;
+        if (report.failed > 0) {
+            std::cerr << "[WARNING] " << report.failed << " keys could not be split" << std::endl;
+        }
+        std::cout << "[INFO] Archives: " << argv[3] << "/party_<1.." << NUM_PARTIES << ">.sharearchive" << std::endl;
+        std::cout << "[NOTE] Threshold RSA exponent pieces (.tkey) are only dealt by single-key split" << std::endl;
+        return report.failed == 0 ? 0 : 1;
+        
+    } else if (command == "extract") {
+        if (argc != 3 && argc != 5) {
+            std::cerr << "Usage: " << argv[0] << " extract <archive> [<key_name> <output.share>]" << std::endl;
+            return 1;
+        }
+        
+        share_archive::Reader archive;
+        if (!archive.open(argv[2])) {
+            std::cerr << "[ERROR] Not a complete share archive: " << argv[2] << std::endl;
+            return 1;
+        }
+        
+        if (argc == 3) {
+            std::cout << "Party " << archive.partyId() << " (" << archive.partyName() << ")" << std::endl;
+            for (const auto& name : archive.keys()) {
+                std::cout << "  " << name << std::endl;
+            }
+            return 0;
+        }
+        
+        KeyShareData share_data;
+        share_data.party_id = archive.partyId();
+        share_data.party_name = archive.partyName();
+        if (!archive.read(argv[3], share_data.shares)) {
+            std::cerr << "[ERROR] Key '" << argv[3] << "' not found in archive" << std::endl;
+            return 1;
+        }
+        share_data.num_chunks = share_data.shares.values.size();
+        if (!share_data.saveToFile(argv[4])) {
+            std::cerr << "[ERROR] Failed to write: " << argv[4] << std::endl;
+            return 1;
+        }
+        std::cout << "[SUCCESS] Party " << share_data.party_id << " shares of '" << argv[3]
+                  << "' saved to: " << argv[4] << std::endl;
+        
+    } else if (command == "refresh-deal") {
         if (argc != 5) {
-            std::cerr << "Usage: " << argv[0] << " server <party_id> <share_file> <port>" << std::endl;
+            std::cerr << "Usage: " << argv[0] << " refresh-deal <share_file> <round> <output_dir>" << std::endl;
+            return 1;
+        }
+        
+        KeyShareData own;
+        if (!own.loadFromFile(argv[2])) {
+            std::cerr << "[ERROR] Failed to load shares from: " << argv[2] << std::endl;
+            return 1;
+        }
+        std::string round = argv[3];
+        std::string output_dir = argv[4];
+        if (!key_manager.setPolicy(readPolicy(argv[2]))) {
+            std::cerr << "[ERROR] Unknown access policy next to: " << argv[2] << std::endl;
+            return 1;
+        }
+        
+        auto subs = key_manager.dealRefresh(own, round);
+        for (const auto& sub : subs) {
+            std::string filename = output_dir + "/refresh_" + round + "_" + std::to_string(sub.dealer_id)
+                                 + "_to_" + std::to_string(sub.recipient_id) + ".sub";
+            if (!sub.saveToFile(filename)) {
+                std::cerr << "[ERROR] Failed to write: " << filename << std::endl;
+                return 1;
+            }
+            std::cout << "  ✓ Sub-shares for Party " << sub.recipient_id << ": " << filename << std::endl;
+        }
+        std::cout << "[SUCCESS] Party " << own.party_id << " dealt zero-sharings for "
+                  << own.shares.values.size() << " chunks (round '" << round << "')" << std::endl;
+        std::cout << "[INFO] Send each .sub file to its recipient over an authenticated, encrypted channel" << std::endl;
+        
+    } else if (command == "refresh-apply") {
+        if (argc < 4) {
+            std::cerr << "Usage: " << argv[0] << " refresh-apply <share_file> <sub_file>..." << std::endl;
+            return 1;
+        }
+        
+        std::string share_file = argv[2];
+        KeyShareData own;
+        if (!own.loadFromFile(share_file)) {
+            std::cerr << "[ERROR] Failed to load shares from: " << share_file << std::endl;
+            return 1;
+        }
+        
+        std::vector<SubShareData> subs;
+        for (int i = 3; i < argc; ++i) {
+            SubShareData sub;
+            if (!sub.loadFromFile(argv[i])) {
+                std::cerr << "[ERROR] Failed to load sub-shares from: " << argv[i] << std::endl;
+                return 1;
+            }
+            subs.push_back(std::move(sub));
+        }
+        
+        if (!key_manager.applyRefresh(own, subs)) {
+            return 1;
+        }
+        
+        // Replace the share file atomically so a crash never leaves a half-refreshed file
+        std::string temp_file = share_file + ".refresh";
+        if (!own.saveToFile(temp_file) || rename(temp_file.c_str(), share_file.c_str()) != 0) {
+            std::cerr << "[ERROR] Failed to write refreshed shares to: " << share_file << std::endl;
+            return 1;
+        }
+        std::cout << "[SUCCESS] Party " << own.party_id << " applied round '" << subs[0].round << "' from "
+                  << subs.size() << " dealers to " << own.shares.values.size() << " chunks" << std::endl;
+        if (subs.size() < NUM_PARTIES) {
+            std::cout << "[WARNING] Not every party dealt; all parties must apply the same dealers" << std::endl;
+        }
+        std::cout << "[NOTE] VSS commitments from split do not cover refreshed shares; reconstruct without --vss" << std::endl;
+        
+    } else if (command == "server") {
+        if (argc != 5 && argc != 6) {
+            std::cerr << "Usage: " << argv[0] << " server <party_id> <share_file> <port> [tkey_file]" << std::endl;
             return 1;
         }
         
@@ -460,6 +1336,11 @@ int main(int argc, char* argv[]) {
             std::cerr << "[ERROR] Failed to load shares from: " << share_file << std::endl;
             return 1;
         }
+        if (shares.party_id != party_id) {
+            std::cerr << "[ERROR] " << share_file << " holds the shares of Party " << shares.party_id
+                      << ", not Party " << party_id << std::endl;
+            return 1;
+        }
         
         std::cout << "========================================" << std::endl;
         std::cout << "PARTY SHARE SERVER" << std::endl;
@@ -470,6 +1351,16 @@ int main(int argc, char* argv[]) {
         std::cout << "========================================" << std::endl;
         
         PartyShareServer server(port, shares);
+        if (argc == 6) {
+            threshold_rsa::PartyKeyShare exponent_share;
+            if (!exponent_share.loadFromFile(argv[5])) {
+                std::cerr << "[ERROR] Failed to load exponent pieces from: " << argv[5] << std::endl;
+                return 1;
+            }
+            std::cout << "Exponent pieces: " << exponent_share.pieces.size() << " (threshold RSA enabled)" << std::endl;
+            server.setExponentShare(exponent_share);
+        }
+        
         if (!server.start()) {
             return 1;
         }
@@ -483,14 +1374,47 @@ int main(int argc, char* argv[]) {
         }
         
     } else if (command == "reconstruct") {
-        if (argc != 7) {
-            std::cerr << "Usage: " << argv[0] << " reconstruct <share1> <share2> <share3> <public_key.pem> <output.pem>" << std::endl;
+        // Positional: share files, then public key and output; flags anywhere after the command
+        bool deep_check = false;
+        std::string commitments_file;
+        std::string history_file;
+        std::vector<std::string> positional;
+        for (int i = 2; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--deep-check") {
+                deep_check = true;
+            } else if (arg == "--vss" && i + 1 < argc) {
+                commitments_file = argv[++i];
+            } else if (arg == "--history" && i + 1 < argc) {
+                history_file = argv[++i];
+            } else {
+                positional.push_back(arg);
+            }
+        }
+        if (positional.size() < THRESHOLD + 2) {
+            std::cerr << "Usage: " << argv[0] << " reconstruct <share1> <share2> <share3> [share...] <public_key.pem> <output.pem> [--deep-check] [--vss <commitments.vss>] [--history <file>]" << std::endl;
             return 1;
         }
         
-        std::vector<std::string> share_files = {argv[2], argv[3], argv[4]};
-        std::string public_key_path = argv[5];
-        std::string output_path = argv[6];
+        std::vector<std::string> share_files(positional.begin(), positional.end() - 2);
+        std::string public_key_path = positional[positional.size() - 2];
+        std::string output_path = positional.back();
+        rsa_key_utils::KeyCheck check = deep_check ? rsa_key_utils::KeyCheck::Deep
+                                                   : rsa_key_utils::KeyCheck::Fast;
+        
+        // Opt-in: with --history, parties that gave working keys are tried
+        // first if subsets must be retried
+        key_manager.setHistoryFile(history_file);
+        
+        std::string policy = readPolicy(share_files[0]);
+        if (!key_manager.setPolicy(policy)) {
+            std::cerr << "[ERROR] Unknown access policy: " << policy << std::endl;
+            return 1;
+        }
+        if (key_manager.isHierarchical() && !commitments_file.empty()) {
+            std::cerr << "[WARNING] VSS does not cover hierarchical shares; ignoring --vss" << std::endl;
+            commitments_file.clear();
+        }
         
         std::cout << "========================================" << std::endl;
         std::cout << "RSA PRIVATE KEY RECONSTRUCTION" << std::endl;
@@ -510,9 +1434,39 @@ int main(int argc, char* argv[]) {
             }
         }
         
+        // Verify every party against the commitments before any interpolation;
+        // blinding shares sit next to the share files (party_N.share -> party_N.blind)
+        if (!commitments_file.empty()) {
+            vss::Commitments commitments;
+            if (!commitments.loadFromFile(commitments_file)) {
+                std::cerr << "[ERROR] Failed to load VSS commitments from: " << commitments_file << std::endl;
+                return 1;
+            }
+            std::vector<vss::BlindingShares> blinding(share_files.size());
+            for (size_t i = 0; i < share_files.size(); ++i) {
+                std::string blind_file = share_files[i];
+                size_t dot = blind_file.rfind(".share");
+                blind_file = (dot == std::string::npos ? blind_file : blind_file.substr(0, dot)) + ".blind";
+                if (!blinding[i].loadFromFile(blind_file)) {
+                    std::cerr << "[WARNING] No VSS blinding shares at " << blind_file
+                              << "; Party " << participating_parties[i].party_id << " cannot be verified" << std::endl;
+                }
+            }
+            
+            auto start = std::chrono::steady_clock::now();
+            size_t dropped = key_manager.dropInvalidParties(participating_parties, blinding, commitments);
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            std::cout << "[INFO] VSS: " << participating_parties.size() << " parties verified, " << dropped
+                      << " dropped (" << ms << " ms)" << std::endl;
+            if (participating_parties.size() < THRESHOLD) {
+                std::cerr << "[ERROR] Fewer than " << THRESHOLD << " verified parties; not reconstructing" << std::endl;
+                return 1;
+            }
+        }
+        
         // Reconstruct private key
-        RSA* rsa_reconstructed = key_manager.reconstructPrivateKey(participating_parties, public_key_path);
-        if (!rsa_reconstructed) {
+        EVP_PKEY* key_reconstructed = key_manager.reconstructPrivateKey(participating_parties, public_key_path, check);
+        if (!key_reconstructed) {
             std::cerr << "[ERROR] Failed to reconstruct private key" << std::endl;
             return 1;
         }
@@ -521,11 +1475,11 @@ int main(int argc, char* argv[]) {
         FILE* fp = fopen(output_path.c_str(), "w");
         if (!fp) {
             std::cerr << "[ERROR] Failed to open output file" << std::endl;
-            RSA_free(rsa_reconstructed);
+            EVP_PKEY_free(key_reconstructed);
             return 1;
         }
         
-        if (PEM_write_RSAPrivateKey(fp, rsa_reconstructed, nullptr, nullptr, 0, nullptr, nullptr)) {
+        if (PEM_write_PrivateKey(fp, key_reconstructed, nullptr, nullptr, 0, nullptr, nullptr)) {
             std::cout << "[SUCCESS] Reconstructed private key saved to: " << output_path << std::endl;
             std::cout << "\n[SECURITY] Key will be destroyed from memory immediately" << std::endl;
         } else {
@@ -533,7 +1487,7 @@ int main(int argc, char* argv[]) {
         }
         
         fclose(fp);
-        RSA_free(rsa_reconstructed);  // Secure erasure
+        EVP_PKEY_free(key_reconstructed);  // Secure erasure
         
     } else {
         std::cerr << "Unknown command: " << command << std::endl;
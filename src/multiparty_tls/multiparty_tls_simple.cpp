@@ -10,6 +10,10 @@
  */
 
 #include "shamir_secret_sharing.hpp"
+#include "rsa_key_utils.hpp"
+#include "secure_arena.hpp"
+#include <openssl/core_names.h>
+#include <openssl/evp.h>
 #include <openssl/rsa.h>
 #include <openssl/pem.h>
 #include <openssl/err.h>
@@ -53,7 +57,7 @@ void print_hex(const std::string& label, const unsigned char* data, size_t len)
 struct Party {
     size_t id;
     std::string name;
-    std::vector<ShamirSecretSharing::Share> key_shares;  // Shares of RSA private key chunks
+    ShamirSecretSharing::PartyShares key_shares;  // Shares of RSA private key chunks, one value per chunk
     
     Party(size_t id, const std::string& name) : id(id), name(name) {}
 };
@@ -70,10 +74,10 @@ public:
     static constexpr size_t CHUNK_BITS = 61;
     static constexpr uint64_t PRIME = 2305843009213693951ULL;  // 2^61 - 1
     
-    DistributedTLSServer() : rsa(nullptr), sss(nullptr) {}
+    DistributedTLSServer() : pkey(nullptr), sss(nullptr) {}
     
     ~DistributedTLSServer() {
-        if (rsa) RSA_free(rsa);
+        if (pkey) EVP_PKEY_free(pkey);
     }
     
     // Phase 1: Generate and distribute keys
@@ -82,25 +86,29 @@ public:
         
         // Generate RSA key pair
         print_step(1, "Generate RSA Key Pair");
-        rsa = RSA_new();
-        BIGNUM* e = BN_new();
-        BN_set_word(e, RSA_F4);
-        
         std::cout << "Generating " << RSA_BITS << "-bit RSA key pair..." << std::endl;
-        if (RSA_generate_key_ex(rsa, RSA_BITS, e, nullptr) != 1) {
-            BN_free(e);
+        pkey = rsa_key_utils::generateKey(RSA_BITS);
+        if (!pkey) {
             return false;
         }
-        BN_free(e);
         std::cout << "✓ RSA key pair generated" << std::endl;
         
-        // Get private key components
-        const BIGNUM *n, *e_pub, *d_const;
-        RSA_get0_key(rsa, &n, &e_pub, &d_const);
+        // Get key components through OSSL_PARAM export
+        BIGNUM* n = rsa_key_utils::getParam(pkey, OSSL_PKEY_PARAM_RSA_N);
+        BIGNUM* e_pub = rsa_key_utils::getParam(pkey, OSSL_PKEY_PARAM_RSA_E);
+        BIGNUM* d = rsa_key_utils::getParam(pkey, OSSL_PKEY_PARAM_RSA_D);
+        if (!n || !e_pub || !d) {
+            BN_free(n);
+            BN_free(e_pub);
+            BN_clear_free(d);
+            return false;
+        }
         
         std::cout << "  Modulus (n): " << BN_num_bits(n) << " bits" << std::endl;
         std::cout << "  Public exponent (e): " << BN_get_word(e_pub) << std::endl;
-        std::cout << "  Private exponent (d): " << BN_num_bits(d_const) << " bits" << std::endl;
+        std::cout << "  Private exponent (d): " << BN_num_bits(d) << " bits" << std::endl;
+        BN_free(n);
+        BN_free(e_pub);
         
         // Split private key
         print_step(2, "Split Private Key using Shamir's Secret Sharing");
@@ -109,16 +117,14 @@ public:
         // Initialize SSS
         sss = std::make_unique<ShamirSecretSharing>(THRESHOLD, NUM_PARTIES, PRIME);
         
-        // Copy d for manipulation
-        BIGNUM* d = BN_dup(d_const);
         int num_bits = BN_num_bits(d);
         size_t num_chunks = (num_bits + CHUNK_BITS - 1) / CHUNK_BITS;
         
         std::cout << "Splitting " << num_bits << "-bit key into " << num_chunks 
                   << " chunks of " << CHUNK_BITS << " bits each" << std::endl;
         
-        // Split each chunk
-        std::vector<std::vector<ShamirSecretSharing::Share>> all_shares(num_chunks);
+        // Extract each chunk
+        secure_arena::SecureVector<uint64_t> chunks(num_chunks);
         
         for (size_t chunk_idx = 0; chunk_idx < num_chunks; ++chunk_idx) {
             // Extract chunk value
@@ -129,15 +135,9 @@ public:
             // Right shift to get the chunk
             BN_rshift(temp, temp, chunk_idx * CHUNK_BITS);
             
-            // Mask to get only CHUNK_BITS
-            BIGNUM* mask = BN_new();
-            BN_one(mask);
-            BN_lshift(mask, mask, CHUNK_BITS);
-            BN_sub_word(mask, 1);
-            
-            BN_CTX* ctx = BN_CTX_new();
-            BN_mod(chunk_bn, temp, mask, ctx);
-            BN_CTX_free(ctx);
+            // Keep only the low CHUNK_BITS
+            BN_copy(chunk_bn, temp);
+            BN_mask_bits(chunk_bn, CHUNK_BITS);
             
             // Convert to uint64_t
             uint64_t chunk_value = 0;
@@ -150,22 +150,19 @@ public:
                 chunk_value = chunk_value % PRIME;
             }
             
-            // Create shares
-            all_shares[chunk_idx] = sss->split(chunk_value);
+            chunks[chunk_idx] = chunk_value;
             
             BN_free(chunk_bn);
             BN_free(temp);
-            BN_free(mask);
         }
         
         BN_clear_free(d);
         
-        // Distribute to parties
+        // Split every chunk straight into per-party arrays and distribute them
+        auto party_shares = sss->splitChunks(chunks.data(), chunks.size());
         print_step(3, "Distribute Shares to Parties");
         for (size_t party_idx = 0; party_idx < NUM_PARTIES; ++party_idx) {
-            for (size_t chunk_idx = 0; chunk_idx < num_chunks; ++chunk_idx) {
-                parties[party_idx].key_shares.push_back(all_shares[chunk_idx][party_idx]);
-            }
+            parties[party_idx].key_shares = std::move(party_shares[party_idx]);
             std::cout << "  Party " << (party_idx + 1) << " (" << parties[party_idx].name 
                       << "): received " << num_chunks << " shares" << std::endl;
         }
@@ -180,8 +177,8 @@ public:
     }
     
     // Get public key for client
-    RSA* getPublicKey() const {
-        return rsa;
+    EVP_PKEY* getPublicKey() const {
+        return pkey;
     }
     
     size_t getNumKeyChunks() const {
@@ -189,7 +186,7 @@ public:
     }
     
 private:
-    RSA* rsa;
+    EVP_PKEY* pkey;
     std::unique_ptr<ShamirSecretSharing> sss;
     size_t num_key_chunks;
 };
@@ -201,7 +198,7 @@ private:
 class TLSClient {
 public:
     // Phase 2: Client initiates handshake
-    bool initiateHandshake(RSA* server_public_key, std::vector<uint8_t>& encrypted_pms) {
+    bool initiateHandshake(EVP_PKEY* server_public_key, std::vector<uint8_t>& encrypted_pms) {
         print_section("PHASE 2: TLS HANDSHAKE - CLIENT HELLO & KEY EXCHANGE");
         
         print_step(1, "Client Generates Random Values");
@@ -222,17 +219,18 @@ public:
         print_step(2, "Client Encrypts Pre-Master Secret");
         std::cout << "Encrypting with server's RSA public key (RSA-OAEP)..." << std::endl;
         
-        encrypted_pms.resize(RSA_size(server_public_key));
+        EVP_PKEY_CTX* ctx = EVP_PKEY_CTX_new_from_pkey(nullptr, server_public_key, nullptr);
+        size_t encrypted_len = EVP_PKEY_get_size(server_public_key);
+        encrypted_pms.resize(encrypted_len);
         
-        int encrypted_len = RSA_public_encrypt(
-            pre_master_secret.size(),
-            pre_master_secret.data(),
-            encrypted_pms.data(),
-            server_public_key,
-            RSA_PKCS1_OAEP_PADDING
-        );
+        bool ok = ctx &&
+                  EVP_PKEY_encrypt_init(ctx) > 0 &&
+                  EVP_PKEY_CTX_set_rsa_padding(ctx, RSA_PKCS1_OAEP_PADDING) > 0 &&
+                  EVP_PKEY_encrypt(ctx, encrypted_pms.data(), &encrypted_len,
+                                   pre_master_secret.data(), pre_master_secret.size()) > 0;
+        EVP_PKEY_CTX_free(ctx);
         
-        if (encrypted_len == -1) {
+        if (!ok) {
             std::cerr << "Encryption failed!" << std::endl;
             return false;
         }
@@ -261,7 +259,7 @@ bool collaborativeDecrypt(
     const std::vector<uint8_t>& encrypted_pms,
     const std::vector<Party>& participating_parties,
     size_t num_chunks,
-    RSA* server_rsa,
+    EVP_PKEY* server_key,
     std::vector<uint8_t>& decrypted_pms)
 {
     print_section("PHASE 3: MULTI-PARTY COLLABORATIVE DECRYPTION");
@@ -279,28 +277,29 @@ bool collaborativeDecrypt(
     // Initialize SSS for reconstruction
     ShamirSecretSharing sss(3, 5, 2305843009213693951ULL);
     
-    // Get original private key for verification
-    const BIGNUM *n, *e, *d_original;
-    RSA_get0_key(server_rsa, &n, &e, &d_original);
+    // Get original key components for verification
+    BIGNUM* n = rsa_key_utils::getParam(server_key, OSSL_PKEY_PARAM_RSA_N);
+    BIGNUM* e = rsa_key_utils::getParam(server_key, OSSL_PKEY_PARAM_RSA_E);
+    BIGNUM* d_original = rsa_key_utils::getParam(server_key, OSSL_PKEY_PARAM_RSA_D);
     
     // Reconstruct private exponent
     BIGNUM* reconstructed_d = BN_new();
     BN_zero(reconstructed_d);
     
+    // All chunks at once, one party's share array at a time
+    std::vector<const ShamirSecretSharing::PartyShares*> party_shares;
+    for (const auto& party : participating_parties) {
+        party_shares.push_back(&party.key_shares);
+    }
+    secure_arena::SecureVector<uint64_t> chunk_values(num_chunks);
+    sss.reconstructChunks(party_shares, chunk_values.data());
     for (size_t chunk_idx = 0; chunk_idx < num_chunks; ++chunk_idx) {
-        // Gather shares from participating parties
-        std::vector<ShamirSecretSharing::Share> chunk_shares;
-        for (const auto& party : participating_parties) {
-            chunk_shares.push_back(party.key_shares[chunk_idx]);
-        }
-        
-        // Reconstruct chunk value
-        uint64_t chunk_value = sss.reconstruct(chunk_shares);
+        uint64_t chunk_value = chunk_values[chunk_idx];
         
-        // Accumulate into full d
-        BN_lshift(reconstructed_d, reconstructed_d, 61);
+        // Accumulate into full d (chunk 0 holds the least significant bits)
         BIGNUM* chunk_bn = BN_new();
         BN_set_word(chunk_bn, chunk_value);
+        BN_lshift(chunk_bn, chunk_bn, chunk_idx * DistributedTLSServer::CHUNK_BITS);
         BN_add(reconstructed_d, reconstructed_d, chunk_bn);
         BN_free(chunk_bn);
     }
@@ -313,34 +312,46 @@ bool collaborativeDecrypt(
     } else {
         std::cout << "✗ WARNING: Reconstructed key does NOT match!" << std::endl;
     }
+    BN_clear_free(d_original);
     
     print_step(3, "Decrypt Pre-Master Secret");
     
-    // Create temporary RSA with reconstructed key
-    RSA* temp_rsa = RSAPrivateKey_dup(server_rsa);
+    // Import (n, e) and the reconstructed d through OSSL_PARAM; p, q and the
+    // CRT exponents are recovered so the decryption takes the CRT path
+    auto crt_start = std::chrono::high_resolution_clock::now();
+    bool has_crt = false;
+    EVP_PKEY* temp_key = rsa_key_utils::importPrivateKey(n, e, reconstructed_d, &has_crt);
+    auto crt_end = std::chrono::high_resolution_clock::now();
+    BN_free(n);
+    BN_free(e);
+    
+    if (has_crt) {
+        std::cout << "✓ CRT parameters recovered from (n, e, d) in "
+                  << std::chrono::duration<double, std::milli>(crt_end - crt_start).count()
+                  << " ms" << std::endl;
+    } else {
+        std::cout << "✗ WARNING: CRT recovery failed, decrypting with d only" << std::endl;
+    }
     
-    // Decrypt
-    decrypted_pms.resize(RSA_size(temp_rsa));
-    int decrypted_len = RSA_private_decrypt(
-        encrypted_pms.size(),
-        encrypted_pms.data(),
-        decrypted_pms.data(),
-        temp_rsa,
-        RSA_PKCS1_OAEP_PADDING
-    );
+    // Decrypt through a provider-native EVP_PKEY_CTX
+    bool decrypted = false;
+    if (temp_key) {
+        rsa_key_utils::PrivateKeyDecryptor decryptor(temp_key, RSA_PKCS1_OAEP_PADDING);
+        decrypted = decryptor.decrypt(encrypted_pms.data(), encrypted_pms.size(), decrypted_pms);
+    }
     
     print_step(4, "Destroy Reconstructed Private Key");
     std::cout << "Securely erasing reconstructed private key from memory..." << std::endl;
     BN_clear_free(reconstructed_d);
-    RSA_free(temp_rsa);
+    EVP_PKEY_free(temp_key);  // Provider key data is cleansed on free
     std::cout << "✓ Private key destroyed (exists only during decryption)" << std::endl;
     
-    if (decrypted_len == -1) {
+    if (!decrypted) {
         std::cerr << "✗ Decryption failed!" << std::endl;
         return false;
     }
     
-    decrypted_pms.resize(decrypted_len);
+    size_t decrypted_len = decrypted_pms.size();
     print_hex("Decrypted PMS", decrypted_pms.data(), decrypted_len);
     std::cout << "✓ Pre-Master Secret decrypted successfully!" << std::endl;
     
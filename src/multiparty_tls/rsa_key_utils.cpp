@@ -0,0 +1,311 @@
+#include "rsa_key_utils.hpp"
+#include <openssl/core_names.h>
+#include <openssl/param_build.h>
+#include <openssl/pem.h>
+#include <openssl/rsa.h>
+#include <cstdio>
+
+namespace rsa_key_utils {
+
+bool verifyRoundTrip(const BIGNUM* n, const BIGNUM* e, const BIGNUM* d) {
+    if (!n || !e || !d) {
+        return false;
+    }
+
+    BN_CTX* ctx = BN_CTX_new();
+    if (!ctx) {
+        return false;
+    }
+
+    BN_CTX_start(ctx);
+    BIGNUM* m = BN_CTX_get(ctx);
+    BIGNUM* c = BN_CTX_get(ctx);
+    BIGNUM* m2 = BN_CTX_get(ctx);
+    BIGNUM* range = BN_CTX_get(ctx);
+
+    bool ok = false;
+    if (m2 && BN_copy(range, n) && BN_sub_word(range, 3) &&
+        BN_rand_range(m, range) && BN_add_word(m, 2)) {      // m in [2, n-2]
+
+        // c = m^e mod n (cheap: e is small), m2 = c^d mod n
+        ok = BN_mod_exp(c, m, e, n, ctx) == 1 &&
+             BN_mod_exp_mont_consttime(m2, c, d, n, ctx, nullptr) == 1 &&
+             BN_cmp(m, m2) == 0;
+    }
+
+    BN_clear(m);
+    BN_clear(m2);
+    BN_CTX_end(ctx);
+    BN_CTX_free(ctx);
+    return ok;
+}
+
+RoundTripCheck::RoundTripCheck(const BIGNUM* n, const BIGNUM* e)
+    : ctx_(BN_CTX_new()), mont_(BN_MONT_CTX_new()), n_(BN_dup(n)), m_(BN_new()), c_(BN_new()),
+      m2_(BN_new()) {
+    BIGNUM* range = BN_new();
+    bool ok = ctx_ && mont_ && n_ && m_ && c_ && m2_ && range && e &&
+              BN_MONT_CTX_set(mont_, n_, ctx_) == 1 &&
+              BN_copy(range, n_) && BN_sub_word(range, 3) &&
+              BN_rand_range(m_, range) && BN_add_word(m_, 2) &&      // m in [2, n-2]
+              BN_mod_exp_mont(c_, m_, e, n_, ctx_, mont_) == 1;
+    BN_free(range);
+    if (!ok) {
+        BN_MONT_CTX_free(mont_);
+        mont_ = nullptr;
+    }
+}
+
+RoundTripCheck::~RoundTripCheck() {
+    BN_MONT_CTX_free(mont_);
+    BN_clear_free(m2_);
+    BN_free(c_);
+    BN_clear_free(m_);
+    BN_free(n_);
+    BN_CTX_free(ctx_);
+}
+
+bool RoundTripCheck::matches(const BIGNUM* d) {
+    if (!mont_ || !d) {
+        return false;
+    }
+    bool ok = BN_mod_exp_mont_consttime(m2_, c_, d, n_, ctx_, mont_) == 1 && BN_cmp(m_, m2_) == 0;
+    BN_clear(m2_);
+    return ok;
+}
+
+bool factorModulus(const BIGNUM* n, const BIGNUM* e, const BIGNUM* d,
+                   BIGNUM* p, BIGNUM* q) {
+    static constexpr int MAX_ATTEMPTS = 64;
+
+    BN_CTX* ctx = BN_CTX_new();
+    if (!ctx) {
+        return false;
+    }
+
+    BN_CTX_start(ctx);
+    BIGNUM* r = BN_CTX_get(ctx);
+    BIGNUM* g = BN_CTX_get(ctx);
+    BIGNUM* y = BN_CTX_get(ctx);
+    BIGNUM* x = BN_CTX_get(ctx);
+    BIGNUM* n_minus_1 = BN_CTX_get(ctx);
+    BIGNUM* range = BN_CTX_get(ctx);
+
+    bool found = false;
+    if (range && BN_mul(r, e, d, ctx) && BN_sub_word(r, 1) &&
+        BN_copy(n_minus_1, n) && BN_sub_word(n_minus_1, 1) &&
+        BN_copy(range, n) && BN_sub_word(range, 3) && !BN_is_odd(r)) {
+
+        // e*d - 1 = 2^s * r with r odd
+        int s = 0;
+        while (!BN_is_odd(r)) {
+            BN_rshift1(r, r);
+            ++s;
+        }
+
+        for (int attempt = 0; attempt < MAX_ATTEMPTS && !found; ++attempt) {
+            if (!BN_rand_range(g, range) || !BN_add_word(g, 2) ||
+                !BN_mod_exp(y, g, r, n, ctx)) {
+                break;
+            }
+            if (BN_is_one(y) || BN_cmp(y, n_minus_1) == 0) {
+                continue;
+            }
+
+            for (int i = 0; i < s; ++i) {
+                if (!BN_mod_sqr(x, y, n, ctx)) {
+                    break;
+                }
+                if (BN_is_one(x)) {
+                    // y is a non-trivial square root of 1: gcd(y - 1, n) is a factor
+                    found = BN_sub_word(y, 1) && BN_gcd(p, y, n, ctx) &&
+                            BN_div(q, nullptr, n, p, ctx);
+                    break;
+                }
+                if (BN_cmp(x, n_minus_1) == 0) {
+                    break;
+                }
+                BN_copy(y, x);
+            }
+        }
+
+        if (found && BN_cmp(p, q) < 0) {
+            BN_swap(p, q);
+        }
+    }
+
+    BN_clear(g);
+    BN_clear(y);
+    BN_clear(x);
+    BN_CTX_end(ctx);
+    BN_CTX_free(ctx);
+    return found;
+}
+
+bool deepCheck(EVP_PKEY* pkey) {
+    EVP_PKEY_CTX* ctx = EVP_PKEY_CTX_new_from_pkey(nullptr, pkey, nullptr);
+    if (!ctx) {
+        return false;
+    }
+    bool ok = EVP_PKEY_check(ctx) == 1;
+    EVP_PKEY_CTX_free(ctx);
+    return ok;
+}
+
+EVP_PKEY* generateKey(unsigned int bits) {
+    EVP_PKEY_CTX* ctx = EVP_PKEY_CTX_new_from_name(nullptr, "RSA", nullptr);
+    if (!ctx) {
+        return nullptr;
+    }
+
+    EVP_PKEY* pkey = nullptr;
+    if (EVP_PKEY_keygen_init(ctx) <= 0 ||
+        EVP_PKEY_CTX_set_rsa_keygen_bits(ctx, static_cast<int>(bits)) <= 0 ||
+        EVP_PKEY_generate(ctx, &pkey) <= 0) {
+        pkey = nullptr;
+    }
+
+    EVP_PKEY_CTX_free(ctx);
+    return pkey;
+}
+
+EVP_PKEY* loadPrivateKey(const std::string& path) {
+    FILE* fp = fopen(path.c_str(), "r");
+    if (!fp) {
+        return nullptr;
+    }
+    EVP_PKEY* pkey = PEM_read_PrivateKey(fp, nullptr, nullptr, nullptr);
+    fclose(fp);
+    return pkey;
+}
+
+EVP_PKEY* loadPublicKey(const std::string& path) {
+    FILE* fp = fopen(path.c_str(), "r");
+    if (!fp) {
+        return nullptr;
+    }
+    EVP_PKEY* pkey = PEM_read_PUBKEY(fp, nullptr, nullptr, nullptr);
+    fclose(fp);
+    return pkey;
+}
+
+X509* selfSignedCertificate(EVP_PKEY* pkey, const std::string& common_name) {
+    X509* x509 = X509_new();
+    if (!x509) {
+        return nullptr;
+    }
+
+    X509_NAME* name = X509_get_subject_name(x509);
+    bool ok = X509_set_version(x509, 2) &&
+              ASN1_INTEGER_set(X509_get_serialNumber(x509), 1) &&
+              X509_gmtime_adj(X509_getm_notBefore(x509), 0) &&
+              X509_gmtime_adj(X509_getm_notAfter(x509), 31536000L) &&
+              X509_set_pubkey(x509, pkey) &&
+              X509_NAME_add_entry_by_txt(name, "O", MBSTRING_ASC,
+                                         reinterpret_cast<const unsigned char*>("MultiPartyTLS"), -1, -1, 0) &&
+              X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC,
+                                         reinterpret_cast<const unsigned char*>(common_name.c_str()), -1, -1, 0) &&
+              X509_set_issuer_name(x509, name) &&
+              X509_sign(x509, pkey, EVP_sha256()) > 0;
+
+    if (!ok) {
+        X509_free(x509);
+        return nullptr;
+    }
+    return x509;
+}
+
+BIGNUM* getParam(const EVP_PKEY* pkey, const char* name) {
+    BIGNUM* value = nullptr;
+    if (EVP_PKEY_get_bn_param(pkey, name, &value) != 1) {
+        return nullptr;
+    }
+    return value;
+}
+
+EVP_PKEY* importPrivateKey(const BIGNUM* n, const BIGNUM* e, const BIGNUM* d,
+                           bool* has_crt) {
+    BN_CTX* bn_ctx = BN_CTX_new();
+    BIGNUM* p = BN_secure_new();
+    BIGNUM* q = BN_secure_new();
+    BIGNUM* dmp1 = BN_secure_new();
+    BIGNUM* dmq1 = BN_secure_new();
+    BIGNUM* iqmp = BN_secure_new();
+    BIGNUM* tmp = BN_secure_new();
+    OSSL_PARAM_BLD* bld = OSSL_PARAM_BLD_new();
+
+    // dP = d mod (p-1), dQ = d mod (q-1), qInv = q^-1 mod p
+    bool crt = bn_ctx && p && q && dmp1 && dmq1 && iqmp && tmp &&
+               factorModulus(n, e, d, p, q) &&
+               BN_sub(tmp, p, BN_value_one()) && BN_mod(dmp1, d, tmp, bn_ctx) &&
+               BN_sub(tmp, q, BN_value_one()) && BN_mod(dmq1, d, tmp, bn_ctx) &&
+               BN_mod_inverse(iqmp, q, p, bn_ctx) != nullptr;
+
+    bool built = bld &&
+                 OSSL_PARAM_BLD_push_BN(bld, OSSL_PKEY_PARAM_RSA_N, n) &&
+                 OSSL_PARAM_BLD_push_BN(bld, OSSL_PKEY_PARAM_RSA_E, e) &&
+                 OSSL_PARAM_BLD_push_BN(bld, OSSL_PKEY_PARAM_RSA_D, d);
+    if (built && crt) {
+        built = OSSL_PARAM_BLD_push_BN(bld, OSSL_PKEY_PARAM_RSA_FACTOR1, p) &&
+                OSSL_PARAM_BLD_push_BN(bld, OSSL_PKEY_PARAM_RSA_FACTOR2, q) &&
+                OSSL_PARAM_BLD_push_BN(bld, OSSL_PKEY_PARAM_RSA_EXPONENT1, dmp1) &&
+                OSSL_PARAM_BLD_push_BN(bld, OSSL_PKEY_PARAM_RSA_EXPONENT2, dmq1) &&
+                OSSL_PARAM_BLD_push_BN(bld, OSSL_PKEY_PARAM_RSA_COEFFICIENT1, iqmp);
+    }
+
+    EVP_PKEY* pkey = nullptr;
+    OSSL_PARAM* params = built ? OSSL_PARAM_BLD_to_param(bld) : nullptr;
+    EVP_PKEY_CTX* ctx = params ? EVP_PKEY_CTX_new_from_name(nullptr, "RSA", nullptr) : nullptr;
+    if (!ctx || EVP_PKEY_fromdata_init(ctx) <= 0 ||
+        EVP_PKEY_fromdata(ctx, &pkey, EVP_PKEY_KEYPAIR, params) <= 0) {
+        pkey = nullptr;
+    }
+
+    if (has_crt) {
+        *has_crt = pkey != nullptr && crt;
+    }
+
+    EVP_PKEY_CTX_free(ctx);
+    OSSL_PARAM_free(params);
+    OSSL_PARAM_BLD_free(bld);
+    BN_clear_free(p);
+    BN_clear_free(q);
+    BN_clear_free(dmp1);
+    BN_clear_free(dmq1);
+    BN_clear_free(iqmp);
+    BN_clear_free(tmp);
+    BN_CTX_free(bn_ctx);
+    return pkey;
+}
+
+PrivateKeyDecryptor::PrivateKeyDecryptor(EVP_PKEY* pkey, int padding)
+    : ctx_(EVP_PKEY_CTX_new_from_pkey(nullptr, pkey, nullptr)) {
+    if (ctx_ && (EVP_PKEY_decrypt_init(ctx_) <= 0 ||
+                 EVP_PKEY_CTX_set_rsa_padding(ctx_, padding) <= 0)) {
+        EVP_PKEY_CTX_free(ctx_);
+        ctx_ = nullptr;
+    }
+}
+
+PrivateKeyDecryptor::~PrivateKeyDecryptor() {
+    EVP_PKEY_CTX_free(ctx_);
+}
+
+bool PrivateKeyDecryptor::decrypt(const uint8_t* in, size_t in_len, std::vector<uint8_t>& out) {
+    if (!ctx_) {
+        return false;
+    }
+
+    size_t out_len = 0;
+    if (EVP_PKEY_decrypt(ctx_, nullptr, &out_len, in, in_len) <= 0) {
+        return false;
+    }
+    out.resize(out_len);
+    if (EVP_PKEY_decrypt(ctx_, out.data(), &out_len, in, in_len) <= 0) {
+        return false;
+    }
+    out.resize(out_len);
+    return true;
+}
+
+} // namespace rsa_key_utils
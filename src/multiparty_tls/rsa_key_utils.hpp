@@ -0,0 +1,149 @@
+#ifndef RSA_KEY_UTILS_HPP
+#define RSA_KEY_UTILS_HPP
+
+#include <openssl/bn.h>
+#include <openssl/evp.h>
+#include <openssl/x509.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Helpers for RSA keys rebuilt from Shamir-shared private exponents
+ *
+ * Everything goes through EVP_PKEY and OSSL_PARAM so keys stay native to
+ * the OpenSSL 3 provider (no legacy RSA* conversion on load or use).
+ */
+namespace rsa_key_utils {
+
+/**
+ * Validation applied to a freshly reconstructed key
+ *   Fast: one encrypt/decrypt round-trip on a random value (d is consistent with n, e)
+ *   Deep: Fast plus EVP_PKEY_check (primality of p, q; needs the CRT factors)
+ */
+enum class KeyCheck {
+    Fast,
+    Deep
+};
+
+/**
+ * Verify that d inverts e modulo n: m == (m^e)^d mod n for random m
+ * @return true if the round-trip recovers m
+ */
+bool verifyRoundTrip(const BIGNUM* n, const BIGNUM* e, const BIGNUM* d);
+
+/**
+ * verifyRoundTrip for many candidate exponents against one (n, e)
+ *
+ * The test message m, its encryption c = m^e and the Montgomery context for
+ * n are set up once; each candidate then costs a single c^d mod n.
+ */
+class RoundTripCheck {
+public:
+    RoundTripCheck(const BIGNUM* n, const BIGNUM* e);
+    ~RoundTripCheck();
+
+    RoundTripCheck(const RoundTripCheck&) = delete;
+    RoundTripCheck& operator=(const RoundTripCheck&) = delete;
+
+    bool valid() const { return mont_ != nullptr; }
+
+    /**
+     * @return true if c^d mod n recovers the test message
+     */
+    bool matches(const BIGNUM* d);
+
+private:
+    BN_CTX* ctx_;
+    BN_MONT_CTX* mont_;
+    BIGNUM* n_;
+    BIGNUM* m_;
+    BIGNUM* c_;
+    BIGNUM* m2_;
+};
+
+/**
+ * Full provider key validation (the EVP equivalent of RSA_check_key)
+ */
+bool deepCheck(EVP_PKEY* pkey);
+
+/**
+ * Factor n given a matching (e, d) pair
+ *
+ * Standard probabilistic method: write e*d - 1 = 2^s * r, then for random g
+ * the sequence g^r, g^2r, ... hits a non-trivial square root of 1 (and
+ * therefore a factor via gcd) with probability >= 1/2 per attempt.
+ * @param p, q Receive the prime factors (p > q)
+ * @return false if d does not match (n, e) or no factor was found
+ */
+bool factorModulus(const BIGNUM* n, const BIGNUM* e, const BIGNUM* d,
+                   BIGNUM* p, BIGNUM* q);
+
+/**
+ * Generate an RSA key pair (e = 65537) through the provider keygen
+ * @return New key, or nullptr on failure
+ */
+EVP_PKEY* generateKey(unsigned int bits);
+
+/**
+ * Load a PEM private key / public key (SubjectPublicKeyInfo)
+ * @return New key, or nullptr on failure
+ */
+EVP_PKEY* loadPrivateKey(const std::string& path);
+EVP_PKEY* loadPublicKey(const std::string& path);
+
+/**
+ * Self-signed X.509v3 certificate for test servers (SHA-256, valid one year)
+ * @param pkey Signing key; only its public half ends up in the certificate
+ * @return New certificate, or nullptr on failure
+ */
+X509* selfSignedCertificate(EVP_PKEY* pkey, const std::string& common_name);
+
+/**
+ * Export one RSA component through OSSL_PARAM
+ * @param name OSSL_PKEY_PARAM_RSA_N, OSSL_PKEY_PARAM_RSA_E, OSSL_PKEY_PARAM_RSA_D, ...
+ * @return New BIGNUM owned by the caller (BN_clear_free for private values)
+ */
+BIGNUM* getParam(const EVP_PKEY* pkey, const char* name);
+
+/**
+ * Import (n, e, d) as an RSA key pair through EVP_PKEY_fromdata
+ *
+ * p, q, dP, dQ and qInv are recovered with factorModulus and imported too,
+ * so private operations on the result take the CRT path (~3-4x faster).
+ * @param has_crt Optional; set to whether the CRT parameters were recovered
+ * @return New key, or nullptr on failure
+ */
+EVP_PKEY* importPrivateKey(const BIGNUM* n, const BIGNUM* e, const BIGNUM* d,
+                           bool* has_crt = nullptr);
+
+/**
+ * RSA decryption through a cached EVP_PKEY_CTX
+ *
+ * The context is initialised once (operation, padding) and reused for
+ * every call, so bulk decryption pays no per-message setup.
+ */
+class PrivateKeyDecryptor {
+public:
+    PrivateKeyDecryptor(EVP_PKEY* pkey, int padding);
+    ~PrivateKeyDecryptor();
+
+    PrivateKeyDecryptor(const PrivateKeyDecryptor&) = delete;
+    PrivateKeyDecryptor& operator=(const PrivateKeyDecryptor&) = delete;
+
+    bool valid() const { return ctx_ != nullptr; }
+
+    /**
+     * Decrypt one ciphertext
+     * @param out Resized to the plaintext length
+     * @return false on padding or key errors
+     */
+    bool decrypt(const uint8_t* in, size_t in_len, std::vector<uint8_t>& out);
+
+private:
+    EVP_PKEY_CTX* ctx_;
+};
+
+} // namespace rsa_key_utils
+
+#endif // RSA_KEY_UTILS_HPP
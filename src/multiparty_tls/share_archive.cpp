@@ -0,0 +1,196 @@
+#include "share_archive.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace share_archive {
+
+namespace {
+
+const char HEADER_MAGIC[8] = {'M', 'P', 'S', 'H', 'A', 'R', 'C', '2'};
+const char FOOTER_MAGIC[8] = {'M', 'P', 'S', 'H', 'I', 'D', 'X', '1'};
+const uint64_t FOOTER_SIZE = 2 * sizeof(uint64_t) + sizeof(FOOTER_MAGIC);
+
+} // namespace
+
+// ============================================================================
+// Writer
+// ============================================================================
+
+Writer::~Writer() {
+    if (file_) {
+        fclose(file_);   // Unfinished: no footer, so readers reject it
+    }
+}
+
+bool Writer::open(const std::string& path, uint64_t party_id, const std::string& party_name) {
+    if (file_) {
+        return false;
+    }
+    file_ = fopen(path.c_str(), "wb");
+    if (!file_) {
+        return false;
+    }
+    buffer_.resize(BUFFER_SIZE);
+    setvbuf(file_, buffer_.data(), _IOFBF, buffer_.size());
+
+    ok_ = true;
+    party_id_ = party_id;
+    offset_ = 0;
+    index_.clear();
+    names_.clear();
+    put(HEADER_MAGIC, sizeof(HEADER_MAGIC));
+    putWord(party_id);
+    putString(party_name);
+    return ok_;
+}
+
+void Writer::put(const void* data, size_t size) {
+    if (ok_ && fwrite(data, 1, size, file_) != size) {
+        ok_ = false;
+    }
+    offset_ += size;
+}
+
+void Writer::putString(const std::string& s) {
+    putWord(s.size());
+    put(s.data(), s.size());
+}
+
+bool Writer::append(const std::string& key_name, const Shares& shares) {
+    if (!file_ || shares.id != party_id_ || !names_.emplace(key_name, true).second) {
+        return false;
+    }
+    index_.emplace_back(key_name, offset_);
+    putString(key_name);
+    putWord(shares.values.size());
+    put(shares.values.data(), shares.values.size() * sizeof(uint64_t));
+    return ok_;
+}
+
+bool Writer::close() {
+    if (!file_) {
+        return false;
+    }
+    uint64_t index_offset = offset_;
+    for (const auto& [name, offset] : index_) {
+        putString(name);
+        putWord(offset);
+    }
+    putWord(index_offset);
+    putWord(index_.size());
+    put(FOOTER_MAGIC, sizeof(FOOTER_MAGIC));
+
+    bool ok = ok_ && fflush(file_) == 0;
+    ok = fclose(file_) == 0 && ok;
+    file_ = nullptr;
+    return ok;
+}
+
+// ============================================================================
+// Reader
+// ============================================================================
+
+Reader::~Reader() {
+    if (file_) {
+        fclose(file_);
+    }
+}
+
+bool Reader::getWord(uint64_t& value) {
+    return fread(&value, sizeof(value), 1, file_) == 1;
+}
+
+bool Reader::getString(std::string& s, uint64_t limit) {
+    uint64_t length;
+    if (!getWord(length) || length > limit) {
+        return false;
+    }
+    s.resize(length);
+    return length == 0 || fread(&s[0], 1, length, file_) == length;
+}
+
+bool Reader::open(const std::string& path) {
+    if (file_) {
+        fclose(file_);
+    }
+    offsets_.clear();
+    order_.clear();
+    file_ = fopen(path.c_str(), "rb");
+    if (!file_) {
+        return false;
+    }
+
+    // Footer first: an archive without one was never closed
+    char magic[8];
+    uint64_t count;
+    if (fseeko(file_, 0, SEEK_END) != 0) {
+        return false;
+    }
+    off_t size = ftello(file_);
+    if (size < static_cast<off_t>(sizeof(HEADER_MAGIC) + FOOTER_SIZE) ||
+        fseeko(file_, size - FOOTER_SIZE, SEEK_SET) != 0 ||
+        !getWord(index_offset_) || !getWord(count) ||
+        fread(magic, sizeof(magic), 1, file_) != 1 ||
+        memcmp(magic, FOOTER_MAGIC, sizeof(magic)) != 0 ||
+        index_offset_ > static_cast<uint64_t>(size) - FOOTER_SIZE) {
+        return false;
+    }
+
+    if (fseeko(file_, 0, SEEK_SET) != 0 ||
+        fread(magic, sizeof(magic), 1, file_) != 1 ||
+        memcmp(magic, HEADER_MAGIC, sizeof(magic)) != 0 ||
+        !getWord(party_id_) || !getString(party_name_, index_offset_)) {
+        return false;
+    }
+
+    uint64_t index_size = size - FOOTER_SIZE - index_offset_;
+    if (count > index_size / (2 * sizeof(uint64_t)) ||
+        fseeko(file_, index_offset_, SEEK_SET) != 0) {
+        return false;
+    }
+    order_.reserve(count);
+    for (uint64_t i = 0; i < count; ++i) {
+        std::string name;
+        uint64_t offset;
+        if (!getString(name, index_size) || !getWord(offset) || offset >= index_offset_) {
+            return false;
+        }
+        offsets_[name] = offset;
+        order_.emplace_back(offset, std::move(name));
+    }
+    return true;
+}
+
+std::vector<std::string> Reader::keys() const {
+    auto sorted = order_;
+    std::sort(sorted.begin(), sorted.end());
+    std::vector<std::string> names;
+    names.reserve(sorted.size());
+    for (auto& entry : sorted) {
+        names.push_back(entry.second);
+    }
+    return names;
+}
+
+bool Reader::read(const std::string& key_name, Shares& shares) {
+    auto it = offsets_.find(key_name);
+    if (!file_ || it == offsets_.end() || fseeko(file_, it->second, SEEK_SET) != 0) {
+        return false;
+    }
+    std::string stored_name;
+    uint64_t num_chunks;
+    if (!getString(stored_name, index_offset_) || stored_name != key_name || !getWord(num_chunks)) {
+        return false;
+    }
+    uint64_t record_end = it->second + 2 * sizeof(uint64_t) + key_name.size() + num_chunks * sizeof(uint64_t);
+    if (num_chunks > index_offset_ / sizeof(uint64_t) || record_end > index_offset_) {
+        return false;
+    }
+
+    shares.id = party_id_;
+    shares.values.resize(num_chunks);
+    return num_chunks == 0 ||
+           fread(shares.values.data(), sizeof(uint64_t), num_chunks, file_) == num_chunks;
+}
+
+} // namespace share_archive
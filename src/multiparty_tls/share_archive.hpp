@@ -0,0 +1,124 @@
+#ifndef SHARE_ARCHIVE_HPP
+#define SHARE_ARCHIVE_HPP
+
+#include "shamir_secret_sharing.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Indexed share archive: one file per party holding the chunk shares of many keys
+ *
+ * Batch splitting appends one record per key in completion order, so a
+ * fleet rotation produces five files instead of five per key. The index at
+ * the end maps key names to record offsets.
+ *
+ * Layout (all integers uint64_t, host byte order like the .share files):
+ *
+ *   "MPSHARC2" party_id name_len name
+ *   record*:   key_len key num_chunks value*num_chunks
+ *   index:     (key_len key offset)*count
+ *   footer:    index_offset count "MPSHIDX1"
+ *
+ * Every share in the archive is at x = party_id, so records carry only the
+ * values.
+ */
+namespace share_archive {
+
+using Shares = ShamirSecretSharing::PartyShares;
+
+/**
+ * Append-only writer; records go through a large stdio buffer so the file
+ * is written sequentially in big blocks. Not thread-safe.
+ */
+class Writer {
+public:
+    static constexpr size_t BUFFER_SIZE = 1 << 20;
+
+    Writer() = default;
+    ~Writer();
+
+    Writer(const Writer&) = delete;
+    Writer& operator=(const Writer&) = delete;
+
+    /**
+     * Create (truncate) the archive and write the header
+     */
+    bool open(const std::string& path, uint64_t party_id, const std::string& party_name);
+
+    /**
+     * Append one key's shares; key names must be unique within the archive
+     * and shares.id must be the archive's party id
+     */
+    bool append(const std::string& key_name, const Shares& shares);
+
+    /**
+     * Write index and footer, flush and close; false if any write failed
+     */
+    bool close();
+
+    size_t count() const { return index_.size(); }
+
+private:
+    FILE* file_ = nullptr;
+    uint64_t party_id_ = 0;
+    std::vector<char> buffer_;
+    uint64_t offset_ = 0;
+    bool ok_ = false;
+    std::vector<std::pair<std::string, uint64_t>> index_;
+    std::unordered_map<std::string, bool> names_;
+
+    void put(const void* data, size_t size);
+    void putWord(uint64_t value) { put(&value, sizeof(value)); }
+    void putString(const std::string& s);
+};
+
+/**
+ * Random-access reader over a finished archive
+ */
+class Reader {
+public:
+    Reader() = default;
+    ~Reader();
+
+    Reader(const Reader&) = delete;
+    Reader& operator=(const Reader&) = delete;
+
+    /**
+     * Open and load the index; false on a missing, truncated or unfinished archive
+     */
+    bool open(const std::string& path);
+
+    uint64_t partyId() const { return party_id_; }
+    const std::string& partyName() const { return party_name_; }
+
+    /**
+     * Key names in the order they were appended
+     */
+    std::vector<std::string> keys() const;
+
+    bool contains(const std::string& key_name) const { return offsets_.count(key_name) != 0; }
+
+    /**
+     * Shares of one key (shares.id = partyId()); false if the key is absent
+     * or the record is corrupt
+     */
+    bool read(const std::string& key_name, Shares& shares);
+
+private:
+    FILE* file_ = nullptr;
+    uint64_t party_id_ = 0;
+    std::string party_name_;
+    uint64_t index_offset_ = 0;
+    std::unordered_map<std::string, uint64_t> offsets_;
+    std::vector<std::pair<uint64_t, std::string>> order_;
+
+    bool getWord(uint64_t& value);
+    bool getString(std::string& s, uint64_t limit);
+};
+
+} // namespace share_archive
+
+#endif // SHARE_ARCHIVE_HPP
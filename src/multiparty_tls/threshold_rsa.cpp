@@ -0,0 +1,884 @@
+// The private-operation hook is an RSA_METHOD: libssl routes keys with a
+// non-default method ("foreign" keys) through the legacy EVP_PKEY_METHOD
+// path, which is what lets SSL_accept use a key that has no d at all.
+#define OPENSSL_SUPPRESS_DEPRECATED
+
+#include "threshold_rsa.hpp"
+#include "rsa_key_utils.hpp"
+#include <openssl/core_names.h>
+#include <openssl/async.h>
+#include <openssl/rsa.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <thread>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace threshold_rsa {
+
+namespace {
+
+constexpr uint32_t MAX_WIRE_BYTES = 2048;   // 16384-bit operands
+constexpr uint32_t MAX_WIRE_PIECES = 1024;
+
+bool writeAll(int fd, const void* data, size_t len) {
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    while (len > 0) {
+        ssize_t n = write(fd, p, len);
+        if (n <= 0) return false;
+        p += n;
+        len -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool readAll(int fd, void* data, size_t len) {
+    uint8_t* p = static_cast<uint8_t*>(data);
+    while (len > 0) {
+        ssize_t n = read(fd, p, len);
+        if (n <= 0) return false;
+        p += n;
+        len -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool writeBignum(int fd, const BIGNUM* value) {
+    uint32_t len = static_cast<uint32_t>(BN_num_bytes(value));
+    Bytes buf(len);
+    BN_bn2bin(value, buf.data());
+    return writeAll(fd, &len, sizeof(len)) && writeAll(fd, buf.data(), len);
+}
+
+bool readBignum(int fd, BIGNUM* value) {
+    uint32_t len = 0;
+    if (!readAll(fd, &len, sizeof(len)) || len > MAX_WIRE_BYTES) return false;
+    Bytes buf(len);
+    return readAll(fd, buf.data(), len) && BN_bin2bn(buf.data(), len, value) != nullptr;
+}
+
+Bytes toBytes(const BIGNUM* value) {
+    Bytes out(BN_num_bytes(value));
+    BN_bn2bin(value, out.data());
+    return out;
+}
+
+void appendWord(Bytes& out, uint32_t value) {
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(&value);
+    out.insert(out.end(), p, p + sizeof(value));
+}
+
+// PARTIALEXP response header: status, then the result length
+constexpr size_t RESPONSE_HEADER = 2 * sizeof(uint32_t);
+
+bool contains(const std::vector<size_t>& ids, size_t id) {
+    return std::find(ids.begin(), ids.end(), id) != ids.end();
+}
+
+// ----------------------------------------------------------------------------
+// RSA_METHOD hook
+// ----------------------------------------------------------------------------
+
+int exDataIndex() {
+    static const int index = RSA_get_ex_new_index(0, nullptr, nullptr, nullptr, nullptr);
+    return index;
+}
+
+ThresholdRSAKey* combinerFor(RSA* rsa) {
+    return static_cast<ThresholdRSAKey*>(RSA_get_ex_data(rsa, exDataIndex()));
+}
+
+int thresholdPrivateEncrypt(int flen, const unsigned char* from, unsigned char* to,
+                            RSA* rsa, int padding) {
+    ThresholdRSAKey* key = combinerFor(rsa);
+    if (!key) return -1;
+
+    int k = static_cast<int>(key->modulusSize());
+    Bytes encoded(k);
+    int ok = 0;
+    switch (padding) {
+        case RSA_PKCS1_PADDING:
+            ok = RSA_padding_add_PKCS1_type_1(encoded.data(), k, from, flen);
+            break;
+        case RSA_NO_PADDING:    // PSS: EVP layer has already encoded the block
+            ok = RSA_padding_add_none(encoded.data(), k, from, flen);
+            break;
+        default:
+            return -1;
+    }
+    if (ok != 1 || !key->privateOperationAsync(encoded.data(), encoded.size(), to)) {
+        return -1;
+    }
+    return k;
+}
+
+int thresholdPrivateDecrypt(int flen, const unsigned char* from, unsigned char* to,
+                            RSA* rsa, int padding) {
+    ThresholdRSAKey* key = combinerFor(rsa);
+    if (!key) return -1;
+
+    int k = static_cast<int>(key->modulusSize());
+    Bytes decoded(k);
+    if (!key->privateOperationAsync(from, static_cast<size_t>(flen), decoded.data())) {
+        return -1;
+    }
+
+    int result = -1;
+    switch (padding) {
+        case RSA_NO_PADDING:    // TLS RSA key exchange checks the padding itself
+            std::memcpy(to, decoded.data(), k);
+            result = k;
+            break;
+        case RSA_PKCS1_PADDING:
+            result = RSA_padding_check_PKCS1_type_2(to, k, decoded.data(), k, k);
+            break;
+        case RSA_PKCS1_OAEP_PADDING:
+            result = RSA_padding_check_PKCS1_OAEP(to, k, decoded.data(), k, k, nullptr, 0);
+            break;
+        default:
+            break;
+    }
+    OPENSSL_cleanse(decoded.data(), decoded.size());
+    return result;
+}
+
+const RSA_METHOD* thresholdMethod() {
+    static RSA_METHOD* method = [] {
+        RSA_METHOD* m = RSA_meth_dup(RSA_PKCS1_OpenSSL());
+        RSA_meth_set1_name(m, "multiparty threshold RSA");
+        RSA_meth_set_flags(m, RSA_meth_get_flags(m) | RSA_FLAG_EXT_PKEY);
+        RSA_meth_set_priv_enc(m, thresholdPrivateEncrypt);
+        RSA_meth_set_priv_dec(m, thresholdPrivateDecrypt);
+        return m;
+    }();
+    return method;
+}
+
+} // namespace
+
+// ============================================================================
+// DEALING
+// ============================================================================
+
+std::vector<std::vector<size_t>> pieceSubsets(size_t threshold, size_t num_parties) {
+    std::vector<std::vector<size_t>> subsets;
+    size_t k = threshold - 1;
+    std::vector<size_t> current(k);
+    for (size_t i = 0; i < k; ++i) current[i] = i + 1;
+
+    while (true) {
+        subsets.push_back(current);
+
+        // Advance to the next k-combination of {1..n}
+        size_t i = k;
+        while (i > 0 && current[i - 1] == num_parties - k + i) --i;
+        if (i == 0) break;
+        ++current[i - 1];
+        for (size_t j = i; j < k; ++j) current[j] = current[j - 1] + 1;
+    }
+    return subsets;
+}
+
+std::vector<PartyKeyShare> dealExponentShares(EVP_PKEY* key, size_t threshold, size_t num_parties) {
+    std::vector<PartyKeyShare> shares;
+    if (threshold < 2 || num_parties < threshold) {
+        return shares;
+    }
+
+    BIGNUM* n = rsa_key_utils::getParam(key, OSSL_PKEY_PARAM_RSA_N);
+    BIGNUM* d = rsa_key_utils::getParam(key, OSSL_PKEY_PARAM_RSA_D);
+    BIGNUM* p = rsa_key_utils::getParam(key, OSSL_PKEY_PARAM_RSA_FACTOR1);
+    BIGNUM* q = rsa_key_utils::getParam(key, OSSL_PKEY_PARAM_RSA_FACTOR2);
+    BN_CTX* ctx = BN_CTX_new();
+    BIGNUM* lambda = BN_secure_new();
+    BIGNUM* p1 = BN_secure_new();
+    BIGNUM* q1 = BN_secure_new();
+    BIGNUM* g = BN_secure_new();
+    BIGNUM* sum = BN_secure_new();
+    BIGNUM* piece = BN_secure_new();
+
+    auto subsets = pieceSubsets(threshold, num_parties);
+    bool ok = n && d && p && q && ctx && lambda && p1 && q1 && g && sum && piece &&
+              // lambda(n) = lcm(p-1, q-1)
+              BN_sub(p1, p, BN_value_one()) && BN_sub(q1, q, BN_value_one()) &&
+              BN_gcd(g, p1, q1, ctx) && BN_mul(lambda, p1, q1, ctx) &&
+              BN_div(lambda, nullptr, lambda, g, ctx);
+    if (ok) {
+        BN_zero(sum);
+    }
+
+    if (ok) {
+        shares.resize(num_parties);
+        Bytes modulus = toBytes(n);
+        for (size_t i = 0; i < num_parties; ++i) {
+            shares[i].party_id = i + 1;
+            shares[i].threshold = threshold;
+            shares[i].num_parties = num_parties;
+            shares[i].modulus = modulus;
+        }
+
+        for (size_t k = 0; k < subsets.size() && ok; ++k) {
+            if (k + 1 < subsets.size()) {
+                // r_T uniform mod lambda(n)
+                ok = BN_priv_rand_range(piece, lambda) && BN_mod_add(sum, sum, piece, lambda, ctx);
+            } else {
+                // Last piece closes the sum: r_T = d - sum (mod lambda(n))
+                ok = BN_mod_sub(piece, d, sum, lambda, ctx);
+            }
+
+            Bytes value = toBytes(piece);
+            for (auto& share : shares) {
+                if (!contains(subsets[k], share.party_id)) {
+                    share.pieces.push_back({k, value});
+                }
+            }
+            OPENSSL_cleanse(value.data(), value.size());
+        }
+    }
+
+    if (!ok) {
+        shares.clear();
+    }
+
+    BN_free(n);
+    BN_clear_free(d);
+    BN_clear_free(p);
+    BN_clear_free(q);
+    BN_clear_free(lambda);
+    BN_clear_free(p1);
+    BN_clear_free(q1);
+    BN_clear_free(g);
+    BN_clear_free(sum);
+    BN_clear_free(piece);
+    BN_CTX_free(ctx);
+    return shares;
+}
+
+bool PartyKeyShare::saveToFile(const std::string& filename) const {
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open()) return false;
+
+    size_t modulus_len = modulus.size();
+    size_t num_pieces = pieces.size();
+    file.write(reinterpret_cast<const char*>(&party_id), sizeof(party_id));
+    file.write(reinterpret_cast<const char*>(&threshold), sizeof(threshold));
+    file.write(reinterpret_cast<const char*>(&num_parties), sizeof(num_parties));
+    file.write(reinterpret_cast<const char*>(&modulus_len), sizeof(modulus_len));
+    file.write(reinterpret_cast<const char*>(modulus.data()), modulus_len);
+    file.write(reinterpret_cast<const char*>(&num_pieces), sizeof(num_pieces));
+
+    for (const auto& piece : pieces) {
+        size_t value_len = piece.value.size();
+        file.write(reinterpret_cast<const char*>(&piece.index), sizeof(piece.index));
+        file.write(reinterpret_cast<const char*>(&value_len), sizeof(value_len));
+        file.write(reinterpret_cast<const char*>(piece.value.data()), value_len);
+    }
+
+    return file.good();
+}
+
+bool PartyKeyShare::loadFromFile(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) return false;
+
+    size_t modulus_len = 0, num_pieces = 0;
+    file.read(reinterpret_cast<char*>(&party_id), sizeof(party_id));
+    file.read(reinterpret_cast<char*>(&threshold), sizeof(threshold));
+    file.read(reinterpret_cast<char*>(&num_parties), sizeof(num_parties));
+    file.read(reinterpret_cast<char*>(&modulus_len), sizeof(modulus_len));
+    if (!file.good() || modulus_len > MAX_WIRE_BYTES) return false;
+    modulus.resize(modulus_len);
+    file.read(reinterpret_cast<char*>(modulus.data()), modulus_len);
+    file.read(reinterpret_cast<char*>(&num_pieces), sizeof(num_pieces));
+    if (!file.good() || num_pieces > MAX_WIRE_PIECES) return false;
+
+    pieces.clear();
+    for (size_t i = 0; i < num_pieces; ++i) {
+        ExponentPiece piece;
+        size_t value_len = 0;
+        file.read(reinterpret_cast<char*>(&piece.index), sizeof(piece.index));
+        file.read(reinterpret_cast<char*>(&value_len), sizeof(value_len));
+        if (!file.good() || value_len > MAX_WIRE_BYTES) return false;
+        piece.value.resize(value_len);
+        file.read(reinterpret_cast<char*>(piece.value.data()), value_len);
+        pieces.push_back(std::move(piece));
+    }
+
+    return file.good();
+}
+
+// ============================================================================
+// PARTY SIDE
+// ============================================================================
+
+bool partialExponentiate(const PartyKeyShare& share, const BIGNUM* x,
+                         const std::vector<size_t>& piece_indices, BIGNUM* out) {
+    BN_CTX* ctx = BN_CTX_new();
+    BIGNUM* n = BN_bin2bn(share.modulus.data(), static_cast<int>(share.modulus.size()), nullptr);
+    BIGNUM* exponent = BN_secure_new();
+    BIGNUM* piece = BN_secure_new();
+
+    bool ok = ctx && n && exponent && piece;
+    if (ok) {
+        BN_zero(exponent);
+    }
+    for (size_t index : piece_indices) {
+        if (!ok) break;
+        auto it = std::find_if(share.pieces.begin(), share.pieces.end(),
+                               [index](const ExponentPiece& p) { return p.index == index; });
+        ok = it != share.pieces.end() &&
+             BN_bin2bn(it->value.data(), static_cast<int>(it->value.size()), piece) &&
+             BN_add(exponent, exponent, piece);
+    }
+
+    ok = ok && BN_cmp(x, n) < 0 &&
+         BN_mod_exp_mont_consttime(out, x, exponent, n, ctx, nullptr) == 1;
+
+    BN_clear_free(piece);
+    BN_clear_free(exponent);
+    BN_free(n);
+    BN_CTX_free(ctx);
+    return ok;
+}
+
+bool LocalParty::partialExponentiate(const BIGNUM* x, const std::vector<size_t>& piece_indices,
+                                     BIGNUM* out) {
+    return threshold_rsa::partialExponentiate(share_, x, piece_indices, out);
+}
+
+bool RemoteParty::partialExponentiate(const BIGNUM* x, const std::vector<size_t>& piece_indices,
+                                      BIGNUM* out) {
+    auto request = startPartialExponentiate(x, piece_indices);
+    PendingRequest::runAll({request.get()});
+    return request->result(out);
+}
+
+std::unique_ptr<PendingRequest> RemoteParty::startPartialExponentiate(const BIGNUM* x,
+                                                                      const std::vector<size_t>& piece_indices) {
+    // Same bytes as writeAll/writeBignum would send, queued for non-blocking writes
+    Bytes request(PARTIAL_REQUEST, PARTIAL_REQUEST + REQUEST_WORD_LENGTH);
+    Bytes value = toBytes(x);
+    appendWord(request, static_cast<uint32_t>(value.size()));
+    request.insert(request.end(), value.begin(), value.end());
+    appendWord(request, static_cast<uint32_t>(piece_indices.size()));
+    for (size_t index : piece_indices) {
+        appendWord(request, static_cast<uint32_t>(index));
+    }
+
+    struct sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port_);
+    int fd = -1;
+    bool connected = false;
+    if (inet_pton(AF_INET, host_.c_str(), &addr.sin_addr) == 1) {
+        fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (fd >= 0) {
+            connected = connect(fd, reinterpret_cast<const struct sockaddr*>(&addr), sizeof(addr)) == 0;
+            if (!connected && errno != EINPROGRESS) {
+                close(fd);
+                fd = -1;
+            }
+        }
+    }
+    return std::make_unique<PendingRequest>(fd, connected, std::move(request), timeout_ms_);
+}
+
+// ============================================================================
+// NON-BLOCKING REQUESTS
+// ============================================================================
+
+PendingRequest::PendingRequest(int fd, bool connected, Bytes request, int timeout_ms)
+    : fd_(fd),
+      state_(fd < 0 ? State::Failed : connected ? State::Sending : State::Connecting),
+      request_(std::move(request)),
+      timeout_ms_(timeout_ms),
+      deadline_(std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms)) {}
+
+PendingRequest::~PendingRequest() {
+    if (fd_ >= 0) close(fd_);
+}
+
+short PendingRequest::events() const {
+    return state_ == State::Receiving ? POLLIN : POLLOUT;
+}
+
+void PendingRequest::fail() {
+    state_ = State::Failed;
+    if (fd_ >= 0) {
+        close(fd_);
+        fd_ = -1;
+    }
+}
+
+void PendingRequest::advance() {
+    if (state_ == State::Connecting) {
+        int error = 0;
+        socklen_t error_len = sizeof(error);
+        if (getsockopt(fd_, SOL_SOCKET, SO_ERROR, &error, &error_len) != 0 || error != 0) {
+            fail();
+            return;
+        }
+        state_ = State::Sending;
+    }
+    if (state_ == State::Sending) {
+        send();
+    } else if (state_ == State::Receiving) {
+        receive();
+    }
+}
+
+void PendingRequest::send() {
+    while (sent_ < request_.size()) {
+        ssize_t n = ::send(fd_, request_.data() + sent_, request_.size() - sent_, MSG_NOSIGNAL);
+        if (n > 0) {
+            sent_ += static_cast<size_t>(n);
+            deadline_ = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms_);
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return;
+        } else {
+            fail();
+            return;
+        }
+    }
+    state_ = State::Receiving;
+}
+
+void PendingRequest::receive() {
+    while (true) {
+        size_t have = response_.size();
+        size_t wanted = RESPONSE_HEADER;
+        if (have >= RESPONSE_HEADER) {
+            uint32_t status, len;
+            std::memcpy(&status, response_.data(), sizeof(status));
+            std::memcpy(&len, response_.data() + sizeof(status), sizeof(len));
+            if (status != 1 || len > MAX_WIRE_BYTES) {
+                fail();
+                return;
+            }
+            wanted += len;
+            if (have == wanted) {
+                state_ = State::Done;
+                close(fd_);
+                fd_ = -1;
+                return;
+            }
+        }
+
+        response_.resize(wanted);
+        ssize_t n = recv(fd_, response_.data() + have, wanted - have, 0);
+        response_.resize(have + (n > 0 ? static_cast<size_t>(n) : 0));
+        if (n > 0) {
+            deadline_ = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms_);
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return;
+        } else {
+            fail();     // Closed before the full response
+            return;
+        }
+    }
+}
+
+bool PendingRequest::result(BIGNUM* out) const {
+    return state_ == State::Done &&
+           BN_bin2bn(response_.data() + RESPONSE_HEADER,
+                     static_cast<int>(response_.size() - RESPONSE_HEADER), out) != nullptr;
+}
+
+void PendingRequest::runAll(const std::vector<PendingRequest*>& requests) {
+    std::vector<struct pollfd> fds;
+    std::vector<PendingRequest*> active;
+    while (true) {
+        fds.clear();
+        active.clear();
+        auto now = std::chrono::steady_clock::now();
+        int wait_ms = -1;
+        for (PendingRequest* request : requests) {
+            if (request->finished()) {
+                continue;
+            }
+            if (now >= request->deadline_) {
+                request->fail();
+                continue;
+            }
+            auto left = std::chrono::duration_cast<std::chrono::milliseconds>(request->deadline_ - now).count() + 1;
+            wait_ms = wait_ms < 0 ? static_cast<int>(left) : std::min(wait_ms, static_cast<int>(left));
+            active.push_back(request);
+            fds.push_back({request->fd_, request->events(), 0});
+        }
+        if (active.empty()) {
+            return;
+        }
+
+        int ready = poll(fds.data(), fds.size(), wait_ms);
+        if (ready < 0 && errno != EINTR) {
+            for (PendingRequest* request : active) {
+                request->fail();
+            }
+            return;
+        }
+        for (size_t i = 0; ready > 0 && i < fds.size(); ++i) {
+            if (fds[i].revents != 0) {
+                active[i]->advance();
+            }
+        }
+    }
+}
+
+bool servePartialRequest(int fd, const PartyKeyShare& share) {
+    BIGNUM* x = BN_new();
+    BIGNUM* y = BN_new();
+    uint32_t count = 0;
+    std::vector<size_t> indices;
+
+    bool ok = x && y && readBignum(fd, x) &&
+              readAll(fd, &count, sizeof(count)) && count <= MAX_WIRE_PIECES;
+    for (uint32_t i = 0; ok && i < count; ++i) {
+        uint32_t index = 0;
+        ok = readAll(fd, &index, sizeof(index));
+        indices.push_back(index);
+    }
+
+    ok = ok && partialExponentiate(share, x, indices, y);
+
+    uint32_t status = ok ? 1 : 0;
+    bool sent = writeAll(fd, &status, sizeof(status)) && (!ok || writeBignum(fd, y));
+
+    BN_free(x);
+    BN_free(y);
+    return ok && sent;
+}
+
+// ============================================================================
+// COMBINER
+// ============================================================================
+
+/**
+ * Worker threads that run private operations on behalf of paused jobs
+ */
+class ThresholdRSAKey::OffloadPool {
+public:
+    explicit OffloadPool(size_t threads) {
+        for (size_t i = 0; i < threads; ++i) {
+            workers_.emplace_back(&OffloadPool::run, this);
+        }
+    }
+
+    ~OffloadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        ready_.notify_all();
+        for (auto& worker : workers_) {
+            worker.join();
+        }
+    }
+
+    void submit(std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            tasks_.push_back(std::move(task));
+        }
+        ready_.notify_one();
+    }
+
+private:
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            ready_.wait(lock, [this] { return !tasks_.empty() || stopping_; });
+            if (tasks_.empty()) {
+                break;
+            }
+            auto task = std::move(tasks_.front());
+            tasks_.pop_front();
+            lock.unlock();
+            task();
+            lock.lock();
+        }
+    }
+
+    std::mutex mutex_;
+    std::condition_variable ready_;
+    std::deque<std::function<void()>> tasks_;
+    std::vector<std::thread> workers_;
+    bool stopping_ = false;
+};
+
+namespace {
+
+/**
+ * One offloaded operation. Shared between the paused job and the worker so
+ * neither side touches memory the other may already have released.
+ */
+struct PendingOperation {
+    PendingOperation(const uint8_t* in, size_t in_len, size_t out_len)
+        : input(in, in + in_len), output(out_len),
+          fd(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) {}
+
+    ~PendingOperation() {
+        OPENSSL_cleanse(output.data(), output.size());
+        if (fd >= 0) close(fd);
+    }
+
+    Bytes input;
+    Bytes output;
+    bool ok = false;
+    std::atomic<bool> done{false};
+    int fd;
+};
+
+} // namespace
+
+ThresholdRSAKey::ThresholdRSAKey(EVP_PKEY* public_key, size_t threshold, size_t num_parties,
+                                 std::vector<std::unique_ptr<PartyBackend>> parties)
+    : n_(rsa_key_utils::getParam(public_key, OSSL_PKEY_PARAM_RSA_N)),
+      e_(rsa_key_utils::getParam(public_key, OSSL_PKEY_PARAM_RSA_E)),
+      threshold_(threshold),
+      subsets_(pieceSubsets(threshold, num_parties)),
+      parties_(std::move(parties)) {}
+
+ThresholdRSAKey::~ThresholdRSAKey() {
+    offload_.reset();   // Workers may still be using n_, e_ and the parties
+    requests_.reset();
+    BN_free(n_);
+    BN_free(e_);
+}
+
+size_t ThresholdRSAKey::modulusSize() const {
+    return n_ ? static_cast<size_t>(BN_num_bytes(n_)) : 0;
+}
+
+bool ThresholdRSAKey::combine(const BIGNUM* x, const std::vector<size_t>& excluded, BIGNUM* y,
+                              std::vector<size_t>& contributors, BN_CTX* ctx) {
+    // Assign each piece to the first available party that holds it
+    std::vector<std::vector<size_t>> assigned(parties_.size());
+    for (size_t k = 0; k < subsets_.size(); ++k) {
+        bool placed = false;
+        for (size_t i = 0; i < parties_.size() && !placed; ++i) {
+            size_t id = parties_[i]->partyId();
+            if (!contains(excluded, id) && !contains(subsets_[k], id)) {
+                assigned[i].push_back(k);
+                placed = true;
+            }
+        }
+        if (!placed) {
+            return false;   // Fewer than t usable parties
+        }
+    }
+
+    // Ask every assigned party at once
+    std::vector<size_t> asked;
+    contributors.clear();
+    for (size_t i = 0; i < parties_.size(); ++i) {
+        if (!assigned[i].empty()) {
+            asked.push_back(i);
+            contributors.push_back(parties_[i]->partyId());
+        }
+    }
+
+    std::vector<BIGNUM*> partials(asked.size(), nullptr);
+    std::vector<char> answered(asked.size(), 0);     // Not vector<bool>: written concurrently
+    for (auto& partial : partials) {
+        partial = BN_new();
+    }
+
+    // Remote parties: requests in flight together, polled from this thread
+    std::vector<std::unique_ptr<PendingRequest>> pending(asked.size());
+    std::vector<PendingRequest*> polled;
+    std::vector<size_t> blocking;
+    for (size_t k = 0; k < asked.size(); ++k) {
+        pending[k] = parties_[asked[k]]->startPartialExponentiate(x, assigned[asked[k]]);
+        if (pending[k]) {
+            polled.push_back(pending[k].get());
+        } else {
+            blocking.push_back(k);
+        }
+    }
+
+    // Blocking parties: on the key's request pool; with nothing to poll,
+    // the first of them runs on this thread instead
+    auto ask = [&](size_t k) {
+        answered[k] = partials[k] &&
+                      parties_[asked[k]]->partialExponentiate(x, assigned[asked[k]], partials[k]);
+    };
+    size_t on_caller = polled.empty() && !blocking.empty() ? 1 : 0;
+    std::mutex done_mutex;
+    std::condition_variable done;
+    size_t outstanding = blocking.size() - on_caller;
+    if (outstanding > 0) {
+        std::call_once(requests_started_, [this] {
+            requests_ = std::make_unique<OffloadPool>(parties_.size() - 1);
+        });
+        for (size_t i = on_caller; i < blocking.size(); ++i) {
+            size_t k = blocking[i];
+            requests_->submit([&, k] {
+                ask(k);
+                std::lock_guard<std::mutex> lock(done_mutex);
+                --outstanding;
+                done.notify_one();      // Under the lock: the waiter owns done
+            });
+        }
+    }
+    if (on_caller) {
+        ask(blocking[0]);
+    }
+
+    PendingRequest::runAll(polled);
+    for (size_t k = 0; k < asked.size(); ++k) {
+        if (pending[k]) {
+            answered[k] = partials[k] && pending[k]->result(partials[k]);
+        }
+    }
+    {
+        std::unique_lock<std::mutex> lock(done_mutex);
+        done.wait(lock, [&] { return outstanding == 0; });
+    }
+
+    bool ok = BN_one(y) == 1;
+    for (size_t k = 0; k < asked.size(); ++k) {
+        ok = ok && answered[k] && BN_mod_mul(y, y, partials[k], n_, ctx);
+        BN_free(partials[k]);
+    }
+    return ok;
+}
+
+bool ThresholdRSAKey::privateOperation(const uint8_t* in, size_t in_len, uint8_t* out) {
+    auto start = std::chrono::steady_clock::now();
+
+    BN_CTX* ctx = BN_CTX_new();
+    if (!ctx) return false;
+    BN_CTX_start(ctx);
+    BIGNUM* x = BN_CTX_get(ctx);
+    BIGNUM* y = BN_CTX_get(ctx);
+    BIGNUM* check = BN_CTX_get(ctx);
+
+    bool ok = false;
+    if (check && n_ && e_ && BN_bin2bn(in, static_cast<int>(in_len), x) && BN_cmp(x, n_) < 0) {
+        // y^e == x proves the combined result is x^d without knowing d
+        auto attempt = [&](const std::vector<size_t>& excluded, std::vector<size_t>& contributors) {
+            BN_CTX_start(ctx);
+            bool good = combine(x, excluded, y, contributors, ctx) &&
+                        BN_mod_exp(check, y, e_, n_, ctx) && BN_cmp(check, x) == 0;
+            BN_CTX_end(ctx);
+            return good;
+        };
+
+        std::vector<size_t> contributors;
+        ok = attempt({}, contributors);
+
+        // A party returned garbage or went away: retry without each contributor
+        std::vector<size_t> suspects = contributors;
+        for (size_t i = 0; !ok && i < suspects.size(); ++i) {
+            ok = attempt({suspects[i]}, contributors);
+        }
+    }
+
+    if (ok) {
+        ok = BN_bn2binpad(y, out, static_cast<int>(modulusSize())) >= 0;
+    }
+
+    BN_CTX_end(ctx);
+    BN_CTX_free(ctx);
+
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()), ok);
+    return ok;
+}
+
+void ThresholdRSAKey::startOffload(size_t worker_threads) {
+    if (!offload_ && worker_threads > 0) {
+        offload_ = std::make_unique<OffloadPool>(worker_threads);
+    }
+}
+
+bool ThresholdRSAKey::privateOperationAsync(const uint8_t* in, size_t in_len, uint8_t* out) {
+    ASYNC_JOB* job = ASYNC_get_current_job();
+    if (!job || !offload_) {
+        return privateOperation(in, in_len, out);
+    }
+
+    ASYNC_WAIT_CTX* wait_ctx = ASYNC_get_wait_ctx(job);
+    auto op = std::make_shared<PendingOperation>(in, in_len, modulusSize());
+    if (op->fd < 0 || ASYNC_WAIT_CTX_set_wait_fd(wait_ctx, this, op->fd, nullptr, nullptr) != 1) {
+        return privateOperation(in, in_len, out);
+    }
+
+    offload_->submit([this, op] {
+        op->ok = privateOperation(op->input.data(), op->input.size(), op->output.data());
+        op->done.store(true, std::memory_order_release);
+        uint64_t one = 1;
+        ssize_t written = write(op->fd, &one, sizeof(one));
+        (void)written;
+    });
+
+    // The caller may resume the job before the fd fires; just pause again
+    while (!op->done.load(std::memory_order_acquire)) {
+        if (ASYNC_pause_job() != 1) {
+            struct pollfd pfd = {op->fd, POLLIN, 0};
+            poll(&pfd, 1, -1);
+        }
+    }
+
+    uint64_t count;
+    ssize_t drained = read(op->fd, &count, sizeof(count));
+    (void)drained;
+    ASYNC_WAIT_CTX_clear_fd(wait_ctx, this);
+
+    {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        ++stats_.offloaded;
+    }
+    if (op->ok) {
+        std::memcpy(out, op->output.data(), op->output.size());
+    }
+    return op->ok;
+}
+
+void ThresholdRSAKey::record(uint64_t elapsed_ns, bool ok) {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    ++stats_.operations;
+    if (!ok) ++stats_.failures;
+    stats_.total_ns += elapsed_ns;
+    stats_.max_ns = std::max(stats_.max_ns, elapsed_ns);
+}
+
+ThresholdRSAKey::Stats ThresholdRSAKey::stats() const {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    return stats_;
+}
+
+EVP_PKEY* ThresholdRSAKey::makeEvpPkey() {
+    if (!n_ || !e_) return nullptr;
+
+    RSA* rsa = RSA_new();
+    EVP_PKEY* pkey = EVP_PKEY_new();
+    if (!rsa || !pkey ||
+        RSA_set_method(rsa, thresholdMethod()) != 1 ||
+        RSA_set0_key(rsa, BN_dup(n_), BN_dup(e_), nullptr) != 1 ||
+        RSA_set_ex_data(rsa, exDataIndex(), this) != 1 ||
+        EVP_PKEY_assign_RSA(pkey, rsa) != 1) {
+        RSA_free(rsa);
+        EVP_PKEY_free(pkey);
+        return nullptr;
+    }
+    return pkey;
+}
+
+} // namespace threshold_rsa
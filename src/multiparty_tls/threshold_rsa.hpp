@@ -0,0 +1,287 @@
+#ifndef THRESHOLD_RSA_HPP
+#define THRESHOLD_RSA_HPP
+
+#include <openssl/bn.h>
+#include <openssl/evp.h>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * Threshold RSA private operations without reconstructing d
+ *
+ * The Shamir chunk shares (mod 2^61 - 1) protect d at rest but cannot be
+ * combined in the exponent. For online use the dealer additionally splits d
+ * with replicated additive sharing over the integers:
+ *
+ *   d = sum of r_T (mod lambda(n))   for every (t-1)-subset T of the parties
+ *
+ * Party i holds every r_T with i not in T. Any t parties together hold all
+ * pieces; any t-1 parties S miss r_S, which is uniform mod lambda(n).
+ *
+ * A private operation x^d mod n is computed as the product of partial
+ * results x^(sum of assigned r_T) returned by the parties, and checked with
+ * the public exponent before it is released.
+ */
+namespace threshold_rsa {
+
+using Bytes = std::vector<uint8_t>;
+
+/**
+ * One additive piece r_T of the private exponent
+ */
+struct ExponentPiece {
+    size_t index;   // Position of T in pieceSubsets() order
+    Bytes value;    // Big-endian r_T
+};
+
+/**
+ * Everything one party stores for online threshold operations
+ */
+struct PartyKeyShare {
+    size_t party_id;
+    size_t threshold;
+    size_t num_parties;
+    Bytes modulus;                      // n (big-endian)
+    std::vector<ExponentPiece> pieces;
+
+    bool saveToFile(const std::string& filename) const;
+    bool loadFromFile(const std::string& filename);
+};
+
+/**
+ * All (t-1)-subsets of {1..n} in lexicographic order; piece k belongs to
+ * subset k and is held by every party outside it
+ */
+std::vector<std::vector<size_t>> pieceSubsets(size_t threshold, size_t num_parties);
+
+/**
+ * Deal exponent pieces for a full key pair (needs p, q to compute lambda(n))
+ * @return One share per party (ids 1..n), empty on failure
+ */
+std::vector<PartyKeyShare> dealExponentShares(EVP_PKEY* key, size_t threshold, size_t num_parties);
+
+/**
+ * Compute x^(sum of the requested pieces) mod n on behalf of one party
+ * @return false if a requested piece is not held by this party
+ */
+bool partialExponentiate(const PartyKeyShare& share, const BIGNUM* x,
+                         const std::vector<size_t>& piece_indices, BIGNUM* out);
+
+/**
+ * One PARTIALEXP exchange on a non-blocking socket: connect, send the
+ * request, read status and result. Advanced by the caller's poll loop, so
+ * one thread can wait on many parties at once.
+ */
+class PendingRequest {
+public:
+    /**
+     * @param fd Socket with a non-blocking connect started (-1: already failed)
+     * @param connected Whether connect() completed immediately
+     * @param request Serialized request
+     * @param timeout_ms Fail after this long without progress
+     */
+    PendingRequest(int fd, bool connected, Bytes request, int timeout_ms);
+    ~PendingRequest();
+
+    PendingRequest(const PendingRequest&) = delete;
+    PendingRequest& operator=(const PendingRequest&) = delete;
+
+    bool finished() const { return state_ == State::Done || state_ == State::Failed; }
+
+    /**
+     * The party's partial result; false if the exchange failed
+     */
+    bool result(BIGNUM* out) const;
+
+    /**
+     * Poll every request until each has finished or timed out
+     */
+    static void runAll(const std::vector<PendingRequest*>& requests);
+
+private:
+    enum class State { Connecting, Sending, Receiving, Done, Failed };
+
+    short events() const;
+    void advance();
+    void send();
+    void receive();
+    void fail();
+
+    int fd_;
+    State state_;
+    Bytes request_;
+    size_t sent_ = 0;
+    Bytes response_;        // status, length, value as on the wire
+    int timeout_ms_;
+    std::chrono::steady_clock::time_point deadline_;
+};
+
+/**
+ * A party reachable by the combiner
+ */
+class PartyBackend {
+public:
+    virtual ~PartyBackend() = default;
+
+    virtual size_t partyId() const = 0;
+
+    /**
+     * Return x^(sum of the requested pieces) mod n
+     */
+    virtual bool partialExponentiate(const BIGNUM* x, const std::vector<size_t>& piece_indices,
+                                     BIGNUM* out) = 0;
+
+    /**
+     * Start the same request without blocking
+     * @return nullptr if this backend only has the blocking call (the
+     *         combiner then runs it on its request pool)
+     */
+    virtual std::unique_ptr<PendingRequest> startPartialExponentiate(const BIGNUM*, const std::vector<size_t>&) {
+        return nullptr;
+    }
+};
+
+/**
+ * Party whose share lives in this process (tests, co-located deployment)
+ */
+class LocalParty : public PartyBackend {
+public:
+    explicit LocalParty(PartyKeyShare share) : share_(std::move(share)) {}
+
+    size_t partyId() const override { return share_.party_id; }
+    bool partialExponentiate(const BIGNUM* x, const std::vector<size_t>& piece_indices,
+                             BIGNUM* out) override;
+
+private:
+    PartyKeyShare share_;
+};
+
+/**
+ * Party share server reached over TCP (PARTIALEXP request)
+ *
+ * The request fails once timeout_ms passes without progress (connect, send
+ * or receive), so a hung party fails and the combiner retries without it.
+ */
+class RemoteParty : public PartyBackend {
+public:
+    static constexpr int DEFAULT_TIMEOUT_MS = 2000;
+
+    RemoteParty(size_t party_id, std::string host, int port, int timeout_ms = DEFAULT_TIMEOUT_MS)
+        : party_id_(party_id), host_(std::move(host)), port_(port), timeout_ms_(timeout_ms) {}
+
+    size_t partyId() const override { return party_id_; }
+    bool partialExponentiate(const BIGNUM* x, const std::vector<size_t>& piece_indices,
+                             BIGNUM* out) override;
+    std::unique_ptr<PendingRequest> startPartialExponentiate(const BIGNUM* x,
+                                                             const std::vector<size_t>& piece_indices) override;
+
+private:
+    size_t party_id_;
+    std::string host_;
+    int port_;
+    int timeout_ms_;
+};
+
+/**
+ * Request word for partial exponentiation on the party share server
+ * (same length as GET_SHARES so the server can read a fixed-size command)
+ */
+constexpr char PARTIAL_REQUEST[] = "PARTIALEXP";
+constexpr size_t REQUEST_WORD_LENGTH = sizeof(PARTIAL_REQUEST) - 1;
+
+/**
+ * Serve one PARTIALEXP request on a connected socket (command word already read)
+ */
+bool servePartialRequest(int fd, const PartyKeyShare& share);
+
+/**
+ * Combiner: fans a private operation out to the parties and combines results
+ */
+class ThresholdRSAKey {
+public:
+    struct Stats {
+        uint64_t operations = 0;
+        uint64_t failures = 0;
+        uint64_t offloaded = 0;     // Ran on the offload pool from an ASYNC_JOB
+        uint64_t total_ns = 0;
+        uint64_t max_ns = 0;
+    };
+
+    /**
+     * @param public_key Key whose n and e are used (private parts are ignored)
+     * @param parties Reachable parties; at least threshold are required
+     */
+    ThresholdRSAKey(EVP_PKEY* public_key, size_t threshold, size_t num_parties,
+                    std::vector<std::unique_ptr<PartyBackend>> parties);
+    ~ThresholdRSAKey();
+
+    ThresholdRSAKey(const ThresholdRSAKey&) = delete;
+    ThresholdRSAKey& operator=(const ThresholdRSAKey&) = delete;
+
+    /**
+     * Raw private operation: out = in^d mod n (out is modulusSize() bytes)
+     * The parties are asked concurrently, so the latency is that of the
+     * slowest party rather than the sum of their round trips. Remote parties
+     * are polled together from the calling thread. Blocking backends run on
+     * a pool of (parties - 1) threads per key, created on first use, so the
+     * thread count does not grow with concurrent operations.
+     * The combined result is verified with e; if it fails, each party that
+     * contributed is excluded in turn and the pieces are reassigned while
+     * enough parties remain. Safe to call from several threads.
+     */
+    bool privateOperation(const uint8_t* in, size_t in_len, uint8_t* out);
+
+    /**
+     * privateOperation for callers that may be inside an ASYNC_JOB
+     *
+     * With SSL_MODE_ASYNC the handshake runs in a job; the operation is
+     * queued on the offload pool and the job pauses on an eventfd (exposed
+     * through SSL_get_all_async_fds) until the parties have answered, so
+     * SSL_accept returns SSL_ERROR_WANT_ASYNC instead of blocking. Outside a
+     * job, or before startOffload(), this is plain privateOperation.
+     */
+    bool privateOperationAsync(const uint8_t* in, size_t in_len, uint8_t* out);
+
+    /**
+     * Start the worker threads used by privateOperationAsync (call once,
+     * before the key is used)
+     */
+    void startOffload(size_t worker_threads);
+
+    size_t modulusSize() const;
+
+    /**
+     * EVP_PKEY carrying only (n, e) whose private operations are routed to
+     * this combiner through an RSA_METHOD. Usable with SSL_CTX_use_PrivateKey.
+     * The combiner must outlive the returned key.
+     */
+    EVP_PKEY* makeEvpPkey();
+
+    Stats stats() const;
+
+private:
+    class OffloadPool;
+
+    bool combine(const BIGNUM* x, const std::vector<size_t>& excluded, BIGNUM* y,
+                 std::vector<size_t>& contributors, BN_CTX* ctx);
+    void record(uint64_t elapsed_ns, bool ok);
+
+    BIGNUM* n_;
+    BIGNUM* e_;
+    size_t threshold_;
+    std::vector<std::vector<size_t>> subsets_;
+    std::vector<std::unique_ptr<PartyBackend>> parties_;
+    std::unique_ptr<OffloadPool> offload_;
+    std::unique_ptr<OffloadPool> requests_;     // Blocking party requests
+    std::once_flag requests_started_;
+    mutable std::mutex stats_mutex_;
+    Stats stats_;
+};
+
+} // namespace threshold_rsa
+
+#endif // THRESHOLD_RSA_HPP
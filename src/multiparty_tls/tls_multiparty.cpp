@@ -1,12 +1,78 @@
+// The PRF hashes through SHA256_CTX: a stack struct, where EVP digest
+// contexts allocate on every init and would put malloc in each handshake.
+#define OPENSSL_SUPPRESS_DEPRECATED
+
 #include "tls_multiparty.hpp"
-#include <openssl/evp.h>
-#include <openssl/hmac.h>
+#include "logger.hpp"
+#include <openssl/crypto.h>
 #include <openssl/sha.h>
 #include <openssl/rand.h>
 #include <algorithm>
+#include <initializer_list>
 #include <stdexcept>
 #include <cstring>
-#include <iostream>
+
+namespace {
+
+/**
+ * HMAC-SHA256 with the key absorbed once
+ *
+ * The inner and outer pads are hashed into two SHA256_CTX states up front;
+ * each MAC then copies those states (plain structs, no allocation - EVP
+ * digest contexts allocate on every init in OpenSSL 3) and costs two
+ * compressions fewer than a keyed HMAC call.
+ */
+class HmacSha256 {
+public:
+    explicit HmacSha256(secure_arena::ByteSpan key) {
+        uint8_t pad[SHA256_CBLOCK] = {0};
+        if (key.size() > SHA256_CBLOCK) {
+            SHA256_Init(&inner_);
+            SHA256_Update(&inner_, key.data(), key.size());
+            SHA256_Final(pad, &inner_);
+        } else if (!key.empty()) {
+            memcpy(pad, key.data(), key.size());
+        }
+        for (auto& b : pad) b ^= 0x36;
+        SHA256_Init(&inner_);
+        SHA256_Update(&inner_, pad, sizeof(pad));
+        for (auto& b : pad) b ^= 0x36 ^ 0x5c;
+        SHA256_Init(&outer_);
+        SHA256_Update(&outer_, pad, sizeof(pad));
+        OPENSSL_cleanse(pad, sizeof(pad));
+    }
+    
+    ~HmacSha256() {
+        OPENSSL_cleanse(&inner_, sizeof(inner_));
+        OPENSSL_cleanse(&outer_, sizeof(outer_));
+    }
+    
+    HmacSha256(const HmacSha256&) = delete;
+    HmacSha256& operator=(const HmacSha256&) = delete;
+    
+    /**
+     * HMAC over the concatenation of parts (out may alias a part)
+     */
+    void mac(std::initializer_list<secure_arena::ByteSpan> parts, uint8_t out[SHA256_DIGEST_LENGTH]) const {
+        SHA256_CTX ctx = inner_;
+        for (const auto& part : parts) {
+            SHA256_Update(&ctx, part.data(), part.size());
+        }
+        uint8_t inner_hash[SHA256_DIGEST_LENGTH];
+        SHA256_Final(inner_hash, &ctx);
+        ctx = outer_;
+        SHA256_Update(&ctx, inner_hash, sizeof(inner_hash));
+        SHA256_Final(out, &ctx);
+        OPENSSL_cleanse(inner_hash, sizeof(inner_hash));
+        OPENSSL_cleanse(&ctx, sizeof(ctx));
+    }
+
+private:
+    SHA256_CTX inner_;
+    SHA256_CTX outer_;
+};
+
+} // namespace
 
 TLSMultiParty::TLSMultiParty(size_t threshold, size_t num_parties)
     : threshold_(threshold), num_parties_(num_parties) {
@@ -25,14 +91,14 @@ TLSMultiParty::generateAndDistributeKeys() {
     // Ensure private key is within field
     private_key = private_key % PRIME;
     
-    std::cout << "[Key Generation] Original private key: " << private_key << std::endl;
+    MPLOG_TRACE("key-generation") << "Original private key: " << private_key;
     
     // Split private key into shares
     PrivateKeyShares shares = sss_->split(private_key);
     
-    std::cout << "[Key Distribution] Generated " << shares.size() << " shares:" << std::endl;
+    MPLOG_INFO("key-distribution") << "Generated " << shares.size() << " shares";
     for (const auto& share : shares) {
-        std::cout << "  Party " << share.id << " receives share: " << share.value << std::endl;
+        MPLOG_TRACE("key-distribution") << "Party " << share.id << " receives share: " << share.value;
     }
     
     // Generate corresponding public key (simplified)
@@ -42,14 +108,14 @@ TLSMultiParty::generateAndDistributeKeys() {
 }
 
 TLSMultiParty::Bytes TLSMultiParty::encryptPreMasterSecret(
-    const Bytes& pms, const Bytes& public_key) {
+    ByteSpan pms, ByteSpan public_key) {
     
     // Simplified encryption: In production, use RSA-PKCS1 or RSA-OAEP
     // For demonstration, we'll just XOR with public key (NOT SECURE - for illustration only)
     
-    std::cout << "[Client] Encrypting Pre-Master Secret with server's public key" << std::endl;
+    MPLOG_DEBUG("client") << "Encrypting Pre-Master Secret with server's public key";
     
-    Bytes encrypted = pms;
+    Bytes encrypted(pms.begin(), pms.end());
     for (size_t i = 0; i < encrypted.size() && i < public_key.size(); ++i) {
         encrypted[i] ^= public_key[i];
     }
@@ -57,84 +123,89 @@ TLSMultiParty::Bytes TLSMultiParty::encryptPreMasterSecret(
     return encrypted;
 }
 
-TLSMultiParty::Bytes TLSMultiParty::collaborativeDecryption(
-    const Bytes& encrypted_pms,
+TLSMultiParty::SecretBuffer TLSMultiParty::collaborativeDecryption(
+    ByteSpan encrypted_pms,
     const PrivateKeyShares& shares,
     const std::vector<size_t>& share_ids) {
     
     if (shares.size() < threshold_) {
         throw std::invalid_argument("Insufficient shares for decryption");
     }
+    if (share_ids.size() != shares.size()) {
+        throw std::invalid_argument("Share IDs do not match the participating parties");
+    }
+    for (size_t i = 0; i < shares.size(); ++i) {
+        if (shares[i].id != share_ids[i]) {
+            throw std::invalid_argument("Share IDs do not match the participating parties");
+        }
+    }
     
-    std::cout << "\n[Multi-Party Decryption] Starting collaborative decryption..." << std::endl;
-    std::cout << "[Multi-Party Decryption] " << shares.size() << " parties participating" << std::endl;
+    MPLOG_INFO("multi-party-decryption") << "Starting collaborative decryption with "
+                                         << shares.size() << " parties";
     
-    // Step 1: Each party contributes their share
-    std::vector<ShamirSecretSharing::Share> active_shares;
+    // Step 1: Each party contributes their share (sized once, in the secure arena)
+    secure_arena::SecureVector<ShamirSecretSharing::Share> active_shares;
+    active_shares.reserve(threshold_);
     for (size_t i = 0; i < std::min(shares.size(), threshold_); ++i) {
-        std::cout << "  Party " << shares[i].id << " contributes share: " << shares[i].value << std::endl;
+        MPLOG_TRACE("multi-party-decryption") << "Party " << shares[i].id << " contributes share: " << shares[i].value;
         active_shares.push_back(shares[i]);
     }
     
     // Step 2: Reconstruct the complete private key using Lagrange interpolation
-    std::cout << "\n[Key Reconstruction] Using Lagrange interpolation..." << std::endl;
-    ShamirSecretSharing::BigInt reconstructed_key = sss_->reconstruct(active_shares);
+    MPLOG_DEBUG("key-reconstruction") << "Using Lagrange interpolation";
+    ShamirSecretSharing::BigInt reconstructed_key = sss_->reconstruct(active_shares.data(), active_shares.size());
     
-    std::cout << "[Key Reconstruction] Reconstructed private key: " << reconstructed_key << std::endl;
-    std::cout << "[SECURITY WARNING] Complete private key exists in memory temporarily!" << std::endl;
+    MPLOG_TRACE("key-reconstruction") << "Reconstructed private key: " << reconstructed_key;
+    MPLOG_DEBUG("key-reconstruction") << "Complete private key exists in memory temporarily";
     
     // Step 3: Decrypt the PMS using reconstructed private key
-    Bytes private_key_bytes = bigIntToBytes(reconstructed_key, 32);
+    SecretBuffer private_key_bytes(32);
+    bigIntToBytes(reconstructed_key, private_key_bytes.data(), private_key_bytes.size());
     
-    Bytes decrypted_pms = encrypted_pms;
+    SecretBuffer decrypted_pms(encrypted_pms);
     for (size_t i = 0; i < decrypted_pms.size() && i < private_key_bytes.size(); ++i) {
         decrypted_pms[i] ^= private_key_bytes[i];
     }
     
     // Step 4: CRITICAL - Securely erase the reconstructed private key
-    std::cout << "[Security] Securely erasing reconstructed private key from memory" << std::endl;
-    secureErase(private_key_bytes);
+    MPLOG_DEBUG("security") << "Securely erasing reconstructed private key from memory";
+    private_key_bytes.clear();
     
-    std::cout << "[Multi-Party Decryption] Pre-Master Secret successfully decrypted\n" << std::endl;
+    MPLOG_INFO("multi-party-decryption") << "Pre-Master Secret successfully decrypted";
     
     return decrypted_pms;
 }
 
-TLSMultiParty::Bytes TLSMultiParty::deriveMasterSecret(
-    const Bytes& pms,
-    const Bytes& client_random,
-    const Bytes& server_random) {
+TLSMultiParty::SecretBuffer TLSMultiParty::deriveMasterSecret(
+    ByteSpan pms,
+    ByteSpan client_random,
+    ByteSpan server_random) {
     
-    std::cout << "[Key Derivation] Deriving master secret from PMS..." << std::endl;
-    
-    // Concatenate client_random + server_random
-    Bytes seed = client_random;
-    seed.insert(seed.end(), server_random.begin(), server_random.end());
+    MPLOG_DEBUG("key-derivation") << "Deriving master secret from PMS";
     
     // master_secret = PRF(pms, "master secret", client_random + server_random)[0..47]
-    Bytes master_secret = tls_prf(pms, "master secret", seed, 48);
+    SecretBuffer master_secret(48);
+    tls_prf(pms, "master secret", client_random, server_random, master_secret.data(), master_secret.size());
     
-    std::cout << "[Key Derivation] Master secret derived (48 bytes)" << std::endl;
+    MPLOG_DEBUG("key-derivation") << "Master secret derived (48 bytes)";
     
     return master_secret;
 }
 
-TLSMultiParty::Bytes TLSMultiParty::deriveKeyBlock(
-    const Bytes& master_secret,
-    const Bytes& client_random,
-    const Bytes& server_random,
+TLSMultiParty::SecretBuffer TLSMultiParty::deriveKeyBlock(
+    ByteSpan master_secret,
+    ByteSpan client_random,
+    ByteSpan server_random,
     size_t length) {
     
-    std::cout << "[Key Derivation] Deriving key block for session keys..." << std::endl;
-    
-    // Concatenate server_random + client_random (note: reversed order)
-    Bytes seed = server_random;
-    seed.insert(seed.end(), client_random.begin(), client_random.end());
+    MPLOG_DEBUG("key-derivation") << "Deriving key block for session keys";
     
     // key_block = PRF(master_secret, "key expansion", server_random + client_random)
-    Bytes key_block = tls_prf(master_secret, "key expansion", seed, length);
+    // (note: reversed order)
+    SecretBuffer key_block(length);
+    tls_prf(master_secret, "key expansion", server_random, client_random, key_block.data(), length);
     
-    std::cout << "[Key Derivation] Key block derived (" << length << " bytes)" << std::endl;
+    MPLOG_DEBUG("key-derivation") << "Key block derived (" << length << " bytes)";
     
     return key_block;
 }
@@ -155,7 +226,7 @@ TLSMultiParty::Bytes TLSMultiParty::generateRandom(size_t length) {
     return result;
 }
 
-ShamirSecretSharing::BigInt TLSMultiParty::bytesToBigInt(const Bytes& bytes) {
+ShamirSecretSharing::BigInt TLSMultiParty::bytesToBigInt(ByteSpan bytes) {
     ShamirSecretSharing::BigInt result = 0;
     for (size_t i = 0; i < bytes.size() && i < 8; ++i) {
         result = (result << 8) | bytes[i];
@@ -167,63 +238,47 @@ TLSMultiParty::Bytes TLSMultiParty::bigIntToBytes(
     ShamirSecretSharing::BigInt value, size_t length) {
     
     Bytes result(length, 0);
+    bigIntToBytes(value, result.data(), length);
+    return result;
+}
+
+void TLSMultiParty::bigIntToBytes(ShamirSecretSharing::BigInt value, uint8_t* out, size_t length) {
+    std::fill(out, out + length, 0);
     for (int i = std::min(length, size_t(8)) - 1; i >= 0; --i) {
-        result[i] = value & 0xFF;
+        out[i] = value & 0xFF;
         value >>= 8;
     }
-    return result;
 }
 
-TLSMultiParty::Bytes TLSMultiParty::tls_prf(
-    const Bytes& secret,
-    const std::string& label,
-    const Bytes& seed,
+void TLSMultiParty::tls_prf(
+    ByteSpan secret,
+    const char* label,
+    ByteSpan seed_first,
+    ByteSpan seed_second,
+    uint8_t* out,
     size_t output_length) {
     
     // TLS 1.2 PRF: PRF(secret, label, seed) = P_SHA256(secret, label + seed)
-    Bytes label_and_seed(label.begin(), label.end());
-    label_and_seed.insert(label_and_seed.end(), seed.begin(), seed.end());
-    
-    return p_hash(secret, label_and_seed, output_length);
-}
-
-TLSMultiParty::Bytes TLSMultiParty::hmac_sha256(const Bytes& key, const Bytes& data) {
-    unsigned char result[EVP_MAX_MD_SIZE];
-    unsigned int result_len = 0;
-    
-    HMAC(EVP_sha256(), key.data(), key.size(),
-         data.data(), data.size(), result, &result_len);
-    
-    return Bytes(result, result + result_len);
-}
-
-TLSMultiParty::Bytes TLSMultiParty::p_hash(
-    const Bytes& secret,
-    const Bytes& seed,
-    size_t output_length) {
-    
+    //
     // P_hash(secret, seed) = HMAC_hash(secret, A(1) + seed) +
     //                        HMAC_hash(secret, A(2) + seed) + ...
     // where A(0) = seed, A(i) = HMAC_hash(secret, A(i-1))
-    
-    Bytes result;
-    Bytes a = seed;  // A(0) = seed
-    
-    while (result.size() < output_length) {
-        // A(i) = HMAC(secret, A(i-1))
-        a = hmac_sha256(secret, a);
-        
-        // Concatenate A(i) + seed
-        Bytes a_and_seed = a;
-        a_and_seed.insert(a_and_seed.end(), seed.begin(), seed.end());
+    HmacSha256 hmac(secret);
+    ByteSpan label_bytes(reinterpret_cast<const uint8_t*>(label), strlen(label));
+    uint8_t a[SHA256_DIGEST_LENGTH];
+    uint8_t block[SHA256_DIGEST_LENGTH];
+    
+    // A(1) = HMAC(secret, label + seed)
+    hmac.mac({label_bytes, seed_first, seed_second}, a);
+    for (size_t offset = 0; offset < output_length; offset += SHA256_DIGEST_LENGTH) {
+        // HMAC(secret, A(i) + label + seed)
+        hmac.mac({ByteSpan(a, sizeof(a)), label_bytes, seed_first, seed_second}, block);
+        memcpy(out + offset, block, std::min(sizeof(block), output_length - offset));
         
-        // HMAC(secret, A(i) + seed)
-        Bytes hmac_result = hmac_sha256(secret, a_and_seed);
-        
-        result.insert(result.end(), hmac_result.begin(), hmac_result.end());
+        // A(i+1) = HMAC(secret, A(i))
+        hmac.mac({ByteSpan(a, sizeof(a))}, a);
     }
     
-    // Truncate to required length
-    result.resize(output_length);
-    return result;
+    OPENSSL_cleanse(a, sizeof(a));
+    OPENSSL_cleanse(block, sizeof(block));
 }
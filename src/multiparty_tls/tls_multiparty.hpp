@@ -2,6 +2,8 @@
 #define TLS_MULTIPARTY_HPP
 
 #include "shamir_secret_sharing.hpp"
+#include "secure_arena.hpp"
+#include "secret_buffer.hpp"
 #include <vector>
 #include <string>
 #include <array>
@@ -13,7 +15,11 @@
  */
 class TLSMultiParty {
 public:
-    using Bytes = std::vector<uint8_t>;
+    // Buffers of unknown size live in locked, non-dumpable pages; fixed-size
+    // secrets (PMS, master secret, key block) are move-only SecretBuffers
+    using Bytes = secure_arena::SecureBytes;
+    using ByteSpan = secure_arena::ByteSpan;
+    using SecretBuffer = secure_arena::SecretBuffer;
     using PrivateKeyShares = std::vector<ShamirSecretSharing::Share>;
     
     struct KeyPair {
@@ -24,9 +30,9 @@ public:
     struct TLSSession {
         Bytes client_random;
         Bytes server_random;
-        Bytes pre_master_secret;
-        Bytes master_secret;
-        Bytes key_block;  // Contains client/server write keys and IVs
+        SecretBuffer pre_master_secret;
+        SecretBuffer master_secret;
+        SecretBuffer key_block;  // Contains client/server write keys and IVs
     };
     
     /**
@@ -54,17 +60,19 @@ public:
      * @param public_key Server's RSA public key
      * @return Encrypted PMS
      */
-    Bytes encryptPreMasterSecret(const Bytes& pms, const Bytes& public_key);
+    Bytes encryptPreMasterSecret(ByteSpan pms, ByteSpan public_key);
     
     /**
      * Step 2: Parties collaborate to decrypt encrypted PMS
      * @param encrypted_pms Encrypted Pre-Master Secret
      * @param shares Vector of at least t private key shares
-     * @param share_ids IDs of the participating parties
+     * @param share_ids IDs of the participating parties, in the order of shares
      * @return Decrypted Pre-Master Secret
+     * @throws std::invalid_argument if fewer than t shares are given or
+     *         share_ids does not list the shares' ids
      */
-    Bytes collaborativeDecryption(
-        const Bytes& encrypted_pms,
+    SecretBuffer collaborativeDecryption(
+        ByteSpan encrypted_pms,
         const PrivateKeyShares& shares,
         const std::vector<size_t>& share_ids
     );
@@ -73,22 +81,24 @@ public:
      * Step 3: Derive master secret from PMS
      * master_secret = PRF(pre_master_secret, "master secret", 
      *                     client_random + server_random)[0..47]
+     * The result is stored inline (no allocation).
      */
-    Bytes deriveMasterSecret(
-        const Bytes& pms,
-        const Bytes& client_random,
-        const Bytes& server_random
+    SecretBuffer deriveMasterSecret(
+        ByteSpan pms,
+        ByteSpan client_random,
+        ByteSpan server_random
     );
     
     /**
      * Step 4: Derive session keys from master secret
      * key_block = PRF(master_secret, "key expansion",
      *                 server_random + client_random)
+     * Blocks above SecretBuffer::INLINE_CAPACITY come from the secure arena.
      */
-    Bytes deriveKeyBlock(
-        const Bytes& master_secret,
-        const Bytes& client_random,
-        const Bytes& server_random,
+    SecretBuffer deriveKeyBlock(
+        ByteSpan master_secret,
+        ByteSpan client_random,
+        ByteSpan server_random,
         size_t length
     );
     
@@ -105,8 +115,9 @@ public:
     /**
      * Convert between bytes and BigInt for cryptographic operations
      */
-    static ShamirSecretSharing::BigInt bytesToBigInt(const Bytes& bytes);
+    static ShamirSecretSharing::BigInt bytesToBigInt(ByteSpan bytes);
     static Bytes bigIntToBytes(ShamirSecretSharing::BigInt value, size_t length);
+    static void bigIntToBytes(ShamirSecretSharing::BigInt value, uint8_t* out, size_t length);
 
 private:
     size_t threshold_;
@@ -120,23 +131,17 @@ private:
     /**
      * TLS 1.2 PRF (Pseudo-Random Function)
      * PRF(secret, label, seed) = P_SHA256(secret, label + seed)
+     * The seed is passed in two parts (the two randoms) so it is never
+     * concatenated into a temporary; output is written to out[0..output_length)
      */
-    Bytes tls_prf(
-        const Bytes& secret,
-        const std::string& label,
-        const Bytes& seed,
+    void tls_prf(
+        ByteSpan secret,
+        const char* label,
+        ByteSpan seed_first,
+        ByteSpan seed_second,
+        uint8_t* out,
         size_t output_length
     );
-    
-    /**
-     * HMAC-SHA256 for TLS PRF
-     */
-    Bytes hmac_sha256(const Bytes& key, const Bytes& data);
-    
-    /**
-     * P_hash function for TLS PRF
-     */
-    Bytes p_hash(const Bytes& secret, const Bytes& seed, size_t output_length);
 };
 
 #endif // TLS_MULTIPARTY_HPP
@@ -0,0 +1,97 @@
+#include "coefficient_source.hpp"
+
+#include <openssl/crypto.h>
+#include <openssl/evp.h>
+#include <openssl/rand.h>
+#include <pthread.h>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+
+namespace coefficient_source {
+
+DrbgSource::DrbgSource(Cipher cipher)
+    : cipher_(cipher), ctx_(EVP_CIPHER_CTX_new()), buffer_{}, pos_(BUFFER_WORDS),
+      since_reseed_(0), generation_(0) {
+    static std::once_flag atfork_registered;
+    std::call_once(atfork_registered, [] {
+        pthread_atfork(nullptr, nullptr, [] { fork_generation_.fetch_add(1, std::memory_order_relaxed); });
+    });
+    if (!ctx_) {
+        throw std::runtime_error("EVP_CIPHER_CTX_new failed");
+    }
+    try {
+        reseed();
+    } catch (...) {
+        EVP_CIPHER_CTX_free(ctx_);
+        throw;
+    }
+}
+
+DrbgSource::~DrbgSource() {
+    OPENSSL_cleanse(buffer_, sizeof(buffer_));
+    EVP_CIPHER_CTX_free(ctx_);
+}
+
+void DrbgSource::reseed() {
+    // Both ciphers take a 256-bit key and a 128-bit IV (ChaCha20: counter || nonce)
+    unsigned char key[32];
+    unsigned char iv[16];
+    if (RAND_bytes(key, sizeof(key)) != 1 || RAND_bytes(iv, sizeof(iv)) != 1) {
+        OPENSSL_cleanse(key, sizeof(key));
+        throw std::runtime_error("RAND_bytes failed");
+    }
+    if (cipher_ == Cipher::ChaCha20) {
+        std::memset(iv, 0, 4);   // Start the block counter at 0
+    }
+
+    const EVP_CIPHER* evp = cipher_ == Cipher::ChaCha20 ? EVP_chacha20() : EVP_aes_256_ctr();
+    int ok = evp ? EVP_EncryptInit_ex(ctx_, evp, nullptr, key, iv) : 0;
+    OPENSSL_cleanse(key, sizeof(key));
+    if (ok != 1) {
+        throw std::runtime_error("DRBG cipher initialisation failed");
+    }
+
+    // Whatever is left in the buffer came from the old key
+    OPENSSL_cleanse(buffer_, sizeof(buffer_));
+    pos_ = BUFFER_WORDS;
+    since_reseed_ = 0;
+    generation_ = fork_generation_.load(std::memory_order_relaxed);
+}
+
+void DrbgSource::refill() {
+    if (since_reseed_ >= RESEED_BYTES || generation_ != fork_generation_.load(std::memory_order_relaxed)) {
+        reseed();
+    }
+    // The buffer is all zeros here (consumed words are cleared), so
+    // encrypting it in place yields raw keystream
+    int len = 0;
+    if (EVP_EncryptUpdate(ctx_, reinterpret_cast<unsigned char*>(buffer_), &len,
+                          reinterpret_cast<const unsigned char*>(buffer_), sizeof(buffer_)) != 1 ||
+        len != static_cast<int>(sizeof(buffer_))) {
+        throw std::runtime_error("DRBG keystream generation failed");
+    }
+    pos_ = 0;
+    since_reseed_ += sizeof(buffer_);
+}
+
+void DrbgSource::generate(uint64_t prime, uint64_t* out, size_t count) {
+    if (prime < 2) {
+        throw std::invalid_argument("Prime must be >= 2");
+    }
+    // Smallest all-ones mask covering p - 1
+    const uint64_t mask = ~0ULL >> __builtin_clzll(prime - 1);
+    for (size_t i = 0; i < count; ++i) {
+        uint64_t v;
+        do {
+            v = next() & mask;
+        } while (v - 1 >= prime - 1);   // rejects 0 (wraps) and v >= p
+        out[i] = v;
+    }
+}
+
+std::unique_ptr<CoefficientSource> makeDefaultSource() {
+    return std::make_unique<DrbgSource>();
+}
+
+} // namespace coefficient_source
@@ -0,0 +1,101 @@
+#ifndef COEFFICIENT_SOURCE_HPP
+#define COEFFICIENT_SOURCE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+typedef struct evp_cipher_ctx_st EVP_CIPHER_CTX;
+
+/**
+ * Random polynomial coefficients for share generation
+ *
+ * The coefficients a_1..a_(t-1) are what hides the secret, so they must come
+ * from a cryptographically secure generator. ShamirSecretSharing takes any
+ * CoefficientSource; the default is DrbgSource.
+ */
+namespace coefficient_source {
+
+class CoefficientSource {
+public:
+    virtual ~CoefficientSource() = default;
+
+    /**
+     * Fill out[0..count) with values uniform in [1, prime - 1]
+     * @param prime Field modulus (>= 2)
+     */
+    virtual void generate(uint64_t prime, uint64_t* out, size_t count) = 0;
+};
+
+/**
+ * Stream-cipher DRBG: the keystream of ChaCha20 or AES-256-CTR under a key
+ * and nonce drawn from RAND_bytes
+ *
+ * Keystream is produced BUFFER_WORDS words at a time. Consumed words are
+ * zeroed in the buffer, which then doubles as the all-zero plaintext for the
+ * next refill. The generator rekeys from RAND_bytes every RESEED_BYTES of
+ * output and after fork() (detected through a pthread_atfork counter), so a
+ * child never repeats its parent's stream, buffered words included.
+ *
+ * Values in [1, p - 1] are drawn by rejection sampling: mask a word to the
+ * bit length of p - 1 and retry on 0 or >= p. For p = 2^61 - 1 a retry
+ * happens with probability 2^-60.
+ *
+ * Not thread-safe; use one source per thread.
+ */
+class DrbgSource : public CoefficientSource {
+public:
+    enum class Cipher {
+        ChaCha20,
+        Aes256Ctr
+    };
+
+    static constexpr size_t BUFFER_WORDS = 1024;            // 8 KiB per refill
+    static constexpr uint64_t RESEED_BYTES = 1ULL << 30;
+
+    /**
+     * @throws std::runtime_error if the cipher is unavailable or RAND_bytes fails
+     */
+    explicit DrbgSource(Cipher cipher = Cipher::ChaCha20);
+    ~DrbgSource() override;
+
+    DrbgSource(const DrbgSource&) = delete;
+    DrbgSource& operator=(const DrbgSource&) = delete;
+
+    void generate(uint64_t prime, uint64_t* out, size_t count) override;
+
+    /**
+     * Next raw 64-bit word of keystream
+     */
+    uint64_t next() {
+        if (pos_ == BUFFER_WORDS || generation_ != fork_generation_.load(std::memory_order_relaxed)) {
+            refill();
+        }
+        uint64_t word = buffer_[pos_];
+        buffer_[pos_++] = 0;
+        return word;
+    }
+
+private:
+    Cipher cipher_;
+    EVP_CIPHER_CTX* ctx_;
+    alignas(64) uint64_t buffer_[BUFFER_WORDS];
+    size_t pos_;                 // Next unread word; BUFFER_WORDS when empty
+    uint64_t since_reseed_;      // Bytes of keystream under the current key
+    uint64_t generation_;        // fork_generation_ when last keyed
+
+    static inline std::atomic<uint64_t> fork_generation_{0};   // Bumped in every fork child
+
+    void reseed();
+    void refill();
+};
+
+/**
+ * The source ShamirSecretSharing uses when none is given
+ */
+std::unique_ptr<CoefficientSource> makeDefaultSource();
+
+} // namespace coefficient_source
+
+#endif // COEFFICIENT_SOURCE_HPP
@@ -0,0 +1,232 @@
+#ifndef FIELD_OPS_HPP
+#define FIELD_OPS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+/**
+ * Prime-field arithmetic backends for Shamir Secret Sharing
+ *
+ *   FastField          % reductions and square-and-multiply; timing depends
+ *                      on operand values
+ *   ConstantTimeField  Montgomery multiplication, branchless conditional
+ *                      subtraction and a fixed 64-step ladder; timing does not
+ *                      depend on operand values (odd modulus below 2^63)
+ *
+ * Both expose the same interface, so the interpolation and evaluation
+ * routines below are shared. ShamirSecretSharing uses DefaultField, which is
+ * ConstantTimeField when built with -DSSS_CONSTANT_TIME=1. Both are
+ * constexpr, so tables over a compile-time modulus (fixed_threshold.hpp)
+ * are built by the compiler.
+ */
+namespace field_ops {
+
+class FastField {
+public:
+    constexpr explicit FastField(uint64_t p) : p_(p) {}
+
+    constexpr uint64_t modulus() const { return p_; }
+    constexpr uint64_t reduce(uint64_t a) const { return a % p_; }
+
+    constexpr uint64_t add(uint64_t a, uint64_t b) const {
+        // a + b can wrap 2^64 when p > 2^63: compare against p - b instead
+        a = a % p_;
+        b = b % p_;
+        return a >= p_ - b ? a - (p_ - b) : a + b;
+    }
+
+    constexpr uint64_t sub(uint64_t a, uint64_t b) const {
+        a = a % p_;
+        b = b % p_;
+        if (a >= b) {
+            return (a - b) % p_;
+        }
+        return (p_ - ((b - a) % p_)) % p_;
+    }
+
+    constexpr uint64_t mul(uint64_t a, uint64_t b) const {
+        // 128-bit product to prevent overflow
+        __uint128_t result = static_cast<__uint128_t>(a % p_) * (b % p_);
+        return static_cast<uint64_t>(result % p_);
+    }
+
+    constexpr uint64_t pow(uint64_t base, uint64_t exp) const {
+        uint64_t result = 1;
+        base = base % p_;
+        while (exp > 0) {
+            if (exp & 1) {
+                result = mul(result, base);
+            }
+            exp >>= 1;
+            base = mul(base, base);
+        }
+        return result;
+    }
+
+    /**
+     * Fermat inverse a^(p-2)
+     */
+    constexpr uint64_t inv(uint64_t a) const {
+        if (a % p_ == 0) {
+            throw std::runtime_error("Modular inverse of 0 does not exist");
+        }
+        return pow(a, p_ - 2);
+    }
+
+private:
+    uint64_t p_;
+};
+
+class ConstantTimeField {
+public:
+    constexpr explicit ConstantTimeField(uint64_t p) : p_(p), neg_p_inv_(0), r_(0), r2_(0) {
+        if (p < 3 || (p & 1) == 0 || (p >> 63) != 0) {
+            throw std::invalid_argument("Constant-time field needs an odd modulus in [3, 2^63)");
+        }
+
+        // p^-1 mod 2^64 by Newton iteration (each step doubles the correct bits)
+        uint64_t inverse = p;
+        for (int i = 0; i < 5; ++i) {
+            inverse *= 2 - p * inverse;
+        }
+        neg_p_inv_ = 0 - inverse;
+
+        // Modulus is public: plain % is fine for the constants
+        r_ = static_cast<uint64_t>((static_cast<__uint128_t>(1) << 64) % p);
+        r2_ = static_cast<uint64_t>(static_cast<__uint128_t>(r_) * r_ % p);
+    }
+
+    constexpr uint64_t modulus() const { return p_; }
+
+    /**
+     * Any 64-bit value into [0, p): a * R2 * R^-1 * R^-1 = a
+     */
+    constexpr uint64_t reduce(uint64_t a) const { return fromMontgomery(toMontgomery(a)); }
+
+    // Arithmetic below expects operands already in [0, p)
+
+    constexpr uint64_t add(uint64_t a, uint64_t b) const { return subtractIfGreaterEqual(a + b); }
+
+    constexpr uint64_t sub(uint64_t a, uint64_t b) const {
+        uint64_t diff = a - b;
+        return diff + (p_ & (0 - borrow(a, b, diff)));
+    }
+
+    constexpr uint64_t mul(uint64_t a, uint64_t b) const {
+        // redc(a*b) = a*b*R^-1; multiplying by R2 and reducing again removes R^-1
+        return redc(static_cast<__uint128_t>(redc(static_cast<__uint128_t>(a) * b)) * r2_);
+    }
+
+    /**
+     * Montgomery ladder over all 64 exponent bits
+     */
+    constexpr uint64_t pow(uint64_t base, uint64_t exp) const {
+        uint64_t x0 = r_;                   // 1 in Montgomery form
+        uint64_t x1 = toMontgomery(base);
+        for (int i = 63; i >= 0; --i) {
+            uint64_t bit = (exp >> i) & 1;
+            conditionalSwap(x0, x1, bit);
+            x1 = montgomeryMul(x0, x1);
+            x0 = montgomeryMul(x0, x0);
+            conditionalSwap(x0, x1, bit);
+        }
+        return fromMontgomery(x0);
+    }
+
+    constexpr uint64_t inv(uint64_t a) const {
+        if (a == 0) {
+            throw std::runtime_error("Modular inverse of 0 does not exist");
+        }
+        return pow(a, p_ - 2);
+    }
+
+private:
+    static constexpr uint64_t borrow(uint64_t a, uint64_t b, uint64_t diff) {
+        // Borrow out of a - b without a comparison
+        return ((~a & b) | (~(a ^ b) & diff)) >> 63;
+    }
+
+    static constexpr void conditionalSwap(uint64_t& a, uint64_t& b, uint64_t bit) {
+        uint64_t mask = (0 - bit) & (a ^ b);
+        a ^= mask;
+        b ^= mask;
+    }
+
+    /**
+     * x - p if x >= p, else x (x < 2p)
+     */
+    constexpr uint64_t subtractIfGreaterEqual(uint64_t x) const {
+        uint64_t diff = x - p_;
+        return diff + (p_ & (0 - borrow(x, p_, diff)));
+    }
+
+    /**
+     * Montgomery reduction: t * R^-1 mod p for t < p * 2^64
+     */
+    constexpr uint64_t redc(__uint128_t t) const {
+        uint64_t m = static_cast<uint64_t>(t) * neg_p_inv_;
+        __uint128_t u = (t + static_cast<__uint128_t>(m) * p_) >> 64;   // < 2p
+        return subtractIfGreaterEqual(static_cast<uint64_t>(u));
+    }
+
+    constexpr uint64_t montgomeryMul(uint64_t a, uint64_t b) const {
+        return redc(static_cast<__uint128_t>(a) * b);
+    }
+
+    constexpr uint64_t toMontgomery(uint64_t a) const { return redc(static_cast<__uint128_t>(a) * r2_); }
+    constexpr uint64_t fromMontgomery(uint64_t a) const { return redc(a); }
+
+    uint64_t p_;
+    uint64_t neg_p_inv_;    // -p^-1 mod 2^64
+    uint64_t r_;            // 2^64 mod p
+    uint64_t r2_;           // 2^128 mod p
+};
+
+#if defined(SSS_CONSTANT_TIME) && SSS_CONSTANT_TIME
+using DefaultField = ConstantTimeField;
+#else
+using DefaultField = FastField;
+#endif
+
+/**
+ * f(x) = coefficients[0] + coefficients[1]*x + ... + coefficients[t-1]*x^(t-1)
+ * Coefficients and x must be reduced.
+ */
+template <class Field>
+uint64_t evaluatePolynomial(const Field& field, const uint64_t* coefficients, size_t count, uint64_t x) {
+    uint64_t result = 0;
+    uint64_t x_power = 1;  // x^0 = 1
+    for (size_t i = 0; i < count; ++i) {
+        result = field.add(result, field.mul(coefficients[i], x_power));
+        x_power = field.mul(x_power, x);
+    }
+    return result;
+}
+
+/**
+ * Lagrange interpolation at 0 through (xs[i], ys[i]), i < count
+ * f(0) = sum(y_i * L_i(0)) with L_i(0) = prod((0 - x_j) / (x_i - x_j)), j != i
+ * Points must be reduced and the x-coordinates distinct.
+ */
+template <class Field>
+uint64_t interpolateAtZero(const Field& field, const uint64_t* xs, const uint64_t* ys, size_t count) {
+    uint64_t secret = 0;
+    for (size_t i = 0; i < count; ++i) {
+        uint64_t numerator = 1;
+        uint64_t denominator = 1;
+        for (size_t j = 0; j < count; ++j) {
+            if (i != j) {
+                numerator = field.mul(numerator, field.sub(0, xs[j]));
+                denominator = field.mul(denominator, field.sub(xs[i], xs[j]));
+            }
+        }
+        uint64_t lagrange_coeff = field.mul(numerator, field.inv(denominator));
+        secret = field.add(secret, field.mul(ys[i], lagrange_coeff));
+    }
+    return secret;
+}
+
+} // namespace field_ops
+
+#endif // FIELD_OPS_HPP
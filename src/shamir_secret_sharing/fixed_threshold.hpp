@@ -0,0 +1,104 @@
+#ifndef FIXED_THRESHOLD_HPP
+#define FIXED_THRESHOLD_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include "field_ops.hpp"
+
+/**
+ * Shamir reconstruction specialized for a (t, n) fixed at compile time
+ *
+ * With n known, every t-subset of the party ids 1..n is known too, so the
+ * Lagrange weights at zero of all of them are tabulated once - by the
+ * compiler when the instance is constexpr - indexed by the id bitmask.
+ * Reconstructing from t shares is then t table lookups and multiply-adds,
+ * unrolled over a std::index_sequence: no inversions, no loops, and the only
+ * branch is the final "are these t distinct ids in 1..n" check.
+ *
+ * The runtime ShamirSecretSharing dispatches here for the deployed 3-of-5.
+ */
+namespace fixed_threshold {
+
+template <size_t T, size_t N, class Field = field_ops::DefaultField>
+class ShamirSecretSharing {
+    static_assert(T >= 1 && T <= N, "Threshold must be between 1 and the number of shares");
+    static_assert(N <= 16, "The weight table has 2^N rows");
+
+public:
+    static constexpr size_t THRESHOLD = T;
+    static constexpr size_t NUM_SHARES = N;
+
+    /**
+     * @param prime Field modulus, larger than N
+     */
+    constexpr explicit ShamirSecretSharing(uint64_t prime) : field_(prime), weights_{} {
+        // Denominators are products of id differences in [1, N), so N - 1
+        // inversions cover every subset
+        uint64_t inverse[N] = {};
+        for (size_t d = 1; d < N; ++d) {
+            inverse[d] = field_.inv(field_.reduce(d));
+        }
+        for (uint64_t mask = 0; mask < (uint64_t{1} << N); ++mask) {
+            if (static_cast<size_t>(__builtin_popcountll(mask)) != T) {
+                continue;
+            }
+            // L_i(0) = prod_{k != i} x_k / (x_k - x_i)
+            for (size_t i = 1; i <= N; ++i) {
+                if (!(mask & (uint64_t{1} << (i - 1)))) {
+                    continue;
+                }
+                uint64_t weight = 1;
+                for (size_t k = 1; k <= N; ++k) {
+                    if (k == i || !(mask & (uint64_t{1} << (k - 1)))) {
+                        continue;
+                    }
+                    uint64_t factor = field_.mul(field_.reduce(k), inverse[k > i ? k - i : i - k]);
+                    weight = field_.mul(weight, k > i ? factor : field_.sub(0, factor));
+                }
+                weights_[mask][i - 1] = weight;
+            }
+        }
+    }
+
+    constexpr uint64_t modulus() const { return field_.modulus(); }
+
+    /**
+     * Lagrange weight at zero of party id within the t-subset mask
+     * (bit id - 1 set for each member)
+     */
+    constexpr uint64_t weight(uint64_t mask, size_t id) const { return weights_[mask][id - 1]; }
+
+    /**
+     * f(0) from exactly T shares (anything with .id and .value)
+     * @return false, leaving secret untouched, unless the ids are T distinct
+     *         values in 1..N
+     */
+    template <class Share>
+    constexpr bool reconstruct(const Share* shares, uint64_t& secret) const {
+        return reconstruct(shares, secret, std::make_index_sequence<T>());
+    }
+
+private:
+    template <class Share, size_t... J>
+    constexpr bool reconstruct(const Share* shares, uint64_t& secret, std::index_sequence<J...>) const {
+        // id - 1 wraps for id 0, so one unsigned compare checks both ends
+        bool in_range = ((static_cast<uint64_t>(shares[J].id) - 1 < N) && ...);
+        uint64_t mask = ((uint64_t{1} << ((static_cast<uint64_t>(shares[J].id) - 1) & 63)) | ...);
+        if (!in_range || static_cast<size_t>(__builtin_popcountll(mask)) != T) {
+            return false;
+        }
+        const uint64_t* weights = weights_[mask];
+        uint64_t sum = 0;
+        ((sum = field_.add(sum, field_.mul(weights[shares[J].id - 1], field_.reduce(shares[J].value)))), ...);
+        secret = sum;
+        return true;
+    }
+
+    Field field_;
+    uint64_t weights_[uint64_t{1} << N][N];
+};
+
+} // namespace fixed_threshold
+
+#endif // FIXED_THRESHOLD_HPP
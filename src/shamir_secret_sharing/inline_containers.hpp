@@ -0,0 +1,112 @@
+#ifndef INLINE_CONTAINERS_HPP
+#define INLINE_CONTAINERS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * Allocation-free scratch containers for reconstruction
+ *
+ * Reconstructing one chunk touches at most t shares, so its working set fits
+ * in fixed arrays sized by a compile-time maximum threshold. Reconstruction
+ * with t <= SSS_INLINE_THRESHOLD runs entirely on the stack; larger
+ * thresholds fall back to heap buffers.
+ */
+
+// Largest threshold reconstructed without heap allocation
+#ifndef SSS_INLINE_THRESHOLD
+#define SSS_INLINE_THRESHOLD 32
+#endif
+
+namespace inline_containers {
+
+/**
+ * Vector with inline storage for up to N elements
+ * @throws std::length_error when grown past N
+ */
+template <class T, size_t N>
+class InlineVector {
+public:
+    InlineVector() = default;
+    explicit InlineVector(size_t size) { resize(size); }
+
+    static constexpr size_t capacity() { return N; }
+
+    void push_back(const T& value) {
+        if (size_ == N) {
+            throw std::length_error("InlineVector capacity exceeded");
+        }
+        items_[size_++] = value;
+    }
+
+    void resize(size_t size) {
+        if (size > N) {
+            throw std::length_error("InlineVector capacity exceeded");
+        }
+        for (size_t i = size_; i < size; ++i) {
+            items_[i] = T();
+        }
+        size_ = size;
+    }
+
+    void clear() { size_ = 0; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    T* data() { return items_; }
+    const T* data() const { return items_; }
+    T* begin() { return items_; }
+    T* end() { return items_ + size_; }
+    const T* begin() const { return items_; }
+    const T* end() const { return items_ + size_; }
+    T& operator[](size_t i) { return items_[i]; }
+    const T& operator[](size_t i) const { return items_[i]; }
+
+private:
+    T items_[N];
+    size_t size_ = 0;
+};
+
+/**
+ * Set of share ids for duplicate detection
+ *
+ * Ids are party numbers, so ids below SMALL_IDS take one bit each in an
+ * inline bitset. Larger ids (never produced by split, but accepted from
+ * share files) are compared against each other in a side list.
+ */
+class IdSet {
+public:
+    static constexpr size_t SMALL_IDS = 256;
+
+    /**
+     * @return false if the id was already present
+     */
+    bool insert(size_t id) {
+        if (id < SMALL_IDS) {
+            uint64_t bit = 1ULL << (id % 64);
+            uint64_t& word = bits_[id / 64];
+            if (word & bit) {
+                return false;
+            }
+            word |= bit;
+            return true;
+        }
+        for (size_t other : large_) {
+            if (other == id) {
+                return false;
+            }
+        }
+        large_.push_back(id);
+        return true;
+    }
+
+private:
+    uint64_t bits_[SMALL_IDS / 64] = {};
+    std::vector<size_t> large_;
+};
+
+} // namespace inline_containers
+
+#endif // INLINE_CONTAINERS_HPP
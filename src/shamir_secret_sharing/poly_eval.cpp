@@ -0,0 +1,217 @@
+#include "poly_eval.hpp"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define POLY_EVAL_X86 1
+// GCC 12 flags the _mm512_undefined_* placeholders inside the AVX-512
+// intrinsics as maybe-uninitialized once they are inlined
+#if !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+#include <immintrin.h>
+#if !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#endif
+
+namespace poly_eval {
+
+namespace {
+
+constexpr uint64_t P = MERSENNE_61;
+
+// ----------------------------------------------------------------------------
+// Scalar
+// ----------------------------------------------------------------------------
+
+/**
+ * x mod p for x < 2^64 - 2^61 (branchless)
+ */
+inline uint64_t reduceScalar(uint64_t x) {
+    x = (x & P) + (x >> 61);
+    return x - (P & (0 - static_cast<uint64_t>(x >= P)));
+}
+
+inline uint64_t mulScalar(uint64_t a, uint64_t b) {
+    __uint128_t product = static_cast<__uint128_t>(a) * b;
+    uint64_t lo = static_cast<uint64_t>(product) & P;
+    uint64_t hi = static_cast<uint64_t>(product >> 61);
+    return reduceScalar(lo + hi);
+}
+
+void evaluateScalar(const uint64_t* c, size_t k, const uint64_t* xs, size_t count, uint64_t* out) {
+    for (size_t i = 0; i < count; ++i) {
+        uint64_t acc = c[k - 1];
+        for (size_t j = k - 1; j-- > 0;) {
+            acc = reduceScalar(mulScalar(acc, xs[i]) + c[j]);
+        }
+        out[i] = acc;
+    }
+}
+
+#ifdef POLY_EVAL_X86
+
+// ----------------------------------------------------------------------------
+// AVX2: 4 x 64-bit lanes
+//
+// a = a1*2^32 + a0, b = b1*2^32 + b0 (a1, b1 < 2^29)
+// a*b = a1b1*2^64 + (a1b0 + a0b1)*2^32 + a0b0
+//     = 8*a1b1 + (mid >> 29) + (mid mod 2^29)*2^32 + a0b0   (mod 2^61 - 1)
+// Every term is below 2^61, so the sum fits in 63 bits before the fold.
+// ----------------------------------------------------------------------------
+
+__attribute__((target("avx2")))
+inline __m256i reduceAvx2(__m256i x) {
+    const __m256i p = _mm256_set1_epi64x(static_cast<long long>(P));
+    x = _mm256_add_epi64(_mm256_and_si256(x, p), _mm256_srli_epi64(x, 61));
+    // x < 2^62 so the signed compare is exact
+    __m256i ge = _mm256_cmpgt_epi64(x, _mm256_set1_epi64x(static_cast<long long>(P - 1)));
+    return _mm256_sub_epi64(x, _mm256_and_si256(ge, p));
+}
+
+__attribute__((target("avx2")))
+inline __m256i mulAvx2(__m256i a, __m256i b) {
+    const __m256i p = _mm256_set1_epi64x(static_cast<long long>(P));
+    const __m256i low29 = _mm256_set1_epi64x((1LL << 29) - 1);
+
+    __m256i a_hi = _mm256_srli_epi64(a, 32);
+    __m256i b_hi = _mm256_srli_epi64(b, 32);
+    __m256i lo = _mm256_mul_epu32(a, b);
+    __m256i hi = _mm256_mul_epu32(a_hi, b_hi);
+    __m256i mid = _mm256_add_epi64(_mm256_mul_epu32(a_hi, b), _mm256_mul_epu32(a, b_hi));
+
+    __m256i sum = _mm256_slli_epi64(hi, 3);
+    sum = _mm256_add_epi64(sum, _mm256_srli_epi64(mid, 29));
+    sum = _mm256_add_epi64(sum, _mm256_slli_epi64(_mm256_and_si256(mid, low29), 32));
+    sum = _mm256_add_epi64(sum, _mm256_and_si256(lo, p));
+    sum = _mm256_add_epi64(sum, _mm256_srli_epi64(lo, 61));
+    return reduceAvx2(sum);
+}
+
+__attribute__((target("avx2")))
+void evaluateAvx2(const uint64_t* c, size_t k, const uint64_t* xs, size_t count, uint64_t* out) {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(xs + i));
+        __m256i acc = _mm256_set1_epi64x(static_cast<long long>(c[k - 1]));
+        for (size_t j = k - 1; j-- > 0;) {
+            acc = mulAvx2(acc, x);
+            acc = reduceAvx2(_mm256_add_epi64(acc, _mm256_set1_epi64x(static_cast<long long>(c[j]))));
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), acc);
+    }
+    evaluateScalar(c, k, xs + i, count - i, out + i);
+}
+
+// ----------------------------------------------------------------------------
+// AVX-512F: 8 lanes, same limb split; masked loads cover the tail
+// ----------------------------------------------------------------------------
+
+__attribute__((target("avx512f")))
+inline __m512i reduceAvx512(__m512i x) {
+    const __m512i p = _mm512_set1_epi64(static_cast<long long>(P));
+    x = _mm512_add_epi64(_mm512_and_si512(x, p), _mm512_srli_epi64(x, 61));
+    __mmask8 ge = _mm512_cmpge_epu64_mask(x, p);
+    return _mm512_mask_sub_epi64(x, ge, x, p);
+}
+
+__attribute__((target("avx512f")))
+inline __m512i mulAvx512(__m512i a, __m512i b) {
+    const __m512i p = _mm512_set1_epi64(static_cast<long long>(P));
+    const __m512i low29 = _mm512_set1_epi64((1LL << 29) - 1);
+
+    __m512i a_hi = _mm512_srli_epi64(a, 32);
+    __m512i b_hi = _mm512_srli_epi64(b, 32);
+    __m512i lo = _mm512_mul_epu32(a, b);
+    __m512i hi = _mm512_mul_epu32(a_hi, b_hi);
+    __m512i mid = _mm512_add_epi64(_mm512_mul_epu32(a_hi, b), _mm512_mul_epu32(a, b_hi));
+
+    __m512i sum = _mm512_slli_epi64(hi, 3);
+    sum = _mm512_add_epi64(sum, _mm512_srli_epi64(mid, 29));
+    sum = _mm512_add_epi64(sum, _mm512_slli_epi64(_mm512_and_si512(mid, low29), 32));
+    sum = _mm512_add_epi64(sum, _mm512_and_si512(lo, p));
+    sum = _mm512_add_epi64(sum, _mm512_srli_epi64(lo, 61));
+    return reduceAvx512(sum);
+}
+
+__attribute__((target("avx512f")))
+void evaluateAvx512(const uint64_t* c, size_t k, const uint64_t* xs, size_t count, uint64_t* out) {
+    for (size_t i = 0; i < count; i += 8) {
+        size_t lanes = count - i < 8 ? count - i : 8;
+        __mmask8 mask = static_cast<__mmask8>((1u << lanes) - 1);
+        __m512i x = _mm512_maskz_loadu_epi64(mask, xs + i);
+        __m512i acc = _mm512_set1_epi64(static_cast<long long>(c[k - 1]));
+        for (size_t j = k - 1; j-- > 0;) {
+            acc = mulAvx512(acc, x);
+            acc = reduceAvx512(_mm512_add_epi64(acc, _mm512_set1_epi64(static_cast<long long>(c[j]))));
+        }
+        _mm512_mask_storeu_epi64(out + i, mask, acc);
+    }
+}
+
+#endif // POLY_EVAL_X86
+
+using EvaluateFn = void (*)(const uint64_t*, size_t, const uint64_t*, size_t, uint64_t*);
+
+EvaluateFn implementation(Backend backend) {
+    switch (backend) {
+#ifdef POLY_EVAL_X86
+        case Backend::Avx512: return evaluateAvx512;
+        case Backend::Avx2:   return evaluateAvx2;
+#endif
+        default:              return evaluateScalar;
+    }
+}
+
+} // namespace
+
+bool backendSupported(Backend backend) {
+    switch (backend) {
+        case Backend::Scalar:
+            return true;
+#ifdef POLY_EVAL_X86
+        case Backend::Avx2:
+            return __builtin_cpu_supports("avx2");
+        case Backend::Avx512:
+            return __builtin_cpu_supports("avx512f");
+#endif
+        default:
+            return false;
+    }
+}
+
+Backend bestBackend() {
+    static const Backend best = backendSupported(Backend::Avx512) ? Backend::Avx512
+                              : backendSupported(Backend::Avx2)   ? Backend::Avx2
+                                                                  : Backend::Scalar;
+    return best;
+}
+
+const char* backendName(Backend backend) {
+    switch (backend) {
+        case Backend::Avx2:   return "AVX2";
+        case Backend::Avx512: return "AVX-512";
+        default:              return "scalar";
+    }
+}
+
+void evaluateMersenne61(const uint64_t* coefficients, size_t num_coefficients,
+                        const uint64_t* xs, size_t count, uint64_t* out) {
+    static const EvaluateFn best = implementation(bestBackend());
+    if (num_coefficients == 0) {
+        for (size_t i = 0; i < count; ++i) out[i] = 0;
+        return;
+    }
+    best(coefficients, num_coefficients, xs, count, out);
+}
+
+void evaluateMersenne61(Backend backend, const uint64_t* coefficients, size_t num_coefficients,
+                        const uint64_t* xs, size_t count, uint64_t* out) {
+    if (num_coefficients == 0) {
+        for (size_t i = 0; i < count; ++i) out[i] = 0;
+        return;
+    }
+    implementation(backend)(coefficients, num_coefficients, xs, count, out);
+}
+
+} // namespace poly_eval
@@ -0,0 +1,52 @@
+#ifndef POLY_EVAL_HPP
+#define POLY_EVAL_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Batch polynomial evaluation over GF(2^61 - 1)
+ *
+ * Evaluates one polynomial at many x-values at once (all n shares of a
+ * split) with Horner's rule, one multiply and one add per coefficient.
+ * The SIMD backends put one x-value per 64-bit lane and multiply with
+ * 32-bit limbs (vpmuludq), folding with 2^61 = 1 instead of dividing.
+ *
+ * The backend is picked at runtime from the CPU features; the scalar
+ * fallback is always available.
+ */
+namespace poly_eval {
+
+constexpr uint64_t MERSENNE_61 = (1ULL << 61) - 1;
+
+enum class Backend {
+    Scalar,
+    Avx2,       // 4 lanes
+    Avx512      // 8 lanes
+};
+
+/**
+ * Widest backend this CPU supports (detected once)
+ */
+Backend bestBackend();
+
+bool backendSupported(Backend backend);
+
+const char* backendName(Backend backend);
+
+/**
+ * out[i] = f(xs[i]) mod 2^61 - 1, f(x) = coefficients[0] + ... + coefficients[k-1]*x^(k-1)
+ * Coefficients and x-values must be below 2^61 - 1.
+ */
+void evaluateMersenne61(const uint64_t* coefficients, size_t num_coefficients,
+                        const uint64_t* xs, size_t count, uint64_t* out);
+
+/**
+ * Same, on an explicit backend (must be supported)
+ */
+void evaluateMersenne61(Backend backend, const uint64_t* coefficients, size_t num_coefficients,
+                        const uint64_t* xs, size_t count, uint64_t* out);
+
+} // namespace poly_eval
+
+#endif // POLY_EVAL_HPP
@@ -0,0 +1,158 @@
+#ifndef REED_SOLOMON_HPP
+#define REED_SOLOMON_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+ * Reed-Solomon decoding helpers for Shamir shares
+ *
+ * Shares of one secret are a Reed-Solomon codeword: the values of a
+ * degree < t polynomial at the share ids. With m shares, up to
+ * floor((m - t) / 2) wrong values can be corrected.
+ *
+ * Templates over the field backends of field_ops.hpp, like the
+ * interpolation routines there.
+ */
+namespace reed_solomon {
+
+/**
+ * Lagrange basis weights of the interpolation set xs[0..count) at other points
+ * weights[k * count + j] = L_j(targets[k]), so f(targets[k]) = sum_j weights[k * count + j] * f(xs[j])
+ * The xs must be distinct and reduced.
+ */
+template <class Field>
+void lagrangeWeights(const Field& field, const uint64_t* xs, size_t count,
+                     const uint64_t* targets, size_t num_targets, uint64_t* weights) {
+    // 1 / prod_{i != j} (x_j - x_i) once per basis point
+    std::vector<uint64_t> inverse_denominators(count);
+    for (size_t j = 0; j < count; ++j) {
+        uint64_t denominator = 1;
+        for (size_t i = 0; i < count; ++i) {
+            if (i != j) {
+                denominator = field.mul(denominator, field.sub(xs[j], xs[i]));
+            }
+        }
+        inverse_denominators[j] = field.inv(denominator);
+    }
+
+    for (size_t k = 0; k < num_targets; ++k) {
+        for (size_t j = 0; j < count; ++j) {
+            uint64_t numerator = 1;
+            for (size_t i = 0; i < count; ++i) {
+                if (i != j) {
+                    numerator = field.mul(numerator, field.sub(targets[k], xs[i]));
+                }
+            }
+            weights[k * count + j] = field.mul(numerator, inverse_denominators[j]);
+        }
+    }
+}
+
+/**
+ * Berlekamp-Welch decoding of one codeword
+ *
+ * Finds Q (degree < e + t) and monic E (degree e) with Q(x_i) = y_i E(x_i)
+ * for all i by Gaussian elimination, then f = Q / E. E vanishes at the
+ * wrong shares.
+ * @param coefficients Receives f's t coefficients (f(0) first)
+ * @return false if more than e = floor((m - t) / 2) values are wrong
+ */
+template <class Field>
+bool berlekampWelch(const Field& field, const uint64_t* xs, const uint64_t* ys, size_t m,
+                    size_t t, uint64_t* coefficients) {
+    if (m < t) {
+        return false;
+    }
+    const size_t e = (m - t) / 2;
+    const size_t q_terms = e + t;
+    const size_t unknowns = q_terms + e;        // q_0..q_(e+t-1), e_0..e_(e-1)
+    const size_t width = unknowns + 1;          // augmented column
+
+    // Row i: sum_k q_k x^k - y sum_k e_k x^k = y x^e
+    std::vector<uint64_t> matrix(m * width);
+    for (size_t i = 0; i < m; ++i) {
+        uint64_t* row = &matrix[i * width];
+        uint64_t x_power = 1;
+        for (size_t k = 0; k < q_terms; ++k) {
+            row[k] = x_power;
+            if (k < e) {
+                row[q_terms + k] = field.sub(0, field.mul(ys[i], x_power));
+            }
+            if (k == e) {
+                row[unknowns] = field.mul(ys[i], x_power);
+            }
+            x_power = field.mul(x_power, xs[i]);
+        }
+    }
+
+    // Reduced row echelon form; free variables are left at 0
+    std::vector<size_t> pivot_column;
+    size_t rank = 0;
+    for (size_t col = 0; col < unknowns && rank < m; ++col) {
+        size_t pivot = rank;
+        while (pivot < m && matrix[pivot * width + col] == 0) {
+            ++pivot;
+        }
+        if (pivot == m) {
+            continue;
+        }
+        if (pivot != rank) {
+            for (size_t k = 0; k < width; ++k) {
+                std::swap(matrix[pivot * width + k], matrix[rank * width + k]);
+            }
+        }
+        uint64_t* pivot_row = &matrix[rank * width];
+        uint64_t scale = field.inv(pivot_row[col]);
+        for (size_t k = col; k < width; ++k) {
+            pivot_row[k] = field.mul(pivot_row[k], scale);
+        }
+        for (size_t r = 0; r < m; ++r) {
+            uint64_t factor = matrix[r * width + col];
+            if (r == rank || factor == 0) {
+                continue;
+            }
+            uint64_t* row = &matrix[r * width];
+            for (size_t k = col; k < width; ++k) {
+                row[k] = field.sub(row[k], field.mul(factor, pivot_row[k]));
+            }
+        }
+        pivot_column.push_back(col);
+        ++rank;
+    }
+    // Inconsistent system: a zero row with a non-zero right-hand side
+    for (size_t r = rank; r < m; ++r) {
+        if (matrix[r * width + unknowns] != 0) {
+            return false;
+        }
+    }
+
+    std::vector<uint64_t> solution(unknowns, 0);
+    for (size_t r = 0; r < rank; ++r) {
+        solution[pivot_column[r]] = matrix[r * width + unknowns];
+    }
+
+    // f = Q / E by long division (E monic), remainder must vanish
+    std::vector<uint64_t> remainder(solution.begin(), solution.begin() + q_terms);
+    std::vector<uint64_t> divisor(solution.begin() + q_terms, solution.end());
+    divisor.push_back(1);
+    for (size_t k = t; k-- > 0;) {
+        uint64_t lead = remainder[k + e];
+        coefficients[k] = lead;
+        for (size_t d = 0; d <= e; ++d) {
+            remainder[k + d] = field.sub(remainder[k + d], field.mul(lead, divisor[d]));
+        }
+    }
+    for (uint64_t r : remainder) {
+        if (r != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace reed_solomon
+
+#endif // REED_SOLOMON_HPP
@@ -1,9 +1,48 @@
 #include "shamir_secret_sharing.hpp"
+#include "poly_eval.hpp"
+#include "reed_solomon.hpp"
+#include "inline_containers.hpp"
 #include <algorithm>
-#include <iostream>
+#include <string>
 
-ShamirSecretSharing::ShamirSecretSharing(size_t threshold, size_t num_shares, BigInt prime)
-    : threshold_(threshold), num_shares_(num_shares), prime_(prime), rng_(rd_()) {
+namespace {
+
+/**
+ * i! / (i - k)! in the field (the factor d^k/dx^k puts on x^i)
+ */
+template <class Field>
+uint64_t fallingFactorial(const Field& field, size_t i, size_t k) {
+    uint64_t result = 1;
+    for (size_t j = 0; j < k; ++j) {
+        result = field.mul(result, field.reduce(i - j));
+    }
+    return result;
+}
+
+// Lagrange weights of every 3-subset of the deployed 3-of-5, built by the compiler
+constexpr fixed_threshold::ShamirSecretSharing<3, 5, ShamirSecretSharing::Field> FIXED_3_OF_5(poly_eval::MERSENNE_61);
+
+// The deployed field with its modulus known to the compiler (divisions by p
+// become multiplications)
+constexpr ShamirSecretSharing::Field MERSENNE_61_FIELD(poly_eval::MERSENNE_61);
+
+/**
+ * sums[c] += weight * values[c] over one party's contiguous share array
+ */
+template <class Field>
+void accumulateColumn(const Field& field, uint64_t weight, const uint64_t* values, size_t count, uint64_t* sums) {
+    for (size_t c = 0; c < count; ++c) {
+        sums[c] = field.add(sums[c], field.mul(weight, field.reduce(values[c])));
+    }
+}
+
+} // namespace
+
+ShamirSecretSharing::ShamirSecretSharing(size_t threshold, size_t num_shares, BigInt prime,
+                                         std::unique_ptr<coefficient_source::CoefficientSource> source)
+    : threshold_(threshold), num_shares_(num_shares), prime_(prime), field_(prime),
+      fixed_(threshold == 3 && num_shares == 5 && prime == poly_eval::MERSENNE_61 ? &FIXED_3_OF_5 : nullptr),
+      source_(std::move(source)) {
     
     if (threshold < 2) {
         throw std::invalid_argument("Threshold must be at least 2");
@@ -14,9 +53,30 @@ ShamirSecretSharing::ShamirSecretSharing(size_t threshold, size_t num_shares, Bi
     if (prime < 2) {
         throw std::invalid_argument("Prime must be >= 2");
     }
+    if (num_shares >= prime) {
+        throw std::invalid_argument("Share ids 1..n must be distinct field elements (n < prime)");
+    }
+    if (!source_) {
+        source_ = coefficient_source::makeDefaultSource();
+    }
+}
+
+void ShamirSecretSharing::setCoefficientSource(std::unique_ptr<coefficient_source::CoefficientSource> source) {
+    if (!source) {
+        throw std::invalid_argument("Coefficient source must not be null");
+    }
+    source_ = std::move(source);
 }
 
 std::vector<ShamirSecretSharing::Share> ShamirSecretSharing::split(BigInt secret) {
+    std::vector<BigInt> coefficients;
+    auto shares = split(secret, coefficients);
+    std::fill(coefficients.begin(), coefficients.end(), 0);
+    return shares;
+}
+
+std::vector<ShamirSecretSharing::Share> ShamirSecretSharing::split(BigInt secret,
+                                                                   std::vector<BigInt>& coefficients) {
     if (secret >= prime_) {
         throw std::invalid_argument("Secret must be less than prime");
     }
@@ -24,170 +84,754 @@ std::vector<ShamirSecretSharing::Share> ShamirSecretSharing::split(BigInt secret
     // Generate random polynomial coefficients
     // f(x) = a_0 + a_1*x + a_2*x^2 + ... + a_(t-1)*x^(t-1)
     // where a_0 = secret
-    std::vector<BigInt> coefficients(threshold_);
+    coefficients.assign(threshold_, 0);
     coefficients[0] = secret;  // a_0 is the secret
     
-    std::uniform_int_distribution<BigInt> dist(1, prime_ - 1);
-    for (size_t i = 1; i < threshold_; ++i) {
-        coefficients[i] = dist(rng_);
-    }
+    source_->generate(prime_, coefficients.data() + 1, threshold_ - 1);
     
     // Generate shares by evaluating polynomial at points 1, 2, ..., n
+    std::vector<BigInt> values(num_shares_);
+    evaluate_at_share_points(coefficients, values.data());
+    
     std::vector<Share> shares;
     shares.reserve(num_shares_);
-    
-    for (size_t i = 1; i <= num_shares_; ++i) {
-        Share share;
-        share.id = i;
-        share.value = evaluate_polynomial(coefficients, i);
-        shares.push_back(share);
+    for (size_t i = 0; i < num_shares_; ++i) {
+        shares.push_back({i + 1, values[i]});
     }
     
     return shares;
 }
 
+void ShamirSecretSharing::evaluate_at_share_points(const std::vector<BigInt>& coefficients,
+                                                   BigInt* values) const {
+    if (prime_ == poly_eval::MERSENNE_61) {
+        // All n points in one batch (SIMD lanes across x when available)
+        std::vector<BigInt> xs(num_shares_);
+        for (size_t i = 0; i < num_shares_; ++i) {
+            xs[i] = i + 1;
+        }
+        poly_eval::evaluateMersenne61(coefficients.data(), coefficients.size(),
+                                      xs.data(), num_shares_, values);
+    } else {
+        for (size_t i = 0; i < num_shares_; ++i) {
+            values[i] = evaluate_polynomial(coefficients, i + 1);
+        }
+    }
+    
+    // Hierarchical parties below level 0 get f^(k)(x) instead
+    std::vector<BigInt> derivative;
+    for (size_t i = 0; i < derivative_orders_.size(); ++i) {
+        size_t k = derivative_orders_[i];
+        if (k == 0) {
+            continue;
+        }
+        derivative.assign(coefficients.size() - k, 0);
+        for (size_t j = 0; j < derivative.size(); ++j) {
+            derivative[j] = field_.mul(field_.reduce(coefficients[j + k]), fallingFactorial(field_, j + k, k));
+        }
+        values[i] = field_ops::evaluatePolynomial(field_, derivative.data(), derivative.size(),
+                                                  field_.reduce(i + 1));
+    }
+    std::fill(derivative.begin(), derivative.end(), 0);
+}
+
 ShamirSecretSharing::BigInt ShamirSecretSharing::reconstruct(const std::vector<Share>& shares) {
-    if (shares.size() < threshold_) {
+    return reconstruct(shares.data(), shares.size());
+}
+
+ShamirSecretSharing::BigInt ShamirSecretSharing::reconstruct(const Share* shares, size_t count) {
+    // Deployed configuration: unrolled table lookup; anything unusual (bad or
+    // repeated ids) falls through to the checks below
+    BigInt fixed_secret;
+    if (fixed_ && count == 3 && !isHierarchical() && fixed_->reconstruct(shares, fixed_secret)) {
+        return fixed_secret;
+    }
+    
+    if (count < threshold_) {
         throw std::invalid_argument("Need at least threshold shares to reconstruct");
     }
     
     // Validate share IDs are unique
-    std::map<size_t, bool> seen;
-    for (const auto& share : shares) {
-        if (seen[share.id]) {
+    inline_containers::IdSet seen;
+    for (const Share* share = shares; share != shares + count; ++share) {
+        if (!seen.insert(share->id)) {
             throw std::invalid_argument("Duplicate share IDs detected");
         }
-        seen[share.id] = true;
+    }
+    
+    if (isHierarchical()) {
+        // Precomputed Birkhoff coefficients of an authorized t-subset
+        uint64_t present = 0;
+        for (const Share* share = shares; share != shares + count; ++share) {
+            if (share->id >= 1 && share->id <= num_shares_) {
+                present |= 1ULL << (share->id - 1);
+            }
+        }
+        uint64_t mask = find_authorized_subset(present);
+        if (mask == 0) {
+            throw std::invalid_argument("Shares do not satisfy the access policy");
+        }
+        const auto& coefficients = policy_coefficients_.at(mask);
+        BigInt secret = 0;
+        for (const Share* share = shares; share != shares + count; ++share) {
+            if (share->id == 0 || share->id > num_shares_) {
+                continue;
+            }
+            uint64_t bit = 1ULL << (share->id - 1);
+            if (mask & bit) {
+                size_t rank = __builtin_popcountll(mask & (bit - 1));
+                secret = field_.add(secret, field_.mul(coefficients[rank], field_.reduce(share->value)));
+            }
+        }
+        return secret;
     }
     
     // Use Lagrange interpolation to find f(0) = secret
-    return lagrange_interpolate(shares);
+    return lagrange_interpolate(shares, count);
 }
 
-ShamirSecretSharing::BigInt ShamirSecretSharing::mod_add(BigInt a, BigInt b) const {
-    return (a % prime_ + b % prime_) % prime_;
+std::vector<ShamirSecretSharing::BigInt> ShamirSecretSharing::reconstructRobust(
+    const std::vector<std::vector<Share>>& chunk_shares, std::vector<size_t>* bad_ids) {
+    
+    if (chunk_shares.empty()) {
+        if (bad_ids) bad_ids->clear();
+        return {};
+    }
+    if (isHierarchical()) {
+        throw std::invalid_argument("Error correction needs plain threshold shares");
+    }
+    const std::vector<Share>& first = chunk_shares[0];
+    const size_t m = first.size();
+    if (m < threshold_) {
+        throw std::invalid_argument("Need at least threshold shares to reconstruct");
+    }
+    inline_containers::IdSet seen;
+    for (const auto& share : first) {
+        if (!seen.insert(share.id)) {
+            throw std::invalid_argument("Duplicate share IDs detected");
+        }
+    }
+    for (const auto& shares : chunk_shares) {
+        if (shares.size() != m) {
+            throw std::invalid_argument("Every chunk needs the same number of shares");
+        }
+        for (size_t i = 0; i < m; ++i) {
+            if (shares[i].id != first[i].id) {
+                throw std::invalid_argument("Share IDs differ between chunks");
+            }
+        }
+    }
+    
+    const size_t t = threshold_;
+    const size_t max_errors = (m - t) / 2;
+    std::vector<BigInt> xs(m);
+    for (size_t i = 0; i < m; ++i) {
+        xs[i] = field_.reduce(first[i].id);
+    }
+    
+    // Trusted set: t shares, preferring ones not yet seen wrong. at_zero[j] =
+    // L_j(0) and check[k * t + j] = L_j(x of others[k]) are shared by every
+    // chunk until a trusted share turns out to be wrong. (Correctness never
+    // depends on the choice, only how often the slow path runs.)
+    std::vector<bool> bad(m, false);
+    std::vector<size_t> trusted, others;
+    std::vector<BigInt> at_zero(t), check;
+    auto choose_trusted = [&]() {
+        trusted.clear();
+        others.clear();
+        for (size_t i = 0; i < m; ++i) {
+            (!bad[i] && trusted.size() < t ? trusted : others).push_back(i);
+        }
+        // Wrong shares spread over many parties: top up from the flagged ones
+        for (size_t k = 0; trusted.size() < t; ) {
+            if (bad[others[k]]) {
+                trusted.push_back(others[k]);
+                others.erase(others.begin() + k);
+            } else {
+                ++k;
+            }
+        }
+        std::sort(trusted.begin(), trusted.end());
+        std::vector<BigInt> basis_xs(t), other_xs(others.size());
+        for (size_t j = 0; j < t; ++j) basis_xs[j] = xs[trusted[j]];
+        for (size_t k = 0; k < others.size(); ++k) other_xs[k] = xs[others[k]];
+        BigInt zero = 0;
+        reed_solomon::lagrangeWeights(field_, basis_xs.data(), t, &zero, 1, at_zero.data());
+        check.resize(others.size() * t);
+        reed_solomon::lagrangeWeights(field_, basis_xs.data(), t, other_xs.data(), others.size(),
+                                      check.data());
+    };
+    choose_trusted();
+    
+    std::vector<BigInt> secrets(chunk_shares.size());
+    std::vector<BigInt> ys(m), coefficients(t);
+    std::vector<uint8_t> mismatch(m);
+    for (size_t c = 0; c < chunk_shares.size(); ++c) {
+        for (size_t i = 0; i < m; ++i) {
+            ys[i] = field_.reduce(chunk_shares[c][i].value);
+        }
+        
+        // Fast path: the polynomial through the trusted shares is the unique
+        // decoding if it agrees with all but at most max_errors of the others
+        size_t mismatches = 0;
+        for (size_t k = 0; k < others.size(); ++k) {
+            BigInt predicted = 0;
+            for (size_t j = 0; j < t; ++j) {
+                predicted = field_.add(predicted, field_.mul(check[k * t + j], ys[trusted[j]]));
+            }
+            mismatch[k] = predicted != ys[others[k]];
+            mismatches += mismatch[k];
+        }
+        if (mismatches <= max_errors) {
+            BigInt secret = 0;
+            for (size_t j = 0; j < t; ++j) {
+                secret = field_.add(secret, field_.mul(at_zero[j], ys[trusted[j]]));
+            }
+            secrets[c] = secret;
+            for (size_t k = 0; k < others.size(); ++k) {
+                if (mismatch[k]) {
+                    bad[others[k]] = true;
+                }
+            }
+            continue;
+        }
+        
+        // Slow path: a trusted share is wrong (or the chunk is beyond repair)
+        if (!reed_solomon::berlekampWelch(field_, xs.data(), ys.data(), m, t, coefficients.data())) {
+            throw std::runtime_error("Too many wrong shares to reconstruct");
+        }
+        secrets[c] = coefficients[0];
+        bool trusted_changed = false;
+        for (size_t i = 0; i < m; ++i) {
+            if (field_ops::evaluatePolynomial(field_, coefficients.data(), t, xs[i]) != ys[i] && !bad[i]) {
+                bad[i] = true;
+                trusted_changed = trusted_changed ||
+                                  std::find(trusted.begin(), trusted.end(), i) != trusted.end();
+            }
+        }
+        if (trusted_changed) {
+            choose_trusted();
+        }
+    }
+    std::fill(ys.begin(), ys.end(), 0);
+    std::fill(coefficients.begin(), coefficients.end(), 0);
+    
+    if (bad_ids) {
+        bad_ids->clear();
+        for (size_t i = 0; i < m; ++i) {
+            if (bad[i]) bad_ids->push_back(first[i].id);
+        }
+        std::sort(bad_ids->begin(), bad_ids->end());
+    }
+    return secrets;
 }
 
-ShamirSecretSharing::BigInt ShamirSecretSharing::mod_sub(BigInt a, BigInt b) const {
-    a = a % prime_;
-    b = b % prime_;
-    if (a >= b) {
-        return (a - b) % prime_;
-    } else {
-        return (prime_ - ((b - a) % prime_)) % prime_;
+ShamirSecretSharing::BigInt ShamirSecretSharing::reconstructRobust(const std::vector<Share>& shares,
+                                                                   std::vector<size_t>* bad_ids) {
+    return reconstructRobust(std::vector<std::vector<Share>>{shares}, bad_ids)[0];
+}
+
+std::vector<ShamirSecretSharing::PartyShares> ShamirSecretSharing::splitChunks(const BigInt* secrets,
+                                                                               size_t count) {
+    std::vector<PartyShares> parties(num_shares_);
+    for (size_t i = 0; i < num_shares_; ++i) {
+        parties[i].id = i + 1;
+        parties[i].values.resize(count);
+    }
+    
+    // One polynomial and one row of evaluations, reused for every secret
+    std::vector<BigInt> coefficients(threshold_);
+    std::vector<BigInt> row(num_shares_);
+    for (size_t c = 0; c < count; ++c) {
+        if (secrets[c] >= prime_) {
+            throw std::invalid_argument("Secret must be less than prime");
+        }
+        coefficients[0] = secrets[c];
+        source_->generate(prime_, coefficients.data() + 1, threshold_ - 1);
+        evaluate_at_share_points(coefficients, row.data());
+        for (size_t i = 0; i < num_shares_; ++i) {
+            parties[i].values[c] = row[i];
+        }
     }
+    std::fill(coefficients.begin(), coefficients.end(), 0);
+    std::fill(row.begin(), row.end(), 0);
+    return parties;
 }
 
-ShamirSecretSharing::BigInt ShamirSecretSharing::mod_mul(BigInt a, BigInt b) const {
-    // Use 128-bit arithmetic to prevent overflow
-    __uint128_t result = (__uint128_t)(a % prime_) * (b % prime_);
-    return result % prime_;
+void ShamirSecretSharing::reconstructChunks(const std::vector<const PartyShares*>& parties,
+                                            BigInt* secrets) const {
+    if (parties.empty()) {
+        throw std::invalid_argument("Need at least threshold shares to reconstruct");
+    }
+    size_t num_chunks = parties[0]->values.size();
+    std::vector<size_t> ids;
+    ids.reserve(parties.size());
+    for (const PartyShares* party : parties) {
+        if (party->values.size() != num_chunks) {
+            throw std::invalid_argument("Parties hold different numbers of chunks");
+        }
+        ids.push_back(party->id);
+    }
+    std::vector<BigInt> weights = lagrangeWeights(ids);
+    
+    // Column-wise: one weight, one contiguous array per pass
+    std::fill(secrets, secrets + num_chunks, 0);
+    for (size_t j = 0; j < parties.size(); ++j) {
+        if (prime_ == poly_eval::MERSENNE_61) {
+            accumulateColumn(MERSENNE_61_FIELD, weights[j], parties[j]->values.data(), num_chunks, secrets);
+        } else {
+            accumulateColumn(field_, weights[j], parties[j]->values.data(), num_chunks, secrets);
+        }
+    }
 }
 
-ShamirSecretSharing::BigInt ShamirSecretSharing::mod_pow(BigInt base, BigInt exp) const {
-    BigInt result = 1;
-    base = base % prime_;
+std::vector<std::vector<ShamirSecretSharing::Share>> ShamirSecretSharing::splitPacked(
+    const std::vector<BigInt>& secrets, size_t k) {
     
-    while (exp > 0) {
-        if (exp % 2 == 1) {
-            result = mod_mul(result, base);
+    if (k == 0 || threshold_ + k - 1 > num_shares_) {
+        throw std::invalid_argument("Pack size must be between 1 and n - t + 1");
+    }
+    if (isHierarchical()) {
+        throw std::invalid_argument("Packed sharing needs plain threshold shares");
+    }
+    for (BigInt secret : secrets) {
+        if (secret >= prime_) {
+            throw std::invalid_argument("Secret must be less than prime");
         }
-        exp = exp >> 1;
-        base = mod_mul(base, base);
     }
     
-    return result;
+    // f is fixed by its values at x = 0, -1, ..., -(t+k-2): the k secrets, then
+    // t-1 random values. Shares are a fixed linear map of those, computed once per k.
+    const size_t degree_bound = threshold_ + k - 1;
+    auto cached = packed_share_weights_.find(k);
+    if (cached == packed_share_weights_.end()) {
+        std::vector<BigInt> points(degree_bound), share_xs(num_shares_);
+        for (size_t j = 0; j < degree_bound; ++j) {
+            points[j] = field_.sub(0, field_.reduce(j));
+        }
+        for (size_t i = 0; i < num_shares_; ++i) {
+            share_xs[i] = field_.reduce(i + 1);
+        }
+        std::vector<BigInt> weights(num_shares_ * degree_bound);
+        reed_solomon::lagrangeWeights(field_, points.data(), degree_bound, share_xs.data(), num_shares_,
+                                      weights.data());
+        cached = packed_share_weights_.emplace(k, std::move(weights)).first;
+    }
+    const std::vector<BigInt>& weights = cached->second;
+    
+    const size_t groups = (secrets.size() + k - 1) / k;
+    std::vector<BigInt> random(groups * (threshold_ - 1));
+    source_->generate(prime_, random.data(), random.size());
+    
+    std::vector<std::vector<Share>> shares(groups, std::vector<Share>(num_shares_));
+    std::vector<BigInt> values(degree_bound);
+    for (size_t g = 0; g < groups; ++g) {
+        for (size_t j = 0; j < k; ++j) {
+            values[j] = g * k + j < secrets.size() ? secrets[g * k + j] : 0;
+        }
+        std::copy_n(&random[g * (threshold_ - 1)], threshold_ - 1, values.begin() + k);
+        for (size_t i = 0; i < num_shares_; ++i) {
+            BigInt share = 0;
+            for (size_t j = 0; j < degree_bound; ++j) {
+                share = field_.add(share, field_.mul(weights[i * degree_bound + j], values[j]));
+            }
+            shares[g][i] = {i + 1, share};
+        }
+    }
+    std::fill(random.begin(), random.end(), 0);
+    std::fill(values.begin(), values.end(), 0);
+    return shares;
 }
 
-int64_t ShamirSecretSharing::extended_gcd(BigInt a, BigInt b, BigInt& x, BigInt& y) const {
-    // Extended Euclidean algorithm using signed arithmetic
-    int64_t old_r = static_cast<int64_t>(a), r = static_cast<int64_t>(b);
-    int64_t old_s = 1, s = 0;
-    int64_t old_t = 0, t = 1;
+std::vector<ShamirSecretSharing::BigInt> ShamirSecretSharing::reconstructPacked(
+    const std::vector<std::vector<Share>>& packed_shares, size_t k) {
     
-    while (r != 0) {
-        int64_t quotient = old_r / r;
-        
-        int64_t temp = r;
-        r = old_r - quotient * r;
-        old_r = temp;
-        
-        temp = s;
-        s = old_s - quotient * s;
-        old_s = temp;
-        
-        temp = t;
-        t = old_t - quotient * t;
-        old_t = temp;
+    if (k == 0 || threshold_ + k - 1 > num_shares_) {
+        throw std::invalid_argument("Pack size must be between 1 and n - t + 1");
+    }
+    if (packed_shares.empty()) {
+        return {};
+    }
+    const size_t degree_bound = threshold_ + k - 1;
+    const std::vector<Share>& first = packed_shares[0];
+    if (first.size() < degree_bound) {
+        throw std::invalid_argument("Need at least t + k - 1 shares to reconstruct packed secrets");
+    }
+    inline_containers::IdSet seen;
+    for (size_t i = 0; i < degree_bound; ++i) {
+        if (!seen.insert(first[i].id)) {
+            throw std::invalid_argument("Duplicate share IDs detected");
+        }
+    }
+    for (const auto& shares : packed_shares) {
+        if (shares.size() < degree_bound) {
+            throw std::invalid_argument("Need at least t + k - 1 shares to reconstruct packed secrets");
+        }
+        for (size_t i = 0; i < degree_bound; ++i) {
+            if (shares[i].id != first[i].id) {
+                throw std::invalid_argument("Share IDs differ between groups");
+            }
+        }
     }
     
-    // Store results (will be interpreted as signed by caller)
-    x = static_cast<BigInt>(old_s);
-    y = static_cast<BigInt>(old_t);
-    return old_r;
+    // weights[j * D + i] = L_i(-j) for the first D = t + k - 1 share ids
+    std::vector<BigInt> xs(degree_bound), targets(k);
+    for (size_t i = 0; i < degree_bound; ++i) {
+        xs[i] = field_.reduce(first[i].id);
+    }
+    for (size_t j = 0; j < k; ++j) {
+        targets[j] = field_.sub(0, field_.reduce(j));
+    }
+    std::vector<BigInt> weights(k * degree_bound);
+    reed_solomon::lagrangeWeights(field_, xs.data(), degree_bound, targets.data(), k, weights.data());
+    
+    std::vector<BigInt> secrets(packed_shares.size() * k);
+    for (size_t g = 0; g < packed_shares.size(); ++g) {
+        for (size_t j = 0; j < k; ++j) {
+            BigInt secret = 0;
+            for (size_t i = 0; i < degree_bound; ++i) {
+                secret = field_.add(secret, field_.mul(weights[j * degree_bound + i],
+                                                       field_.reduce(packed_shares[g][i].value)));
+            }
+            secrets[g * k + j] = secret;
+        }
+    }
+    return secrets;
 }
 
-ShamirSecretSharing::BigInt ShamirSecretSharing::mod_inv(BigInt a) const {
-    // Use Fermat's Little Theorem: a^(p-1) ≡ 1 (mod p)
-    // Therefore: a^(-1) ≡ a^(p-2) (mod p) for prime p
-    if (a == 0) {
-        throw std::runtime_error("Modular inverse of 0 does not exist");
+std::vector<ShamirSecretSharing::BigInt> ShamirSecretSharing::lagrangeWeights(
+    const std::vector<size_t>& ids) const {
+    
+    if (ids.size() < threshold_) {
+        throw std::invalid_argument("Need at least threshold shares to reconstruct");
+    }
+    inline_containers::IdSet seen;
+    for (size_t id : ids) {
+        if (!seen.insert(id)) {
+            throw std::invalid_argument("Duplicate share IDs detected");
+        }
+    }
+    
+    if (isHierarchical()) {
+        uint64_t mask = 0;
+        for (size_t id : ids) {
+            mask |= (id >= 1 && id <= party_levels_.size()) ? 1ULL << (id - 1) : 0;
+        }
+        auto it = policy_coefficients_.find(mask);
+        if (ids.size() != threshold_ || it == policy_coefficients_.end()) {
+            throw std::invalid_argument("Share IDs are not an authorized set of threshold parties");
+        }
+        std::vector<BigInt> weights(ids.size());
+        for (size_t j = 0; j < ids.size(); ++j) {
+            uint64_t bit = 1ULL << (ids[j] - 1);
+            weights[j] = it->second[__builtin_popcountll(mask & (bit - 1))];
+        }
+        return weights;
+    }
+    
+    if (fixed_ && ids.size() == 3 && ids[0] <= 5 && ids[1] <= 5 && ids[2] <= 5 &&
+        ids[0] > 0 && ids[1] > 0 && ids[2] > 0) {
+        uint64_t mask = (1ULL << (ids[0] - 1)) | (1ULL << (ids[1] - 1)) | (1ULL << (ids[2] - 1));
+        return {fixed_->weight(mask, ids[0]), fixed_->weight(mask, ids[1]), fixed_->weight(mask, ids[2])};
     }
     
-    a = a % prime_;
-    // Compute a^(prime-2) mod prime using modular exponentiation
-    return mod_pow(a, prime_ - 2);
+    std::vector<BigInt> xs(ids.size());
+    for (size_t j = 0; j < ids.size(); ++j) {
+        xs[j] = field_.reduce(ids[j]);
+    }
+    std::vector<BigInt> weights(ids.size());
+    BigInt zero = 0;
+    reed_solomon::lagrangeWeights(field_, xs.data(), xs.size(), &zero, 1, weights.data());
+    return weights;
 }
 
-ShamirSecretSharing::BigInt ShamirSecretSharing::evaluate_polynomial(
-    const std::vector<BigInt>& coefficients, BigInt x) const {
+ShamirSecretSharing::BigInt ShamirSecretSharing::reconstructWithWeights(
+    const std::vector<BigInt>& weights, const std::vector<Share>& shares) const {
+    return reconstructWithWeights(weights, shares.data(), shares.size());
+}
+
+ShamirSecretSharing::BigInt ShamirSecretSharing::reconstructWithWeights(
+    const std::vector<BigInt>& weights, const Share* shares, size_t count) const {
+    
+    if (count != weights.size()) {
+        throw std::invalid_argument("Share count does not match the weights");
+    }
+    BigInt secret = 0;
+    for (size_t j = 0; j < count; ++j) {
+        secret = field_.add(secret, field_.mul(weights[j], field_.reduce(shares[j].value)));
+    }
+    return secret;
+}
+
+void ShamirSecretSharing::setHierarchy(const std::vector<size_t>& party_levels,
+                                       const std::vector<size_t>& level_thresholds) {
+    if (party_levels.size() != num_shares_) {
+        throw std::invalid_argument("Need one level per party");
+    }
+    if (num_shares_ > 64) {
+        throw std::invalid_argument("Hierarchical sharing supports at most 64 parties");
+    }
+    // C(n, t) built up as C(n - t + i, i), which only grows with i
+    uint64_t subsets = 1;
+    for (size_t i = 1; i <= threshold_ && subsets <= MAX_HIERARCHY_SUBSETS; ++i) {
+        subsets = static_cast<uint64_t>(static_cast<__uint128_t>(subsets) * (num_shares_ - threshold_ + i) / i);
+    }
+    if (subsets > MAX_HIERARCHY_SUBSETS) {
+        throw std::invalid_argument("Hierarchical policy has more than " +
+                                    std::to_string(MAX_HIERARCHY_SUBSETS) + " party subsets of size t");
+    }
+    if (level_thresholds.empty() || level_thresholds.back() != threshold_ || level_thresholds[0] == 0) {
+        throw std::invalid_argument("Level thresholds must start above 0 and end at the threshold");
+    }
+    for (size_t i = 1; i < level_thresholds.size(); ++i) {
+        if (level_thresholds[i] <= level_thresholds[i - 1]) {
+            throw std::invalid_argument("Level thresholds must be strictly increasing");
+        }
+    }
+    std::vector<size_t> derivative_orders(num_shares_);
+    for (size_t i = 0; i < num_shares_; ++i) {
+        if (party_levels[i] >= level_thresholds.size()) {
+            throw std::invalid_argument("Party level has no threshold");
+        }
+        derivative_orders[i] = party_levels[i] == 0 ? 0 : level_thresholds[party_levels[i] - 1];
+    }
     
-    x = x % prime_;  // Ensure x is in the field
-    BigInt result = 0;
-    BigInt x_power = 1;  // x^0 = 1
+    party_levels_ = party_levels;
+    level_thresholds_ = level_thresholds;
+    derivative_orders_ = derivative_orders;
+    policy_coefficients_.clear();
     
-    for (size_t i = 0; i < coefficients.size(); ++i) {
-        BigInt term = mod_mul(coefficients[i], x_power);
-        result = mod_add(result, term);
-        x_power = mod_mul(x_power, x);  // x^(i+1)
+    // Coefficients for every authorized t-subset; those are the only sets
+    // reconstruct ever interpolates from
+    std::vector<size_t> subset(threshold_);
+    for (size_t j = 0; j < threshold_; ++j) {
+        subset[j] = j;
+    }
+    while (true) {
+        std::vector<size_t> ids(threshold_);
+        uint64_t mask = 0;
+        for (size_t j = 0; j < threshold_; ++j) {
+            ids[j] = subset[j] + 1;
+            mask |= 1ULL << subset[j];
+        }
+        if (isAuthorized(ids)) {
+            std::vector<BigInt> coefficients;
+            if (!birkhoff_coefficients(mask, coefficients)) {
+                party_levels_.clear();
+                level_thresholds_.clear();
+                derivative_orders_.clear();
+                policy_coefficients_.clear();
+                throw std::runtime_error("Authorized party set cannot reconstruct; reorder the party ids");
+            }
+            policy_coefficients_.emplace(mask, std::move(coefficients));
+        }
+        
+        // Next t-subset in lexicographic order
+        size_t i = threshold_;
+        while (i > 0 && subset[i - 1] == num_shares_ - threshold_ + i - 1) {
+            --i;
+        }
+        if (i == 0) {
+            break;
+        }
+        ++subset[i - 1];
+        for (size_t j = i; j < threshold_; ++j) {
+            subset[j] = subset[j - 1] + 1;
+        }
     }
+}
+
+bool ShamirSecretSharing::isAuthorized(const std::vector<size_t>& ids) const {
+    std::vector<bool> seen(num_shares_ + 1, false);
+    size_t distinct = 0;
+    std::vector<size_t> per_level(level_thresholds_.size(), 0);
+    for (size_t id : ids) {
+        if (id == 0 || id > num_shares_ || seen[id]) {
+            continue;
+        }
+        seen[id] = true;
+        ++distinct;
+        if (isHierarchical()) {
+            ++per_level[party_levels_[id - 1]];
+        }
+    }
+    if (!isHierarchical()) {
+        return distinct >= threshold_;
+    }
+    size_t cumulative = 0;
+    for (size_t level = 0; level < level_thresholds_.size(); ++level) {
+        cumulative += per_level[level];
+        if (cumulative < level_thresholds_[level]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+uint64_t ShamirSecretSharing::find_authorized_subset(uint64_t present) const {
+    // Usually exactly t shares are given; otherwise try t-subsets in order.
+    // Hierarchies have at most 64 parties, so both lists stay inline.
+    inline_containers::InlineVector<size_t, 64> valid;
+    for (size_t id = 1; id <= num_shares_; ++id) {
+        if (present & (1ULL << (id - 1))) {
+            valid.push_back(id);
+        }
+    }
+    if (valid.size() < threshold_) {
+        return 0;
+    }
+    inline_containers::InlineVector<size_t, 64> subset(threshold_);
+    for (size_t j = 0; j < threshold_; ++j) {
+        subset[j] = j;
+    }
+    while (true) {
+        uint64_t mask = 0;
+        for (size_t j = 0; j < threshold_; ++j) {
+            mask |= 1ULL << (valid[subset[j]] - 1);
+        }
+        if (policy_coefficients_.count(mask)) {
+            return mask;
+        }
+        size_t i = threshold_;
+        while (i > 0 && subset[i - 1] == valid.size() - threshold_ + i - 1) {
+            --i;
+        }
+        if (i == 0) {
+            return 0;
+        }
+        ++subset[i - 1];
+        for (size_t j = i; j < threshold_; ++j) {
+            subset[j] = subset[j - 1] + 1;
+        }
+    }
+}
+
+bool ShamirSecretSharing::birkhoff_coefficients(uint64_t mask, std::vector<BigInt>& coefficients) const {
+    // Row j of A: share j = sum_i A[j][i] * a_i, with A[j][i] = i!/(i-k)! x^(i-k)
+    // for derivative order k. Solve A^T c = e_0, so that c . shares = a_0.
+    const size_t t = threshold_;
+    std::vector<size_t> ids;
+    for (size_t id = 1; id <= num_shares_; ++id) {
+        if (mask & (1ULL << (id - 1))) {
+            ids.push_back(id);
+        }
+    }
+    const size_t width = t + 1;
+    std::vector<BigInt> system(t * width, 0);     // Augmented A^T
+    for (size_t j = 0; j < t; ++j) {
+        size_t k = derivative_orders_[ids[j] - 1];
+        BigInt x = field_.reduce(ids[j]);
+        BigInt x_power = 1;
+        for (size_t i = k; i < t; ++i) {
+            system[i * width + j] = field_.mul(fallingFactorial(field_, i, k), x_power);
+            x_power = field_.mul(x_power, x);
+        }
+    }
+    system[t] = 1;
     
-    return result;
+    for (size_t col = 0; col < t; ++col) {
+        size_t pivot = col;
+        while (pivot < t && system[pivot * width + col] == 0) {
+            ++pivot;
+        }
+        if (pivot == t) {
+            return false;
+        }
+        for (size_t k = 0; k < width; ++k) {
+            std::swap(system[pivot * width + k], system[col * width + k]);
+        }
+        BigInt scale = field_.inv(system[col * width + col]);
+        for (size_t k = col; k < width; ++k) {
+            system[col * width + k] = field_.mul(system[col * width + k], scale);
+        }
+        for (size_t r = 0; r < t; ++r) {
+            BigInt factor = system[r * width + col];
+            if (r == col || factor == 0) {
+                continue;
+            }
+            for (size_t k = col; k < width; ++k) {
+                system[r * width + k] = field_.sub(system[r * width + k], field_.mul(factor, system[col * width + k]));
+            }
+        }
+    }
+    coefficients.resize(t);
+    for (size_t j = 0; j < t; ++j) {
+        coefficients[j] = system[j * width + t];
+    }
+    return true;
 }
 
-ShamirSecretSharing::BigInt ShamirSecretSharing::lagrange_interpolate(
-    const std::vector<Share>& shares) const {
+std::vector<std::vector<ShamirSecretSharing::BigInt>> ShamirSecretSharing::dealZeroSharing(size_t num_chunks) {
+    std::vector<std::vector<BigInt>> sub_shares(num_shares_, std::vector<BigInt>(num_chunks));
     
-    // Compute f(0) using Lagrange interpolation
-    // f(0) = Σ(y_i * L_i(0)) where L_i(0) = Π((0-x_j)/(x_i-x_j)) for j≠i
+    // f(0) = 0 for every chunk; one coefficient draw for the whole round
+    std::vector<BigInt> random(num_chunks * (threshold_ - 1));
+    source_->generate(prime_, random.data(), random.size());
     
-    // Use only the first 'threshold_' shares
-    size_t num_shares_to_use = std::min(shares.size(), threshold_);
+    std::vector<BigInt> coefficients(threshold_, 0);
+    std::vector<BigInt> values(num_shares_);
+    for (size_t c = 0; c < num_chunks; ++c) {
+        std::copy_n(&random[c * (threshold_ - 1)], threshold_ - 1, coefficients.begin() + 1);
+        evaluate_at_share_points(coefficients, values.data());
+        for (size_t j = 0; j < num_shares_; ++j) {
+            sub_shares[j][c] = values[j];
+        }
+    }
+    std::fill(random.begin(), random.end(), 0);
+    std::fill(coefficients.begin(), coefficients.end(), 0);
+    return sub_shares;
+}
+
+void ShamirSecretSharing::addSubShares(PartyShares& party,
+                                       const std::vector<BigInt>& sub_shares) const {
+    if (party.values.size() != sub_shares.size()) {
+        throw std::invalid_argument("Sub-share count does not match share count");
+    }
+    // Branchless a + b mod p (carry out of 64 bits covers primes above 2^63);
+    // the loop has no dependencies between chunks and vectorizes
+    const BigInt p = prime_;
+    BigInt* values = party.values.data();
+    const BigInt* add = sub_shares.data();
+    for (size_t c = 0; c < party.values.size(); ++c) {
+        BigInt a = values[c];
+        BigInt sum = a + add[c];
+        BigInt wrap = static_cast<BigInt>(sum < a) | static_cast<BigInt>(sum >= p);
+        values[c] = sum - (p & (0 - wrap));
+    }
+}
+
+ShamirSecretSharing::BigInt ShamirSecretSharing::evaluate_polynomial(
+    const std::vector<BigInt>& coefficients, BigInt x) const {
     
-    BigInt secret = 0;
+    return field_ops::evaluatePolynomial(field_, coefficients.data(), coefficients.size(),
+                                         field_.reduce(x));
+}
+
+ShamirSecretSharing::BigInt ShamirSecretSharing::lagrange_interpolate(
+    const Share* shares, size_t count) const {
     
+    // Use only the first 'threshold_' shares, reduced into the field once;
+    // on the stack up to SSS_INLINE_THRESHOLD of them
+    size_t num_shares_to_use = std::min(count, threshold_);
+    inline_containers::InlineVector<BigInt, SSS_INLINE_THRESHOLD> inline_xs, inline_ys;
+    std::vector<BigInt> heap_xs, heap_ys;
+    BigInt* xs;
+    BigInt* ys;
+    if (num_shares_to_use <= SSS_INLINE_THRESHOLD) {
+        inline_xs.resize(num_shares_to_use);
+        inline_ys.resize(num_shares_to_use);
+        xs = inline_xs.data();
+        ys = inline_ys.data();
+    } else {
+        heap_xs.resize(num_shares_to_use);
+        heap_ys.resize(num_shares_to_use);
+        xs = heap_xs.data();
+        ys = heap_ys.data();
+    }
     for (size_t i = 0; i < num_shares_to_use; ++i) {
-        BigInt numerator = 1;
-        BigInt denominator = 1;
-        
-        for (size_t j = 0; j < num_shares_to_use; ++j) {
-            if (i != j) {
-                // numerator *= (0 - x_j) = -x_j
-                // Since we want (0 - x_j), this is equivalent to prime - x_j in modular arithmetic
-                numerator = mod_mul(numerator, mod_sub(0, shares[j].id));
-                
-                // denominator *= (x_i - x_j)
-                denominator = mod_mul(denominator, mod_sub(shares[i].id, shares[j].id));
-            }
-        }
-        
-        // L_i(0) = numerator / denominator
-        BigInt lagrange_coeff = mod_mul(numerator, mod_inv(denominator));
-        
-        // Add y_i * L_i(0) to result
-        BigInt term = mod_mul(shares[i].value, lagrange_coeff);
-        secret = mod_add(secret, term);
+        xs[i] = field_.reduce(shares[i].id);
+        ys[i] = field_.reduce(shares[i].value);
     }
     
-    return secret;
+    return field_ops::interpolateAtZero(field_, xs, ys, num_shares_to_use);
 }
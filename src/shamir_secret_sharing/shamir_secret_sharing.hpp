@@ -3,30 +3,51 @@
 
 #include <vector>
 #include <cstdint>
-#include <random>
+#include <memory>
 #include <stdexcept>
 #include <map>
+#include "coefficient_source.hpp"
+#include "field_ops.hpp"
+#include "fixed_threshold.hpp"
 
 /**
  * Shamir's Secret Sharing Implementation
  * Implements (t,n)-threshold secret sharing scheme
+ *
+ * Field arithmetic comes from field_ops::DefaultField; build with
+ * -DSSS_CONSTANT_TIME=1 for the constant-time backend (odd prime < 2^63).
+ * Polynomial coefficients come from a coefficient_source::CoefficientSource,
+ * by default a DRBG keyed from RAND_bytes.
  */
 class ShamirSecretSharing {
 public:
     using BigInt = uint64_t;  // Simplified for demonstration; use GMP/NTL for production
+    using Field = field_ops::DefaultField;
     
     struct Share {
         size_t id;      // Party identifier (x-coordinate)
         BigInt value;   // Share value (y-coordinate)
     };
     
+    /**
+     * One party's shares of many secrets (e.g. the chunks of a key): the id
+     * once, then a contiguous value per secret. Half the size of a
+     * std::vector<Share> and laid out for column-wise reconstruction.
+     */
+    struct PartyShares {
+        size_t id;                   // Party identifier (x-coordinate of every value)
+        std::vector<BigInt> values;  // values[c] = share of secret c
+    };
+    
     /**
      * Constructor
      * @param threshold Minimum number of shares needed to reconstruct (t)
      * @param num_shares Total number of shares to generate (n)
-     * @param prime Large prime number for finite field operations
+     * @param prime Large prime number for finite field operations (above num_shares)
+     * @param source Coefficient generator (nullptr = coefficient_source::makeDefaultSource())
      */
-    ShamirSecretSharing(size_t threshold, size_t num_shares, BigInt prime);
+    ShamirSecretSharing(size_t threshold, size_t num_shares, BigInt prime,
+                        std::unique_ptr<coefficient_source::CoefficientSource> source = nullptr);
     
     /**
      * Split a secret into n shares
@@ -35,6 +56,12 @@ public:
      */
     std::vector<Share> split(BigInt secret);
     
+    /**
+     * Split and also return the polynomial (coefficients[0] = secret), which
+     * verifiable secret sharing needs to publish commitments
+     */
+    std::vector<Share> split(BigInt secret, std::vector<BigInt>& coefficients);
+    
     /**
      * Reconstruct secret from t or more shares
      * @param shares Vector of at least t shares
@@ -42,6 +69,162 @@ public:
      */
     BigInt reconstruct(const std::vector<Share>& shares);
     
+    /**
+     * Reconstruct from shares held in any contiguous buffer (e.g. a
+     * secure_arena::SecureVector)
+     */
+    BigInt reconstruct(const Share* shares, size_t count);
+    
+    /**
+     * Error-correcting reconstruction from all received shares
+     *
+     * Shares of a chunk form a Reed-Solomon codeword, so with m shares up to
+     * floor((m - t) / 2) wrong values per chunk are detected and corrected.
+     * Chunks are decoded as a batch: Lagrange weights for a trusted set of t
+     * shares are computed once and each chunk is checked against the other
+     * m - t shares; Berlekamp-Welch runs only for chunks that fail the check,
+     * and shares it finds wrong are dropped from the trusted set for the
+     * remaining chunks.
+     * @param chunk_shares chunk_shares[c] holds the shares of chunk c; every
+     *        chunk must list the same share ids in the same order
+     * @param bad_ids If not null, receives the (sorted) ids of shares that were
+     *        wrong for at least one chunk
+     * @return The reconstructed chunks
+     * @throws std::invalid_argument on fewer than t shares, duplicate ids or
+     *         mismatched chunks
+     * @throws std::runtime_error if some chunk has more errors than can be corrected
+     */
+    std::vector<BigInt> reconstructRobust(const std::vector<std::vector<Share>>& chunk_shares,
+                                          std::vector<size_t>* bad_ids = nullptr);
+    
+    /**
+     * Error-correcting reconstruction of a single secret (see above)
+     */
+    BigInt reconstructRobust(const std::vector<Share>& shares, std::vector<size_t>* bad_ids = nullptr);
+    
+    /**
+     * Split many secrets, writing each party's shares straight into its own
+     * preallocated array
+     * @return parties[i] is party i + 1; parties[i].values[c] is its share of secrets[c]
+     * @throws std::invalid_argument if a secret is not below the prime
+     */
+    std::vector<PartyShares> splitChunks(const BigInt* secrets, size_t count);
+    
+    /**
+     * Inverse of splitChunks
+     *
+     * Weights for the parties' ids are computed once; each chunk is then
+     * sum_j weights[j] * parties[j]->values[c], accumulated one party's
+     * array at a time.
+     * @param secrets Receives parties[0]->values.size() secrets
+     * @throws std::invalid_argument on too few, duplicate or (under a
+     *         hierarchy) unauthorized ids, or parties holding different
+     *         numbers of chunks
+     */
+    void reconstructChunks(const std::vector<const PartyShares*>& parties, BigInt* secrets) const;
+    
+    /**
+     * Packed (Franklin-Yung) sharing of many secrets, k per polynomial
+     *
+     * Each group of k secrets is placed at x = 0, -1, ..., -(k - 1) of one
+     * polynomial of degree t + k - 2 (t - 1 random values fix the rest), so a party
+     * stores one field element per k secrets. Any t - 1 parties still learn
+     * nothing, but reconstruction needs t + k - 1 shares, so k is bounded
+     * by the trust margin n - t + 1. k = 1 is ordinary sharing.
+     * @param secrets Secrets to share; the last group is padded with zeros
+     * @return shares[g][i]: party i+1's share of group g (ceil(secrets / k) groups)
+     * @throws std::invalid_argument if k is 0 or above n - t + 1, under a
+     *         hierarchical policy, or if a secret is not below the prime
+     */
+    std::vector<std::vector<Share>> splitPacked(const std::vector<BigInt>& secrets, size_t k);
+    
+    /**
+     * Inverse of splitPacked
+     *
+     * Uses the first t + k - 1 shares of each group; weights for that id set
+     * are computed once for all groups.
+     * @param packed_shares packed_shares[g] holds shares of group g, with the
+     *        same ids in the same order for every group
+     * @return k secrets per group (including the zero padding)
+     */
+    std::vector<BigInt> reconstructPacked(const std::vector<std::vector<Share>>& packed_shares, size_t k);
+    
+    /**
+     * Lagrange weights at zero for a fixed set of share ids
+     *
+     * f(0) = sum_j weights[j] * f(ids[j]). Computing them once lets every
+     * chunk held by the same parties be reconstructed with reconstructWithWeights
+     * at t multiplications per chunk and no inversions.
+     * @param ids At least t distinct share ids
+     */
+    std::vector<BigInt> lagrangeWeights(const std::vector<size_t>& ids) const;
+    
+    /**
+     * f(0) from shares listed in the same id order as the weights
+     */
+    BigInt reconstructWithWeights(const std::vector<BigInt>& weights, const std::vector<Share>& shares) const;
+    BigInt reconstructWithWeights(const std::vector<BigInt>& weights, const Share* shares, size_t count) const;
+    
+    /**
+     * Deal sharings of zero for proactive refresh
+     *
+     * Each party deals one of these per refresh round; every party then adds
+     * the sub-shares addressed to it into its stored shares. The secrets are
+     * unchanged, but shares from before the refresh no longer combine with
+     * shares from after it.
+     * @param num_chunks Number of independent secrets (chunks) in the share vectors
+     * @return sub_shares[j][c] is what party j+1 adds to its share of chunk c
+     */
+    std::vector<std::vector<BigInt>> dealZeroSharing(size_t num_chunks);
+    
+    /**
+     * Refresh step for one party: party.values[c] += sub_shares[c] (mod p)
+     * Both inputs must already be reduced (below the prime).
+     */
+    void addSubShares(PartyShares& party, const std::vector<BigInt>& sub_shares) const;
+    
+    /**
+     * Switch to a hierarchical (conjunctive, Tassa) access structure
+     *
+     * Parties are ranked into levels 0 (most senior) .. L-1 with thresholds
+     * k_0 < k_1 < ... < k_(L-1) = t. A set of parties is authorized iff, for
+     * every level i, it holds at least k_i parties from levels 0..i. "The
+     * judiciary plus any two others" is levels {0, 1, 1, 1, 1} with
+     * thresholds {1, 3}.
+     *
+     * A party at level i > 0 receives the k_(i-1)-th derivative of the
+     * polynomial at its x instead of the value (Birkhoff interpolation).
+     * Reconstruction coefficients for every authorized t-party set are
+     * computed here, so reconstruct and lagrangeWeights cost the same as
+     * plain Lagrange afterwards. Error-correcting reconstruction stays
+     * threshold-only.
+     * The precomputation visits all C(n, t) t-subsets, so policies with more
+     * than MAX_HIERARCHY_SUBSETS of them are refused.
+     * @param party_levels party_levels[i] is the level of party i + 1 (n entries)
+     * @param level_thresholds Cumulative thresholds, strictly increasing, last = t
+     * @throws std::invalid_argument on a malformed policy, more than 64 parties
+     *         or more than MAX_HIERARCHY_SUBSETS t-subsets
+     * @throws std::runtime_error if some authorized set cannot reconstruct
+     *         (share ids unsuitable for this prime)
+     */
+    void setHierarchy(const std::vector<size_t>& party_levels, const std::vector<size_t>& level_thresholds);
+    
+    /**
+     * Largest C(n, t) setHierarchy will enumerate (e.g. 16 of 20, not 20 of 40)
+     */
+    static constexpr uint64_t MAX_HIERARCHY_SUBSETS = 1ULL << 16;
+    
+    /**
+     * Whether setHierarchy is in effect
+     */
+    bool isHierarchical() const { return !party_levels_.empty(); }
+    
+    /**
+     * Whether the parties with these ids may reconstruct (any t distinct ids
+     * without a hierarchy)
+     */
+    bool isAuthorized(const std::vector<size_t>& ids) const;
+    
     /**
      * Get the threshold value
      */
@@ -51,23 +234,42 @@ public:
      * Get the total number of shares
      */
     size_t getNumShares() const { return num_shares_; }
+    
+    /**
+     * Get the field modulus
+     */
+    BigInt getPrime() const { return prime_; }
+    
+    /**
+     * Replace the coefficient generator (e.g. a deterministic one in tests)
+     */
+    void setCoefficientSource(std::unique_ptr<coefficient_source::CoefficientSource> source);
 
 private:
     size_t threshold_;    // Minimum shares needed (t)
     size_t num_shares_;   // Total shares (n)
     BigInt prime_;        // Prime modulus for finite field
+    Field field_;
+    
+    // The deployed 3-of-5 over 2^61 - 1: compile-time weight table (else null)
+    using Fixed3of5 = fixed_threshold::ShamirSecretSharing<3, 5, Field>;
+    const Fixed3of5* fixed_;
+    
+    std::unique_ptr<coefficient_source::CoefficientSource> source_;
     
-    std::random_device rd_;
-    std::mt19937_64 rng_;
+    // Hierarchical access structure (empty = plain t-of-n)
+    std::vector<size_t> party_levels_;
+    std::vector<size_t> level_thresholds_;
+    std::vector<size_t> derivative_orders_;         // Per party: k_(level-1), 0 at level 0
+    std::map<uint64_t, std::vector<BigInt>> policy_coefficients_;  // Id bitmask -> coefficients, ascending id
+    
+    // Packed sharing: k -> weights from the t + k - 1 defining values to the n shares
+    std::map<size_t, std::vector<BigInt>> packed_share_weights_;
     
     /**
-     * Modular arithmetic operations
+     * values[i] = f(i + 1) for i < n (batched when the prime is 2^61 - 1)
      */
-    BigInt mod_add(BigInt a, BigInt b) const;
-    BigInt mod_sub(BigInt a, BigInt b) const;
-    BigInt mod_mul(BigInt a, BigInt b) const;
-    BigInt mod_pow(BigInt base, BigInt exp) const;
-    BigInt mod_inv(BigInt a) const;  // Modular multiplicative inverse
+    void evaluate_at_share_points(const std::vector<BigInt>& coefficients, BigInt* values) const;
     
     /**
      * Polynomial evaluation at point x
@@ -78,12 +280,20 @@ private:
     /**
      * Lagrange interpolation to find f(0)
      */
-    BigInt lagrange_interpolate(const std::vector<Share>& shares) const;
+    BigInt lagrange_interpolate(const Share* shares, size_t count) const;
+    
+    /**
+     * Id bitmask of an authorized t-subset of the present ids (bit id - 1
+     * set for each id; 0 if none)
+     */
+    uint64_t find_authorized_subset(uint64_t present) const;
     
     /**
-     * Extended Euclidean algorithm for modular inverse
+     * Birkhoff coefficients c with f(0) = sum_j c_j * share_j for the parties
+     * in mask (ascending id)
+     * @return false if the system is singular
      */
-    int64_t extended_gcd(BigInt a, BigInt b, BigInt& x, BigInt& y) const;
+    bool birkhoff_coefficients(uint64_t mask, std::vector<BigInt>& coefficients) const;
 };
 
 #endif // SHAMIR_SECRET_SHARING_HPP
@@ -0,0 +1,424 @@
+#include "vss.hpp"
+#include "coefficient_source.hpp"
+#include "field_ops.hpp"
+#include "poly_eval.hpp"
+
+#include <openssl/bn.h>
+#include <openssl/crypto.h>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+
+namespace vss {
+
+namespace {
+
+const uint64_t P61 = poly_eval::MERSENNE_61;
+
+/**
+ * Group parameters (nothing up my sleeve):
+ *   P = k * (2^61 - 1) + 1 for the first SHA-256("multiparty-tls pedersen
+ *       modulus:<counter>:<block>") expansion k, shifted to 963 bits with
+ *       the top two bits and bit 0 fixed, that makes P prime (counter 233)
+ *   g, h = SHA-256 expansions of "multiparty-tls pedersen g" / "... h",
+ *       reduced mod P and raised to (P - 1) / (2^61 - 1)
+ * Nobody knows log_g h.
+ */
+const char* MODULUS_HEX =
+    "CAB334A3490612BD5EB1D3A166618C9E320C0C65041478C20AE331B6D044CDC9"
+    "B8F4710F5FB561251FB94D511891A6747D974F62606D525561242C995090B070"
+    "A33DB30496DFCC98E7555553C69EA0D9479AFC79C9C53B15F03EBB6C9AAEC16D"
+    "7EF11761F24E8BFC15D7D7D42DDE55E1B9BF2DE9A85B04817114DEA3EDA8CE63";
+const char* G_HEX =
+    "195C893B42C257FA66E4AB36D9661E15F8BBA9DA46832734F49084FDA6F122DC"
+    "98ADC46C23F966A1520C4CA85214F71C5AB0215A751746A50957A272790A77E9"
+    "77FCE27B1BABC98C89BDDA51FF80682EC79F29AACA13D64BEE30931B9FB1ED13"
+    "85FA55D6C4DB2F7E3A2447233765BAF2BDFFB2C20010A825F20EAC9A94E15BF9";
+const char* H_HEX =
+    "550EC1647E3F90465F85D9AE41D0748C3948067F35C3D6B2CF70979B84CC1627"
+    "1A622B93883153FC59225757BB5957E297305019BCE2786358991DBA8A2A2FAB"
+    "75D964B69BDAA5321F33122346C0C606366BBEFE5391E6AC297EE4292FB5EAAC"
+    "AAC420C8DAD3567F16681EAB16A2F363EC1BD55D244D95D07869015262AA9001";
+
+struct Group {
+    BIGNUM* P = nullptr;
+    BIGNUM* g = nullptr;
+    BIGNUM* h = nullptr;
+    BN_MONT_CTX* mont = nullptr;
+
+    Group() {
+        BN_CTX* ctx = BN_CTX_new();
+        mont = BN_MONT_CTX_new();
+        if (!ctx || !mont || !BN_hex2bn(&P, MODULUS_HEX) || !BN_hex2bn(&g, G_HEX) ||
+            !BN_hex2bn(&h, H_HEX) || !BN_MONT_CTX_set(mont, P, ctx)) {
+            BN_CTX_free(ctx);
+            throw std::runtime_error("VSS group initialisation failed");
+        }
+        BN_CTX_free(ctx);
+    }
+};
+
+/**
+ * Shared, read-only after construction (lives for the process)
+ */
+const Group& group() {
+    static const Group* instance = new Group();
+    return *instance;
+}
+
+using BnCtx = std::unique_ptr<BN_CTX, decltype(&BN_CTX_free)>;
+
+BnCtx newCtx() {
+    BnCtx ctx(BN_CTX_new(), BN_CTX_free);
+    if (!ctx) {
+        throw std::runtime_error("BN_CTX_new failed");
+    }
+    return ctx;
+}
+
+/**
+ * Owns a list of BIGNUMs
+ */
+struct BigNums {
+    std::vector<BIGNUM*> items;
+
+    explicit BigNums(size_t count) : items(count, nullptr) {
+        for (auto& item : items) {
+            item = BN_new();
+            if (!item) {
+                throw std::runtime_error("BN_new failed");
+            }
+        }
+    }
+    ~BigNums() {
+        for (auto* item : items) BN_free(item);
+    }
+    BIGNUM* operator[](size_t i) const { return items[i]; }
+};
+
+bool setWord(BIGNUM* bn, uint64_t value) {
+    return BN_set_word(bn, value) == 1;
+}
+
+/**
+ * out = g^a * h^b mod P
+ */
+bool commit(uint64_t a, uint64_t b, BIGNUM* out, BN_CTX* ctx) {
+    const Group& G = group();
+    BigNums exps(2);
+    return setWord(exps[0], a) && setWord(exps[1], b) &&
+           BN_mod_exp2_mont(out, G.g, exps[0], G.h, exps[1], G.P, ctx, G.mont) == 1;
+}
+
+/**
+ * Load the commitments of the given chunks as BIGNUMs; rejects values outside [1, P-1]
+ */
+bool loadElements(const Commitments& commitments, BigNums& out) {
+    const Group& G = group();
+    for (size_t i = 0; i < out.items.size(); ++i) {
+        if (!BN_bin2bn(&commitments.values[i * ELEMENT_BYTES], ELEMENT_BYTES, out[i]) ||
+            BN_is_zero(out[i]) || BN_cmp(out[i], G.P) >= 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * out = prod bases[i]^exps[i] mod P with Pippenger's bucket method
+ *
+ * Exponents (< 2^61) are cut into 4-bit windows. Per window every base is
+ * multiplied into the bucket of its digit, and the buckets are summed with
+ * a running product, so each window costs about (bases + 30) Montgomery
+ * multiplications, plus 4 squarings between windows.
+ */
+bool multiExp(const BigNums& bases, const std::vector<uint64_t>& exps, BIGNUM* out, BN_CTX* ctx) {
+    constexpr int WINDOW_BITS = 4;
+    constexpr int NUM_BUCKETS = (1 << WINDOW_BITS) - 1;
+    constexpr int NUM_WINDOWS = (61 + WINDOW_BITS - 1) / WINDOW_BITS;
+    const Group& G = group();
+    const size_t count = exps.size();
+
+    BigNums mont_bases(count);
+    for (size_t i = 0; i < count; ++i) {
+        if (!BN_to_montgomery(mont_bases[i], bases[i], G.mont, ctx)) {
+            return false;
+        }
+    }
+
+    BigNums buckets(NUM_BUCKETS);
+    BigNums acc(3);     // acc, running, total
+    BIGNUM* result = acc[0];
+    BIGNUM* running = acc[1];
+    BIGNUM* total = acc[2];
+    bool have_result = false;
+    bool ok = true;
+
+    // In-place Montgomery product that treats "unset" as 1
+    auto mulInto = [&](BIGNUM* target, bool& have, const BIGNUM* factor) {
+        if (!have) {
+            ok = ok && BN_copy(target, factor) != nullptr;
+            have = true;
+        } else {
+            ok = ok && BN_mod_mul_montgomery(target, target, factor, G.mont, ctx) == 1;
+        }
+    };
+
+    for (int w = NUM_WINDOWS - 1; w >= 0 && ok; --w) {
+        if (have_result) {
+            for (int s = 0; s < WINDOW_BITS; ++s) {
+                ok = ok && BN_mod_mul_montgomery(result, result, result, G.mont, ctx) == 1;
+            }
+        }
+
+        bool have_bucket[NUM_BUCKETS] = {};
+        for (size_t i = 0; i < count; ++i) {
+            unsigned digit = (exps[i] >> (w * WINDOW_BITS)) & NUM_BUCKETS;
+            if (digit != 0) {
+                mulInto(buckets[digit - 1], have_bucket[digit - 1], mont_bases[i]);
+            }
+        }
+
+        // total = prod_d bucket[d]^d, as a running product from the top digit down
+        bool have_running = false, have_total = false;
+        for (int d = NUM_BUCKETS - 1; d >= 0; --d) {
+            if (have_bucket[d]) {
+                mulInto(running, have_running, buckets[d]);
+            }
+            if (have_running) {
+                mulInto(total, have_total, running);
+            }
+        }
+        if (have_total) {
+            mulInto(result, have_result, total);
+        }
+    }
+
+    if (!ok) {
+        return false;
+    }
+    if (!have_result) {
+        return BN_one(out) == 1;
+    }
+    return BN_from_montgomery(out, result, G.mont, ctx) == 1;
+}
+
+bool wellFormed(const Commitments& commitments, const PartyShares& party) {
+    if (!party.shares || !party.blinding || party.shares->values.size() != commitments.num_chunks ||
+        party.blinding->size() != commitments.num_chunks || party.shares->id == 0 || party.shares->id >= P61) {
+        return false;
+    }
+    for (size_t c = 0; c < commitments.num_chunks; ++c) {
+        if (party.shares->values[c] >= P61 || (*party.blinding)[c] >= P61) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * One random linear combination of the share equations of all given parties
+ */
+bool checkCombined(const Commitments& commitments, const std::vector<const PartyShares*>& parties) {
+    const size_t t = commitments.threshold;
+    const size_t num_chunks = commitments.num_chunks;
+    if (t == 0 || commitments.values.size() != num_chunks * t * ELEMENT_BYTES) {
+        return false;
+    }
+    for (const auto* party : parties) {
+        if (!wellFormed(commitments, *party)) {
+            return false;
+        }
+    }
+
+    field_ops::FastField field(P61);
+    coefficient_source::DrbgSource rng;
+    std::vector<uint64_t> r(num_chunks);
+    std::vector<uint64_t> exps(num_chunks * t, 0);
+    std::vector<uint64_t> x_powers(t);
+    uint64_t value_sum = 0, blinding_sum = 0;
+
+    for (const auto* party : parties) {
+        rng.generate(P61, r.data(), num_chunks);
+        // Every chunk of a party sits at the same x: powers once per party
+        x_powers[0] = 1;
+        for (size_t j = 1; j < t; ++j) {
+            x_powers[j] = field.mul(x_powers[j - 1], party->shares->id);
+        }
+        const uint64_t* values = party->shares->values.data();
+        for (size_t c = 0; c < num_chunks; ++c) {
+            value_sum = field.add(value_sum, field.mul(r[c], values[c]));
+            blinding_sum = field.add(blinding_sum, field.mul(r[c], (*party->blinding)[c]));
+            for (size_t j = 0; j < t; ++j) {
+                exps[c * t + j] = field.add(exps[c * t + j], field.mul(r[c], x_powers[j]));
+            }
+        }
+    }
+
+    auto ctx = newCtx();
+    BigNums elements(num_chunks * t);
+    BigNums sides(2);
+    return loadElements(commitments, elements) &&
+           commit(value_sum, blinding_sum, sides[0], ctx.get()) &&
+           multiExp(elements, exps, sides[1], ctx.get()) &&
+           BN_cmp(sides[0], sides[1]) == 0;
+}
+
+} // namespace
+
+// ============================================================================
+// Files
+// ============================================================================
+
+bool Commitments::saveToFile(const std::string& filename) const {
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open()) return false;
+
+    file.write(reinterpret_cast<const char*>(&threshold), sizeof(threshold));
+    file.write(reinterpret_cast<const char*>(&num_chunks), sizeof(num_chunks));
+    file.write(reinterpret_cast<const char*>(values.data()), values.size());
+    return file.good();
+}
+
+bool Commitments::loadFromFile(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) return false;
+
+    file.read(reinterpret_cast<char*>(&threshold), sizeof(threshold));
+    file.read(reinterpret_cast<char*>(&num_chunks), sizeof(num_chunks));
+    if (!file.good() || threshold == 0 || threshold > 1024 || num_chunks > (1u << 16) ||
+        threshold * num_chunks > (1u << 16)) {
+        return false;
+    }
+    values.resize(num_chunks * threshold * ELEMENT_BYTES);
+    file.read(reinterpret_cast<char*>(values.data()), values.size());
+    return file.good();
+}
+
+bool BlindingShares::saveToFile(const std::string& filename) const {
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open()) return false;
+
+    size_t count = values.size();
+    file.write(reinterpret_cast<const char*>(&party_id), sizeof(party_id));
+    file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    file.write(reinterpret_cast<const char*>(values.data()), count * sizeof(uint64_t));
+    return file.good();
+}
+
+bool BlindingShares::loadFromFile(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) return false;
+
+    size_t count = 0;
+    file.read(reinterpret_cast<char*>(&party_id), sizeof(party_id));
+    file.read(reinterpret_cast<char*>(&count), sizeof(count));
+    if (!file.good() || count > (1u << 20)) {
+        return false;
+    }
+    values.resize(count);
+    file.read(reinterpret_cast<char*>(values.data()), count * sizeof(uint64_t));
+    return file.good();
+}
+
+// ============================================================================
+// Dealing and verification
+// ============================================================================
+
+Dealing deal(ShamirSecretSharing& sss, const std::vector<uint64_t>& chunks) {
+    if (sss.getPrime() != P61) {
+        throw std::invalid_argument("VSS requires the 2^61 - 1 share field");
+    }
+    const size_t t = sss.getThreshold();
+    const size_t n = sss.getNumShares();
+
+    Dealing dealing;
+    dealing.shares.resize(n);
+    dealing.blinding.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        dealing.shares[i].id = i + 1;
+        dealing.shares[i].values.reserve(chunks.size());
+        dealing.blinding[i].party_id = i + 1;
+        dealing.blinding[i].values.reserve(chunks.size());
+    }
+    dealing.commitments.threshold = t;
+    dealing.commitments.num_chunks = chunks.size();
+    dealing.commitments.values.assign(chunks.size() * t * ELEMENT_BYTES, 0);
+
+    coefficient_source::DrbgSource rng;
+    std::vector<uint64_t> value_poly, blinding_poly;
+    auto ctx = newCtx();
+    BigNums element(1);
+
+    for (size_t c = 0; c < chunks.size(); ++c) {
+        auto value_shares = sss.split(chunks[c], value_poly);
+        uint64_t blinding_secret;
+        rng.generate(P61, &blinding_secret, 1);
+        auto blinding_shares = sss.split(blinding_secret, blinding_poly);
+        for (size_t i = 0; i < n; ++i) {
+            dealing.shares[i].values.push_back(value_shares[i].value);
+            dealing.blinding[i].values.push_back(blinding_shares[i].value);
+        }
+        for (size_t j = 0; j < t; ++j) {
+            uint8_t* slot = &dealing.commitments.values[(c * t + j) * ELEMENT_BYTES];
+            if (!commit(value_poly[j], blinding_poly[j], element[0], ctx.get()) ||
+                BN_bn2binpad(element[0], slot, ELEMENT_BYTES) != static_cast<int>(ELEMENT_BYTES)) {
+                throw std::runtime_error("VSS commitment failed");
+            }
+        }
+    }
+    OPENSSL_cleanse(value_poly.data(), value_poly.size() * sizeof(uint64_t));
+    OPENSSL_cleanse(blinding_poly.data(), blinding_poly.size() * sizeof(uint64_t));
+    return dealing;
+}
+
+bool verify(const Commitments& commitments, const PartyShares& party) {
+    return checkCombined(commitments, {&party});
+}
+
+bool verifyShare(const Commitments& commitments, size_t chunk, const Share& share, uint64_t blinding) {
+    const size_t t = commitments.threshold;
+    if (chunk >= commitments.num_chunks || commitments.values.size() != commitments.num_chunks * t * ELEMENT_BYTES ||
+        share.id == 0 || share.id >= P61 || share.value >= P61 || blinding >= P61) {
+        return false;
+    }
+    const Group& G = group();
+    field_ops::FastField field(P61);
+    auto ctx = newCtx();
+    BigNums work(4);    // lhs, rhs, power, exponent
+    if (!commit(share.value, blinding, work[0], ctx.get()) || !BN_one(work[1])) {
+        return false;
+    }
+    uint64_t x_power = 1;
+    for (size_t j = 0; j < t; ++j) {
+        const uint8_t* element = &commitments.values[(chunk * t + j) * ELEMENT_BYTES];
+        if (!BN_bin2bn(element, ELEMENT_BYTES, work[2]) || BN_cmp(work[2], G.P) >= 0 ||
+            !setWord(work[3], x_power) ||
+            !BN_mod_exp_mont(work[2], work[2], work[3], G.P, ctx.get(), G.mont) ||
+            !BN_mod_mul(work[1], work[1], work[2], G.P, ctx.get())) {
+            return false;
+        }
+        x_power = field.mul(x_power, share.id);
+    }
+    return BN_cmp(work[0], work[1]) == 0;
+}
+
+std::vector<size_t> findInvalidParties(const Commitments& commitments, const std::vector<PartyShares>& parties) {
+    std::vector<const PartyShares*> all;
+    for (const auto& party : parties) {
+        all.push_back(&party);
+    }
+    if (checkCombined(commitments, all)) {
+        return {};
+    }
+
+    std::vector<size_t> invalid;
+    for (const auto& party : parties) {
+        if (!checkCombined(commitments, {&party})) {
+            invalid.push_back(party.party_id);
+        }
+    }
+    return invalid;
+}
+
+} // namespace vss
@@ -0,0 +1,113 @@
+#ifndef VSS_HPP
+#define VSS_HPP
+
+#include "shamir_secret_sharing.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Pedersen verifiable secret sharing for chunk shares over GF(2^61 - 1)
+ *
+ * For every chunk the dealer shares the value with f_c and a random blinding
+ * value with b_c (same threshold) and publishes, for each coefficient j,
+ *
+ *   C[c][j] = g^(f_c,j) * h^(b_c,j) mod P
+ *
+ * in the subgroup of order p = 2^61 - 1 of Z_P* (P is a 1024-bit prime with
+ * p | P - 1). A party holding (y, y') = (f_c(x), b_c(x)) is consistent iff
+ *
+ *   g^y * h^y' = prod_j C[c][j]^(x^j)
+ *
+ * Why Pedersen and not Feldman: the share field fixes the group order at
+ * 2^61 - 1, so discrete logarithms cost about 2^31 group operations. Feldman
+ * commitments g^(f_c,0) would hand out every chunk of d to anyone willing to
+ * spend that; Pedersen commitments are perfectly hiding regardless. Their
+ * binding rests on nobody knowing log_g h (g and h are hashed to the group,
+ * see vss.cpp), so treat verification as a fast filter for corrupted or
+ * tampered shares. The round-trip check of the reconstructed key stays the
+ * final authority.
+ *
+ * Verification is batched: a random linear combination over all chunks (and
+ * all parties) turns the per-share checks into one two-base exponentiation
+ * and one Pippenger multi-exponentiation over the num_chunks * t commitments.
+ * A bad share makes the combined check fail except with probability 1/p;
+ * only then are parties checked one by one.
+ */
+namespace vss {
+
+using Bytes = std::vector<uint8_t>;
+using Share = ShamirSecretSharing::Share;
+using ChunkShares = ShamirSecretSharing::PartyShares;
+
+constexpr size_t ELEMENT_BYTES = 128;   // Big-endian element of Z_P*
+
+/**
+ * Public commitments of one dealing, chunk-major: values[(c * t + j) * ELEMENT_BYTES]
+ */
+struct Commitments {
+    size_t threshold = 0;
+    size_t num_chunks = 0;
+    Bytes values;
+
+    bool saveToFile(const std::string& filename) const;
+    bool loadFromFile(const std::string& filename);
+};
+
+/**
+ * Blinding shares b_c(x) of one party, one per chunk (private, like the shares)
+ */
+struct BlindingShares {
+    size_t party_id = 0;
+    std::vector<uint64_t> values;
+
+    bool saveToFile(const std::string& filename) const;
+    bool loadFromFile(const std::string& filename);
+};
+
+/**
+ * Everything produced by dealing one key
+ */
+struct Dealing {
+    std::vector<ChunkShares> shares;            // shares[i]: party i+1, values[c] = chunk c
+    std::vector<BlindingShares> blinding;       // blinding[i]: party i+1
+    Commitments commitments;
+};
+
+/**
+ * Share every chunk with sss and commit to both polynomials
+ * @throws std::invalid_argument unless sss works over 2^61 - 1
+ * @throws std::runtime_error on an OpenSSL failure
+ */
+Dealing deal(ShamirSecretSharing& sss, const std::vector<uint64_t>& chunks);
+
+/**
+ * One party's claimed shares, for verification
+ */
+struct PartyShares {
+    size_t party_id;                            // Who made the claim (reported if invalid)
+    const ChunkShares* shares;                  // One value per chunk, all at x = shares->id
+    const std::vector<uint64_t>* blinding;      // One per chunk
+};
+
+/**
+ * Check one party's shares of every chunk with a single batched equation
+ */
+bool verify(const Commitments& commitments, const PartyShares& party);
+
+/**
+ * Check one share against its chunk's commitments (unbatched)
+ */
+bool verifyShare(const Commitments& commitments, size_t chunk, const Share& share, uint64_t blinding);
+
+/**
+ * Party ids whose shares do not match the commitments
+ *
+ * All parties are checked in one combined equation first; the per-party
+ * checks run only if that fails.
+ */
+std::vector<size_t> findInvalidParties(const Commitments& commitments, const std::vector<PartyShares>& parties);
+
+} // namespace vss
+
+#endif // VSS_HPP
@@ -0,0 +1,215 @@
+/**
+ * dudect-style timing test for the field backends
+ *
+ * Each measurement times one operation on an input drawn from one of two
+ * classes, chosen at random: a fixed input (all-zero share values, or 1 for
+ * inversion) or a fresh random one. Welch's t-test on the two timing
+ * distributions, after cropping the slowest 10% of samples, detects
+ * data-dependent timing; |t| above 10 is treated as a leak.
+ *
+ * ConstantTimeField must pass. FastField is measured and reported only, as a
+ * reference for what a leak looks like. The constant-time interpolation must
+ * also keep at least MIN_RELATIVE_THROUGHPUT of the fast path's throughput.
+ *
+ * Both timing gates depend on the host, so they only run with --timing
+ * (ctest -L timing in a -DMULTIPARTY_TIMING_TESTS=ON build). Without it the
+ * test checks that the two backends agree.
+ */
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#if defined(__x86_64__)
+#include <x86intrin.h>
+#endif
+
+#include "field_ops.hpp"
+#include "test_support.hpp"
+
+namespace {
+
+using test_support::PRIME;
+const size_t SAMPLES = 200000;
+const double T_THRESHOLD = 10.0;
+const double MIN_RELATIVE_THROUGHPUT = 0.5;
+const uint64_t XS[] = {1, 3, 5};
+
+volatile uint64_t sink;
+
+inline uint64_t timestamp() {
+#if defined(__x86_64__)
+    unsigned int aux;
+    return __rdtscp(&aux);
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+/**
+ * Welch's t statistic between class 0 and class 1 timings
+ */
+double welchT(const std::vector<uint64_t>& times, const std::vector<int>& classes) {
+    std::vector<uint64_t> sorted = times;
+    std::sort(sorted.begin(), sorted.end());
+    uint64_t cutoff = sorted[sorted.size() * 9 / 10];
+
+    double n[2] = {0, 0}, mean[2] = {0, 0}, m2[2] = {0, 0};
+    for (size_t i = 0; i < times.size(); ++i) {
+        if (times[i] > cutoff) {
+            continue;
+        }
+        int c = classes[i];
+        double x = static_cast<double>(times[i]);
+        n[c] += 1;
+        double delta = x - mean[c];
+        mean[c] += delta / n[c];
+        m2[c] += delta * (x - mean[c]);
+    }
+
+    double var0 = m2[0] / (n[0] - 1);
+    double var1 = m2[1] / (n[1] - 1);
+    return (mean[0] - mean[1]) / std::sqrt(var0 / n[0] + var1 / n[1]);
+}
+
+/**
+ * Time op(input) over SAMPLES inputs from the two classes
+ * @param make Produces the input for a class (0 = fixed, 1 = random)
+ */
+template <class Input, class Make, class Op>
+double measure(Make make, Op op) {
+    std::mt19937_64 rng(42);
+    std::vector<int> classes(SAMPLES);
+    std::vector<Input> inputs(SAMPLES);
+    for (size_t i = 0; i < SAMPLES; ++i) {
+        classes[i] = static_cast<int>(rng() & 1);
+        inputs[i] = make(classes[i], rng);
+    }
+
+    std::vector<uint64_t> times(SAMPLES);
+    for (size_t i = 0; i < SAMPLES; ++i) {
+        uint64_t start = timestamp();
+        sink = op(inputs[i]);
+        times[i] = timestamp() - start;
+    }
+    return welchT(times, classes);
+}
+
+using ShareValues = std::array<uint64_t, 3>;
+
+template <class Field>
+double interpolationLeak(const Field& field) {
+    return measure<ShareValues>(
+        [](int cls, std::mt19937_64& rng) {
+            ShareValues ys = {0, 0, 0};
+            if (cls == 1) {
+                for (auto& y : ys) y = rng() % PRIME;
+            }
+            return ys;
+        },
+        [&field](const ShareValues& ys) {
+            return field_ops::interpolateAtZero(field, XS, ys.data(), 3);
+        });
+}
+
+template <class Field>
+double inversionLeak(const Field& field) {
+    return measure<uint64_t>(
+        [](int cls, std::mt19937_64& rng) { return cls == 0 ? uint64_t(1) : 1 + rng() % (PRIME - 1); },
+        [&field](uint64_t a) { return field.inv(a); });
+}
+
+/**
+ * Interpolations per second over random share values
+ */
+template <class Field>
+double interpolationThroughput(const Field& field) {
+    const size_t iterations = 200000;
+    std::mt19937_64 rng(7);
+    std::vector<uint64_t> ys(iterations * 3);
+    for (auto& y : ys) y = rng() % PRIME;
+
+    auto start = std::chrono::steady_clock::now();
+    uint64_t acc = 0;
+    for (size_t i = 0; i < iterations; ++i) {
+        acc ^= field_ops::interpolateAtZero(field, XS, &ys[i * 3], 3);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    sink = acc;
+    return iterations / seconds;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    bool timing = argc > 1 && std::string(argv[1]) == "--timing";
+
+    field_ops::FastField fast(PRIME);
+    field_ops::ConstantTimeField constant_time(PRIME);
+
+    // Both backends must agree before timing means anything
+    std::mt19937_64 rng(1);
+    for (int i = 0; i < 10000; ++i) {
+        uint64_t a = rng() % PRIME, b = rng() % PRIME, e = rng();
+        if (fast.add(a, b) != constant_time.add(a, b) || fast.sub(a, b) != constant_time.sub(a, b) ||
+            fast.mul(a, b) != constant_time.mul(a, b) || fast.pow(a, e) != constant_time.pow(a, e) ||
+            (a != 0 && fast.inv(a) != constant_time.inv(a))) {
+            std::cerr << "Backends disagree for a=" << a << " b=" << b << std::endl;
+            return 1;
+        }
+    }
+    uint64_t big = ~uint64_t(0);
+    if (fast.reduce(big) != constant_time.reduce(big)) {
+        std::cerr << "reduce() mismatch" << std::endl;
+        return 1;
+    }
+    std::cout << "✓ Fast and constant-time backends agree" << std::endl;
+
+    if (!timing) {
+        std::cout << "Timing checks skipped (run with --timing)" << std::endl;
+        std::cout << "\nTest passed!" << std::endl;
+        return 0;
+    }
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "\nTiming leakage (Welch t, |t| > " << T_THRESHOLD << " = leak, "
+              << SAMPLES << " samples):" << std::endl;
+    double fast_interp = interpolationLeak(fast);
+    double fast_inv = inversionLeak(fast);
+    double ct_interp = interpolationLeak(constant_time);
+    double ct_inv = inversionLeak(constant_time);
+    std::cout << "  Fast          interpolate t = " << std::setw(8) << fast_interp
+              << "   inverse t = " << std::setw(8) << fast_inv << "  (reference)" << std::endl;
+    std::cout << "  ConstantTime  interpolate t = " << std::setw(8) << ct_interp
+              << "   inverse t = " << std::setw(8) << ct_inv << std::endl;
+
+    double fast_rate = interpolationThroughput(fast);
+    double ct_rate = interpolationThroughput(constant_time);
+    double relative = ct_rate / fast_rate;
+    std::cout << "\nInterpolation throughput (3 shares):" << std::endl;
+    std::cout << "  Fast          " << fast_rate / 1e6 << " M/s" << std::endl;
+    std::cout << "  ConstantTime  " << ct_rate / 1e6 << " M/s (" << relative * 100 << "% of fast)" << std::endl;
+
+    bool ok = true;
+    if (std::fabs(ct_interp) > T_THRESHOLD || std::fabs(ct_inv) > T_THRESHOLD) {
+        std::cerr << "✗ Constant-time backend shows data-dependent timing" << std::endl;
+        ok = false;
+    }
+    if (relative < MIN_RELATIVE_THROUGHPUT) {
+        std::cerr << "✗ Constant-time backend below " << MIN_RELATIVE_THROUGHPUT * 100
+                  << "% of fast-path throughput" << std::endl;
+        ok = false;
+    }
+
+    if (ok) {
+        std::cout << "\nTest passed!" << std::endl;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,118 @@
+// Compile-time (t, n) reconstruction: weights are evaluated by the compiler,
+// agree with generic interpolation for every subset and ordering, and the
+// runtime class only takes the fixed path for valid 3-of-5 share sets
+#include "fixed_threshold.hpp"
+#include "shamir_secret_sharing.hpp"
+#include "test_support.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Share = ShamirSecretSharing::Share;
+
+using test_support::PRIME;
+
+constexpr fixed_threshold::ShamirSecretSharing<3, 5, field_ops::FastField> FIXED(PRIME);
+
+// Ids {1, 2, 3}: L_1(0) = 3, L_2(0) = -3, L_3(0) = 1
+static_assert(FIXED.weight(0b00111, 1) == 3, "L_1(0) for {1,2,3}");
+static_assert(FIXED.weight(0b00111, 2) == PRIME - 3, "L_2(0) for {1,2,3}");
+static_assert(FIXED.weight(0b00111, 3) == 1, "L_3(0) for {1,2,3}");
+
+// f(x) = 7 + 2x + x^2 at x = 1, 2, 3
+constexpr Share LINE[3] = {{1, 10}, {2, 15}, {3, 22}};
+constexpr uint64_t fixedSecret() {
+    uint64_t secret = 0;
+    return FIXED.reconstruct(LINE, secret) ? secret : 0;
+}
+static_assert(fixedSecret() == 7, "Compile-time reconstruction");
+
+using test_support::expect;
+
+template <class Fixed>
+bool matchesGeneric(const Fixed& fixed, std::mt19937_64& rng) {
+    ShamirSecretSharing sss(3, 5, PRIME);
+    bool ok = true;
+    for (int round = 0; round < 20; ++round) {
+        uint64_t secret = rng() % PRIME;
+        auto shares = sss.split(secret);
+        for (uint64_t mask = 0; mask < 32; ++mask) {
+            if (__builtin_popcountll(mask) != 3) {
+                continue;
+            }
+            std::vector<Share> subset;
+            for (size_t i = 0; i < 5; ++i) {
+                if (mask & (1ULL << i)) {
+                    subset.push_back(shares[i]);
+                }
+            }
+            do {
+                uint64_t fixed_secret = 0;
+                ok = fixed.reconstruct(subset.data(), fixed_secret) && fixed_secret == secret && ok;
+                ok = sss.reconstruct(subset) == secret && ok;
+                std::vector<size_t> ids{subset[0].id, subset[1].id, subset[2].id};
+                std::vector<uint64_t> weights = sss.lagrangeWeights(ids);
+                for (size_t j = 0; j < 3; ++j) {
+                    ok = weights[j] == fixed.weight(mask, ids[j]) && ok;
+                }
+            } while (std::next_permutation(subset.begin(), subset.end(),
+                                           [](const Share& a, const Share& b) { return a.id < b.id; }));
+        }
+    }
+    return ok;
+}
+
+bool throws(ShamirSecretSharing& sss, const std::vector<Share>& shares) {
+    try {
+        sss.reconstruct(shares);
+        return false;
+    } catch (const std::invalid_argument&) {
+        return true;
+    }
+}
+
+} // namespace
+
+int main() {
+    std::cout << "Testing compile-time 3-of-5 reconstruction" << std::endl;
+    std::mt19937_64 rng(47);
+    bool ok = true;
+
+    ok = expect(matchesGeneric(FIXED, rng), "FastField table disagrees with interpolation") && ok;
+    static const fixed_threshold::ShamirSecretSharing<3, 5, field_ops::ConstantTimeField> constant_time(PRIME);
+    ok = expect(matchesGeneric(constant_time, rng), "ConstantTimeField table disagrees with interpolation") && ok;
+    if (ok) std::cout << "  ✓ All 10 subsets, every ordering, both fields" << std::endl;
+
+    // Invalid id sets are refused by the table and left to the generic checks
+    {
+        uint64_t untouched = 99;
+        Share duplicate[3] = {{1, 5}, {2, 6}, {1, 5}};
+        Share zero[3] = {{0, 5}, {2, 6}, {3, 7}};
+        Share beyond[3] = {{1, 5}, {2, 6}, {6, 7}};
+        ok = expect(!FIXED.reconstruct(duplicate, untouched) && !FIXED.reconstruct(zero, untouched) &&
+                        !FIXED.reconstruct(beyond, untouched) && untouched == 99,
+                    "Fixed path accepted invalid ids") && ok;
+
+        ShamirSecretSharing sss(3, 5, PRIME);
+        auto shares = sss.split(1234);
+        ok = expect(throws(sss, {shares[0], shares[1], shares[0]}), "Duplicate ids accepted") && ok;
+
+        // Ids outside 1..5 are legal input to the generic path
+        ShamirSecretSharing wide(3, 7, PRIME);
+        auto wide_shares = wide.split(4321);
+        ok = expect(sss.reconstruct({wide_shares[0], wide_shares[3], wide_shares[6]}) == 4321,
+                    "Out-of-table ids did not fall back") && ok;
+        if (ok) std::cout << "  ✓ Invalid ids fall back to the generic path" << std::endl;
+    }
+
+    if (!ok) {
+        return 1;
+    }
+    std::cout << "Test passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,173 @@
+// Hierarchical (Birkhoff) access structures: every authorized set reconstructs,
+// every other set is refused, refresh and cached weights keep working
+#include "shamir_secret_sharing.hpp"
+#include "test_support.hpp"
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Share = ShamirSecretSharing::Share;
+
+using test_support::PRIME;
+
+using test_support::expect;
+
+/**
+ * Check every non-empty subset of parties against the policy
+ */
+bool checkAllSubsets(ShamirSecretSharing& sss, const std::string& name, uint64_t secret,
+                     const std::vector<Share>& shares, size_t expected_authorized) {
+    bool ok = true;
+    size_t n = shares.size();
+    size_t authorized = 0;
+    for (uint64_t mask = 1; mask < (1ULL << n); ++mask) {
+        std::vector<Share> subset;
+        std::vector<size_t> ids;
+        for (size_t i = 0; i < n; ++i) {
+            if (mask & (1ULL << i)) {
+                subset.push_back(shares[i]);
+                ids.push_back(shares[i].id);
+            }
+        }
+        if (sss.isAuthorized(ids)) {
+            ++authorized;
+            ok = expect(sss.reconstruct(subset) == secret, name + ": authorized set did not reconstruct") && ok;
+            if (subset.size() == sss.getThreshold()) {
+                ok = expect(sss.reconstructWithWeights(sss.lagrangeWeights(ids), subset) == secret,
+                            name + ": cached weights did not reconstruct") && ok;
+            }
+        } else {
+            try {
+                sss.reconstruct(subset);
+                ok = expect(false, name + ": unauthorized set accepted") && ok;
+            } catch (const std::invalid_argument&) {
+            }
+        }
+    }
+    return expect(authorized == expected_authorized,
+                  name + ": " + std::to_string(authorized) + " authorized sets") && ok;
+}
+
+} // namespace
+
+int main() {
+    std::cout << "Testing hierarchical access structures" << std::endl;
+    std::mt19937_64 rng(42);
+    bool ok = true;
+
+    // The judiciary (party 1) plus any two others
+    {
+        ShamirSecretSharing sss(3, 5, PRIME);
+        sss.setHierarchy({0, 1, 1, 1, 1}, {1, 3});
+        uint64_t secret = rng() % PRIME;
+        auto shares = sss.split(secret);
+        // {1} with >= 2 of 4 others: C(4,2) + C(4,3) + C(4,4)
+        ok = checkAllSubsets(sss, "judiciary + any two", secret, shares, 11) && ok;
+        ok = expect(!sss.isAuthorized({2, 3, 4, 5}), "Four non-judicial parties authorized") && ok;
+
+        // Refresh keeps the secret and the policy
+        std::vector<ShamirSecretSharing::PartyShares> party_shares(5);
+        for (size_t i = 0; i < 5; ++i) party_shares[i] = {shares[i].id, {shares[i].value}};
+        auto sub_shares = sss.dealZeroSharing(1);
+        for (size_t i = 0; i < 5; ++i) sss.addSubShares(party_shares[i], sub_shares[i]);
+        std::vector<Share> refreshed;
+        for (auto& p : party_shares) refreshed.push_back({p.id, p.values[0]});
+        ok = checkAllSubsets(sss, "judiciary + any two, refreshed", secret, refreshed, 11) && ok;
+
+        try {
+            sss.reconstructRobust(shares);
+            ok = expect(false, "Error correction accepted hierarchical shares") && ok;
+        } catch (const std::invalid_argument&) {
+        }
+        if (ok) std::cout << "  ✓ Judiciary plus any two others" << std::endl;
+    }
+
+    // Three levels: 1 of {1,2}, 3 of {1..4}, 4 overall (t = 4 of 7)
+    {
+        ShamirSecretSharing sss(4, 7, PRIME);
+        sss.setHierarchy({0, 0, 1, 1, 2, 2, 2}, {1, 3, 4});
+        uint64_t secret = rng() % PRIME;
+        auto shares = sss.split(secret);
+        size_t expected = 0;
+        for (uint64_t mask = 1; mask < 128; ++mask) {
+            size_t l0 = __builtin_popcountll(mask & 0x3), l1 = __builtin_popcountll(mask & 0xC);
+            size_t l2 = __builtin_popcountll(mask & 0x70);
+            expected += l0 >= 1 && l0 + l1 >= 3 && l0 + l1 + l2 >= 4;
+        }
+        bool level_ok = checkAllSubsets(sss, "three levels", secret, shares, expected);
+        if (level_ok) std::cout << "  ✓ Three-level policy (" << expected << " authorized sets)" << std::endl;
+        ok = level_ok && ok;
+    }
+
+    // Small prime, and a flat hierarchy equals plain threshold
+    {
+        ShamirSecretSharing sss(3, 6, 65521);
+        sss.setHierarchy({0, 0, 0, 1, 1, 1}, {1, 3});
+        auto shares = sss.split(1234);
+        ok = checkAllSubsets(sss, "small prime", 1234, shares, 41) && ok;
+
+        ShamirSecretSharing flat(3, 5, PRIME);
+        flat.setHierarchy({0, 0, 0, 0, 0}, {3});
+        auto flat_shares = flat.split(99);
+        ok = checkAllSubsets(flat, "single level", 99, flat_shares, 16) && ok;
+        if (ok) std::cout << "  ✓ Small prime and single-level policy" << std::endl;
+    }
+
+    // Malformed policies
+    ShamirSecretSharing sss(3, 5, PRIME);
+    for (auto [levels, thresholds] : std::vector<std::pair<std::vector<size_t>, std::vector<size_t>>>{
+             {{0, 1, 1, 1}, {1, 3}},            // Too few parties
+             {{0, 1, 1, 1, 1}, {1, 2}},         // Last threshold is not t
+             {{0, 1, 1, 1, 1}, {2, 2, 3}},      // Not increasing
+             {{0, 1, 2, 1, 1}, {1, 3}}}) {      // Level without threshold
+        try {
+            sss.setHierarchy(levels, thresholds);
+            ok = expect(false, "Malformed policy accepted") && ok;
+        } catch (const std::invalid_argument&) {
+        }
+    }
+
+    // 20 of 40 is ~1.4e11 subsets: refused up front instead of enumerated
+    {
+        ShamirSecretSharing wide(20, 40, PRIME);
+        std::vector<size_t> levels(40, 1);
+        levels[0] = 0;
+        try {
+            wide.setHierarchy(levels, {1, 20});
+            ok = expect(false, "Policy with C(40, 20) subsets accepted") && ok;
+        } catch (const std::invalid_argument&) {
+        }
+        ok = expect(!wide.isHierarchical(), "Refused policy left a hierarchy behind") && ok;
+        if (ok) std::cout << "  ✓ Policies beyond " << ShamirSecretSharing::MAX_HIERARCHY_SUBSETS
+                          << " subsets refused" << std::endl;
+    }
+
+    // Policy-aware reconstruction is no slower than plain Lagrange (coefficients are precomputed)
+    {
+        ShamirSecretSharing plain(3, 5, PRIME), policy(3, 5, PRIME);
+        policy.setHierarchy({0, 1, 1, 1, 1}, {1, 3});
+        auto plain_shares = plain.split(7);
+        auto policy_shares = policy.split(7);
+        std::vector<Share> a{plain_shares[0], plain_shares[2], plain_shares[4]};
+        std::vector<Share> b{policy_shares[0], policy_shares[2], policy_shares[4]};
+        auto time = [](ShamirSecretSharing& s, const std::vector<Share>& shares) {
+            auto start = std::chrono::steady_clock::now();
+            volatile uint64_t sink = 0;
+            for (int i = 0; i < 20000; ++i) sink = sink + s.reconstruct(shares);
+            return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / 20000;
+        };
+        std::cout << "  Reconstruct: plain " << time(plain, a) << " us, hierarchical " << time(policy, b)
+                  << " us" << std::endl;
+    }
+
+    if (!ok) {
+        return 1;
+    }
+    std::cout << "Test passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,114 @@
+// Heap-free reconstruction: for t <= SSS_INLINE_THRESHOLD reconstruct makes no
+// allocations (plain and hierarchical), duplicates are still caught for small
+// and large ids, and larger thresholds still work through the heap fallback
+#include "inline_containers.hpp"
+#include "shamir_secret_sharing.hpp"
+#define TEST_SUPPORT_COUNT_ALLOCATIONS
+#include "test_support.hpp"
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Share = ShamirSecretSharing::Share;
+
+using test_support::PRIME;
+
+using test_support::expect;
+
+bool rejectsDuplicates(ShamirSecretSharing& sss, const std::vector<Share>& shares) {
+    try {
+        sss.reconstruct(shares);
+        return false;
+    } catch (const std::invalid_argument&) {
+        return true;
+    }
+}
+
+} // namespace
+
+int main() {
+    std::cout << "Testing heap-free reconstruction (inline up to t = " << SSS_INLINE_THRESHOLD << ")" << std::endl;
+    std::mt19937_64 rng(46);
+    bool ok = true;
+
+    for (size_t t : {size_t{2}, size_t{3}, size_t{5}, size_t{16}, size_t{SSS_INLINE_THRESHOLD}}) {
+        ShamirSecretSharing sss(t, t + 2, PRIME);
+        uint64_t secret = rng() % PRIME;
+        auto shares = sss.split(secret);
+        std::vector<Share> exact(shares.begin() + 2, shares.end());
+
+        size_t before = test_support::allocations;
+        bool correct = true;
+        for (int i = 0; i < 100; ++i) {
+            correct = sss.reconstruct(shares) == secret && correct;
+            correct = sss.reconstruct(exact.data(), exact.size()) == secret && correct;
+        }
+        size_t allocations = test_support::allocations - before;
+        std::string name = std::to_string(t) + "-of-" + std::to_string(t + 2);
+        ok = expect(correct, name + ": wrong secret") && ok;
+        ok = expect(allocations == 0, name + ": " + std::to_string(allocations) + " heap allocations") && ok;
+    }
+    if (ok) std::cout << "  ✓ Plain reconstruction allocates nothing" << std::endl;
+
+    // Hierarchical: the judiciary plus any two others
+    {
+        ShamirSecretSharing sss(3, 5, PRIME);
+        sss.setHierarchy({0, 1, 1, 1, 1}, {1, 3});
+        auto shares = sss.split(4242);
+        std::vector<Share> authorized{shares[4], shares[0], shares[2]};
+        size_t before = test_support::allocations;
+        bool correct = true;
+        for (int i = 0; i < 100; ++i) {
+            correct = sss.reconstruct(shares) == 4242 && correct;
+            correct = sss.reconstruct(authorized) == 4242 && correct;
+        }
+        size_t allocations = test_support::allocations - before;
+        ok = expect(correct, "hierarchical: wrong secret") && ok;
+        ok = expect(allocations == 0, "hierarchical: " + std::to_string(allocations) + " heap allocations") && ok;
+        if (ok) std::cout << "  ✓ Hierarchical reconstruction allocates nothing" << std::endl;
+    }
+
+    // Duplicates, small and large ids
+    {
+        ShamirSecretSharing sss(3, 5, PRIME);
+        auto shares = sss.split(77);
+        ok = expect(rejectsDuplicates(sss, {shares[0], shares[1], shares[0]}), "Small duplicate id accepted") && ok;
+        Share far_a{1000, 5}, far_b{1000, 6}, far_c{70000, 1};
+        ok = expect(rejectsDuplicates(sss, {far_a, shares[1], far_b}), "Large duplicate id accepted") && ok;
+        ok = expect(!rejectsDuplicates(sss, {far_a, far_c, shares[2]}), "Distinct large ids rejected") && ok;
+
+        inline_containers::IdSet ids;
+        ok = expect(ids.insert(0) && ids.insert(63) && ids.insert(64) && ids.insert(255) && ids.insert(256),
+                    "IdSet rejected a new id") && ok;
+        ok = expect(!ids.insert(63) && !ids.insert(64) && !ids.insert(256), "IdSet missed a repeat") && ok;
+        if (ok) std::cout << "  ✓ Duplicate ids rejected" << std::endl;
+    }
+
+    // Beyond the inline capacity: still correct, and InlineVector refuses to overflow
+    {
+        size_t t = SSS_INLINE_THRESHOLD + 1;
+        ShamirSecretSharing sss(t, t + 1, PRIME);
+        uint64_t secret = rng() % PRIME;
+        ok = expect(sss.reconstruct(sss.split(secret)) == secret, "Threshold above the inline capacity failed") && ok;
+
+        inline_containers::InlineVector<int, 2> small;
+        small.push_back(1);
+        small.push_back(2);
+        try {
+            small.push_back(3);
+            ok = expect(false, "InlineVector grew past its capacity") && ok;
+        } catch (const std::length_error&) {
+        }
+        if (ok) std::cout << "  ✓ Heap fallback above t = " << SSS_INLINE_THRESHOLD << std::endl;
+    }
+
+    if (!ok) {
+        return 1;
+    }
+    std::cout << "Test passed!" << std::endl;
+    return 0;
+}
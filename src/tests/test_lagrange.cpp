@@ -1,97 +1,100 @@
-#include <iostream>
+// Lagrange reconstruction through ShamirSecretSharing with known polynomials:
+// f(x) = 5 + 3x over the largest prime the field backend takes (sums there
+// wrap unless reduced carefully), every pair's weights, and a 3-of-5 over 2^61 - 1
+#include "shamir_secret_sharing.hpp"
+#include "test_support.hpp"
 #include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
 
-using BigInt = uint64_t;
-const BigInt PRIME = 18446744073709551557ULL;
+namespace {
 
-BigInt mod_add(BigInt a, BigInt b) {
-    return (a % PRIME + b % PRIME) % PRIME;
-}
+using Share = ShamirSecretSharing::Share;
+
+// The constant-time backend needs an odd prime below 2^63
+#if defined(SSS_CONSTANT_TIME) && SSS_CONSTANT_TIME
+const uint64_t PRIME = 9223372036854775783ULL;   // 2^63 - 25
+const char* const PRIME_NAME = "2^63 - 25";
+#else
+const uint64_t PRIME = 18446744073709551557ULL;  // 2^64 - 59
+const char* const PRIME_NAME = "2^64 - 59";
+#endif
+
+/**
+ * Hands out fixed coefficients a_1, a_2, ...
+ */
+class FixedSource : public coefficient_source::CoefficientSource {
+public:
+    explicit FixedSource(std::vector<uint64_t> coefficients) : coefficients_(std::move(coefficients)) {}
 
-BigInt mod_sub(BigInt a, BigInt b) {
-    a = a % PRIME;
-    b = b % PRIME;
-    if (a >= b) {
-        return (a - b) % PRIME;
-    } else {
-        return (PRIME - ((b - a) % PRIME)) % PRIME;
+    void generate(uint64_t, uint64_t* out, size_t count) override {
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = coefficients_[i % coefficients_.size()];
+        }
     }
-}
 
-BigInt mod_mul(BigInt a, BigInt b) {
-    __uint128_t result = (__uint128_t)(a % PRIME) * (b % PRIME);
-    return result % PRIME;
-}
+private:
+    std::vector<uint64_t> coefficients_;
+};
+
+using test_support::expect;
+
+} // namespace
 
-BigInt mod_pow(BigInt base, BigInt exp) {
-    BigInt result = 1;
-    base = base % PRIME;
-    
-    while (exp > 0) {
-        if (exp % 2 == 1) {
-            result = mod_mul(result, base);
+int main() {
+    std::cout << "Testing Lagrange reconstruction with known polynomials" << std::endl;
+    bool ok = true;
+
+    // f(x) = 5 + 3x: shares 8, 11, 14
+    {
+        ShamirSecretSharing sss(2, 3, PRIME, std::make_unique<FixedSource>(std::vector<uint64_t>{3}));
+        auto shares = sss.split(5);
+        ok = expect(shares[0].value == 8 && shares[1].value == 11 && shares[2].value == 14,
+                    "Shares of 5 + 3x are not 8, 11, 14") && ok;
+
+        // L_1(0) = 2, L_2(0) = -1
+        auto weights = sss.lagrangeWeights({1, 2});
+        ok = expect(weights[0] == 2 && weights[1] == PRIME - 1, "Weights for ids {1, 2} are not (2, -1)") && ok;
+        for (size_t i = 0; i < 3; ++i) {
+            for (size_t j = 0; j < 3; ++j) {
+                if (i != j) {
+                    ok = expect(sss.reconstruct({shares[i], shares[j]}) == 5,
+                                "Pair " + std::to_string(i + 1) + "," + std::to_string(j + 1) + " missed 5") && ok;
+                }
+            }
         }
-        exp = exp >> 1;
-        base = mod_mul(base, base);
+        if (ok) std::cout << "  ✓ f(x) = 5 + 3x from every ordered pair" << std::endl;
     }
-    
-    return result;
-}
 
-BigInt mod_inv(BigInt a) {
-    if (a == 0) {
-        throw std::runtime_error("Modular inverse of 0 does not exist");
+    // Near the top of the field: the coefficient p - 1 makes f(x) = s - x
+    {
+        uint64_t secret = PRIME - 2;
+        ShamirSecretSharing sss(2, 3, PRIME, std::make_unique<FixedSource>(std::vector<uint64_t>{PRIME - 1}));
+        auto shares = sss.split(secret);
+        ok = expect(shares[0].value == PRIME - 3 && shares[2].value == PRIME - 5, "Shares of (p - 2) - x") && ok;
+        ok = expect(sss.reconstruct({shares[2], shares[0]}) == secret, "Reconstruction near p wrapped") && ok;
+        if (ok) std::cout << "  ✓ Values near " << PRIME_NAME << std::endl;
     }
-    
-    a = a % PRIME;
-    return mod_pow(a, PRIME - 2);
-}
 
-int main() {
-    // Test simple case: secret = 5, threshold = 2, shares = 3
-    // f(x) = 5 + 3x  (random coefficient a1 = 3)
-    BigInt secret = 5;
-    BigInt a1 = 3;
-    
-    // Generate shares: f(1) = 8, f(2) = 11, f(3) = 14
-    BigInt s1 = mod_add(secret, mod_mul(a1, 1)); // 5 + 3*1 = 8
-    BigInt s2 = mod_add(secret, mod_mul(a1, 2)); // 5 + 3*2 = 11
-    BigInt s3 = mod_add(secret, mod_mul(a1, 3)); // 5 + 3*3 = 14
-    
-    std::cout << "Secret: " << secret << std::endl;
-    std::cout << "Share 1 (x=1): " << s1 << std::endl;
-    std::cout << "Share 2 (x=2): " << s2 << std::endl;
-    std::cout << "Share 3 (x=3): " << s3 << std::endl;
-    std::cout << std::endl;
-    
-    // Reconstruct using shares 1 and 2
-    // f(0) = s1 * L1(0) + s2 * L2(0)
-    // L1(0) = (0-2)/(1-2) = -2/-1 = 2
-    // L2(0) = (0-1)/(2-1) = -1/1 = -1
-    
-    BigInt num1 = mod_sub(0, 2);  // -2
-    BigInt den1 = mod_sub(1, 2);  // -1
-    BigInt L1 = mod_mul(num1, mod_inv(den1));
-    
-    BigInt num2 = mod_sub(0, 1);  // -1
-    BigInt den2 = mod_sub(2, 1);  // 1
-    BigInt L2 = mod_mul(num2, mod_inv(den2));
-    
-    std::cout << "L1(0) numerator (0-2): " << num1 << std::endl;
-    std::cout << "L1(0) denominator (1-2): " << den1 << std::endl;
-    std::cout << "L1(0): " << L1 << std::endl;
-    std::cout << std::endl;
-    
-    std::cout << "L2(0) numerator (0-1): " << num2 << std::endl;
-    std::cout << "L2(0) denominator (2-1): " << den2 << std::endl;
-    std::cout << "L2(0): " << L2 << std::endl;
-    std::cout << std::endl;
-    
-    BigInt reconstructed = mod_add(mod_mul(s1, L1), mod_mul(s2, L2));
-    
-    std::cout << "Reconstructed: " << reconstructed << std::endl;
-    std::cout << "Expected: " << secret << std::endl;
-    std::cout << "Match: " << (reconstructed == secret ? "YES" : "NO") << std::endl;
-    
+    // f(x) = 42 + 7x + 11x^2 over 2^61 - 1: shares 60, 100, 162, 246, 352
+    {
+        ShamirSecretSharing sss(3, 5, 2305843009213693951ULL,
+                                std::make_unique<FixedSource>(std::vector<uint64_t>{7, 11}));
+        auto shares = sss.split(42);
+        const uint64_t expected[5] = {60, 100, 162, 246, 352};
+        for (size_t i = 0; i < 5; ++i) {
+            ok = expect(shares[i].value == expected[i], "Share " + std::to_string(i + 1) + " of 42 + 7x + 11x^2") && ok;
+        }
+        ok = expect(sss.reconstruct({shares[4], shares[0], shares[2]}) == 42, "3-of-5 reconstruction") && ok;
+        ok = expect(sss.reconstruct(shares) == 42, "Reconstruction from all five shares") && ok;
+        if (ok) std::cout << "  ✓ Quadratic over 2^61 - 1" << std::endl;
+    }
+
+    if (!ok) {
+        return 1;
+    }
+    std::cout << "Test passed!" << std::endl;
     return 0;
 }
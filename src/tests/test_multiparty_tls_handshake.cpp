@@ -9,7 +9,11 @@
  * - Client initiates TLS handshake
  * - 3 parties collaborate to decrypt the Pre-Master Secret
  * - Session keys are derived and secure communication is established
+ *
+ * The simulated server works on a bare RSA struct, like pre-3.0 TLS
+ * stacks did, so the deprecated RSA API is used on purpose.
  */
+#define OPENSSL_SUPPRESS_DEPRECATED
 
 #include "shamir_secret_sharing.hpp"
 #include <openssl/rsa.h>
@@ -186,11 +190,9 @@ public:
             std::cout << " shifting..." << std::flush;
             BN_rshift(chunk_bn, d, chunk_idx * CHUNK_BITS);
             
-            BIGNUM* mask = BN_new();
-            BN_set_word(mask, 1);
-            BN_lshift(mask, mask, CHUNK_BITS);
-            BN_sub_word(mask, 1);
-            BN_mod(chunk_bn, chunk_bn, mask, nullptr);
+            // Keep the low CHUNK_BITS (reducing mod 2^61 - 1 would fold the
+            // higher bits back in, and BN_mod needs a BN_CTX)
+            BN_mask_bits(chunk_bn, CHUNK_BITS);
             
             // BN_get_word returns the value if it fits in a word, otherwise BN_MASK2
             // We need to check if it fits first
@@ -198,14 +200,12 @@ public:
                 std::cerr << "\nError: chunk " << chunk_idx << " is too large (" 
                           << BN_num_bits(chunk_bn) << " bits)" << std::endl;
                 BN_free(chunk_bn);
-                BN_free(mask);
                 return false;
             }
             
             uint64_t chunk_value = BN_get_word(chunk_bn);
             
             BN_free(chunk_bn);
-            BN_free(mask);
             
             // Check for BN_get_word error (returns max value on error)
             if (chunk_value == UINT64_MAX) {
@@ -406,17 +406,16 @@ bool collaborativeDecrypt(
         // Reconstruct chunk value
         uint64_t chunk_value = sss.reconstruct(chunk_shares);
         
-        // Accumulate into full d: d = (d << 61) | chunk_value
-        BN_lshift(reconstructed_d, reconstructed_d, MultiPartyTLSServer::CHUNK_BITS);
-        
+        // Accumulate into full d (chunk 0 holds the least significant bits)
         BIGNUM* chunk_bn = BN_new();
         BN_set_word(chunk_bn, chunk_value);
+        BN_lshift(chunk_bn, chunk_bn, chunk_idx * MultiPartyTLSServer::CHUNK_BITS);
         BN_add(reconstructed_d, reconstructed_d, chunk_bn);
         BN_free(chunk_bn);
     }
     
     auto recon_end = std::chrono::high_resolution_clock::now();
-    auto recon_duration = std::chrono::duration_cast<std::chrono::milliseconds>(start - recon_end);
+    auto recon_duration = std::chrono::duration_cast<std::chrono::milliseconds>(recon_end - start);
     
     std::cout << "✓ Private key reconstructed (" << BN_num_bits(reconstructed_d) 
               << " bits) in " << recon_duration.count() << " ms" << std::endl;
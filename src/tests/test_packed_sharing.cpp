@@ -0,0 +1,88 @@
+// Packed (Franklin-Yung) sharing: k secrets per polynomial round-trip from any
+// t + k - 1 shares, fewer are refused
+#include "shamir_secret_sharing.hpp"
+#include "test_support.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Share = ShamirSecretSharing::Share;
+
+using test_support::Scenario;
+using test_support::expect;
+
+bool checkPacked(const Scenario& scenario, std::mt19937_64& rng) {
+    const size_t t = scenario.t, n = scenario.n;
+    const uint64_t prime = scenario.prime;
+    ShamirSecretSharing sss(t, n, prime);
+    const std::string name = scenario.name();
+    bool ok = true;
+
+    for (size_t k = 1; k + t - 1 <= n; ++k) {
+        std::vector<uint64_t> secrets(scenario.num_chunks);
+        for (auto& secret : secrets) secret = rng() % prime;
+        auto packed = sss.splitPacked(secrets, k);
+        size_t groups = (secrets.size() + k - 1) / k;
+        ok = expect(packed.size() == groups, name + ": wrong group count") && ok;
+
+        // Any t + k - 1 parties, in any order
+        std::vector<size_t> parties(n);
+        for (size_t i = 0; i < n; ++i) parties[i] = i;
+        std::shuffle(parties.begin(), parties.end(), rng);
+        parties.resize(t + k - 1);
+        std::vector<std::vector<Share>> received(groups);
+        for (size_t g = 0; g < groups; ++g) {
+            for (size_t p : parties) received[g].push_back(packed[g][p]);
+        }
+        auto recovered = sss.reconstructPacked(received, k);
+        ok = expect(recovered.size() == groups * k, name + ": wrong secret count") && ok;
+        ok = expect(std::equal(secrets.begin(), secrets.end(), recovered.begin()),
+                    name + ", k = " + std::to_string(k) + ": secrets not recovered") && ok;
+        ok = expect(std::all_of(recovered.begin() + secrets.size(), recovered.end(),
+                                [](uint64_t v) { return v == 0; }),
+                    name + ": padding not zero") && ok;
+
+        // One share short
+        for (auto& shares : received) shares.pop_back();
+        try {
+            sss.reconstructPacked(received, k);
+            ok = expect(false, name + ": too few shares accepted") && ok;
+        } catch (const std::invalid_argument&) {
+        }
+    }
+
+    // k = 1 is ordinary sharing
+    auto plain = sss.splitPacked({12345}, 1);
+    ok = expect(sss.reconstruct(plain[0]) == 12345, name + ": k = 1 differs from plain sharing") && ok;
+
+    try {
+        sss.splitPacked({1, 2}, n - t + 2);
+        ok = expect(false, name + ": pack size beyond the trust margin accepted") && ok;
+    } catch (const std::invalid_argument&) {
+    }
+
+    if (ok) {
+        std::cout << "  ✓ " << name << " (k up to " << n - t + 1 << ")" << std::endl;
+    }
+    return ok;
+}
+
+} // namespace
+
+int main() {
+    std::cout << "Testing packed secret sharing" << std::endl;
+    std::mt19937_64 rng(43);
+    bool ok = test_support::runScenarios({{3, 5}, {3, 9}, {5, 16}, {2, 2}, {3, 7, 65521}},
+                                         [&](const Scenario& scenario) { return checkPacked(scenario, rng); });
+
+    if (!ok) {
+        return 1;
+    }
+    std::cout << "Test passed!" << std::endl;
+    return 0;
+}
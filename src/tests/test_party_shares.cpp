@@ -0,0 +1,122 @@
+// Compact per-party share layout: splitChunks/reconstructChunks round-trip the
+// chunks of 4096- and 8192-bit keys from any authorized subset, agree with
+// per-chunk reconstruction, and reject inconsistent input
+#include "shamir_secret_sharing.hpp"
+#include "test_support.hpp"
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Share = ShamirSecretSharing::Share;
+using PartyShares = ShamirSecretSharing::PartyShares;
+
+using test_support::PRIME;
+
+using test_support::expect;
+
+std::vector<uint64_t> randomChunks(std::mt19937_64& rng, size_t count) {
+    std::vector<uint64_t> chunks(count);
+    for (auto& chunk : chunks) {
+        chunk = rng() % PRIME;
+    }
+    return chunks;
+}
+
+bool throwsInvalid(const ShamirSecretSharing& sss, const std::vector<const PartyShares*>& parties) {
+    std::vector<uint64_t> out(parties.empty() ? 0 : parties[0]->values.size());
+    try {
+        sss.reconstructChunks(parties, out.data());
+        return false;
+    } catch (const std::invalid_argument&) {
+        return true;
+    }
+}
+
+} // namespace
+
+int main() {
+    std::cout << "Testing per-party share arrays" << std::endl;
+    std::mt19937_64 rng(48);
+    bool ok = true;
+
+    // 4096- and 8192-bit private exponents: 68 and 135 chunks of 61 bits
+    for (size_t num_chunks : {size_t{68}, size_t{135}}) {
+        ShamirSecretSharing sss(3, 5, PRIME);
+        auto chunks = randomChunks(rng, num_chunks);
+        auto parties = sss.splitChunks(chunks.data(), chunks.size());
+        ok = expect(parties.size() == 5, "Wrong number of parties") && ok;
+        for (size_t i = 0; i < parties.size(); ++i) {
+            ok = expect(parties[i].id == i + 1 && parties[i].values.size() == num_chunks,
+                        "Party " + std::to_string(i + 1) + " has the wrong layout") && ok;
+        }
+
+        std::vector<uint64_t> out(num_chunks);
+        for (uint64_t mask = 0; mask < 32; ++mask) {
+            if (__builtin_popcountll(mask) < 3) {
+                continue;
+            }
+            std::vector<const PartyShares*> present;
+            for (size_t i = 0; i < 5; ++i) {
+                if (mask & (1ULL << i)) {
+                    present.push_back(&parties[i]);
+                }
+            }
+            sss.reconstructChunks(present, out.data());
+            ok = expect(out == chunks, std::to_string(num_chunks) + " chunks: subset " + std::to_string(mask) +
+                                           " reconstructed wrongly") && ok;
+        }
+
+        // Same answer as rebuilding a Share per chunk
+        bool same = true;
+        for (size_t c = 0; c < num_chunks; ++c) {
+            std::vector<Share> shares{{parties[4].id, parties[4].values[c]}, {parties[1].id, parties[1].values[c]},
+                                      {parties[2].id, parties[2].values[c]}};
+            same = sss.reconstruct(shares) == chunks[c] && same;
+        }
+        ok = expect(same, "Per-chunk reconstruction disagrees") && ok;
+    }
+    if (ok) std::cout << "  ✓ 68 and 135 chunks from every authorized subset" << std::endl;
+
+    // Hierarchical policy: the judiciary plus any two others
+    {
+        ShamirSecretSharing sss(3, 5, PRIME);
+        sss.setHierarchy({0, 1, 1, 1, 1}, {1, 3});
+        auto chunks = randomChunks(rng, 40);
+        auto parties = sss.splitChunks(chunks.data(), chunks.size());
+        std::vector<uint64_t> out(chunks.size());
+        sss.reconstructChunks({&parties[3], &parties[0], &parties[1]}, out.data());
+        ok = expect(out == chunks, "Hierarchical chunks reconstructed wrongly") && ok;
+        ok = expect(throwsInvalid(sss, {&parties[1], &parties[2], &parties[3]}), "Unauthorized set accepted") && ok;
+        if (ok) std::cout << "  ✓ Hierarchical policy" << std::endl;
+    }
+
+    // Inconsistent input
+    {
+        ShamirSecretSharing sss(3, 5, PRIME);
+        auto chunks = randomChunks(rng, 10);
+        auto parties = sss.splitChunks(chunks.data(), chunks.size());
+        ok = expect(throwsInvalid(sss, {&parties[0], &parties[1]}), "Too few parties accepted") && ok;
+        ok = expect(throwsInvalid(sss, {&parties[0], &parties[1], &parties[0]}), "Duplicate party accepted") && ok;
+        PartyShares short_party = parties[2];
+        short_party.values.pop_back();
+        ok = expect(throwsInvalid(sss, {&parties[0], &parties[1], &short_party}), "Chunk count mismatch accepted") && ok;
+
+        uint64_t too_large[2] = {1, PRIME};
+        try {
+            sss.splitChunks(too_large, 2);
+            ok = expect(false, "Secret above the prime accepted") && ok;
+        } catch (const std::invalid_argument&) {
+        }
+        if (ok) std::cout << "  ✓ Inconsistent input rejected" << std::endl;
+    }
+
+    if (!ok) {
+        return 1;
+    }
+    std::cout << "Test passed!" << std::endl;
+    return 0;
+}
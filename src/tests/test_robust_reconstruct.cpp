@@ -0,0 +1,155 @@
+// Error-correcting reconstruction: up to floor((m - t) / 2) wrong shares per
+// chunk are corrected and attributed, one more is refused. Also checks the
+// cached Lagrange weights used for subset retry.
+#include "shamir_secret_sharing.hpp"
+#include "test_support.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Share = ShamirSecretSharing::Share;
+
+/**
+ * chunk_shares[c] for num_chunks random secrets, all n shares
+ */
+std::vector<std::vector<Share>> dealChunks(ShamirSecretSharing& sss, std::vector<uint64_t>& secrets,
+                                           std::mt19937_64& rng) {
+    std::vector<std::vector<Share>> chunk_shares;
+    for (auto& secret : secrets) {
+        secret = rng() % sss.getPrime();
+        chunk_shares.push_back(sss.split(secret));
+    }
+    return chunk_shares;
+}
+
+/**
+ * Corrupt the shares at the given positions in every chunk (or only in chunk `only`)
+ */
+void corrupt(std::vector<std::vector<Share>>& chunk_shares, const std::vector<size_t>& positions,
+             uint64_t prime, std::mt19937_64& rng, size_t only = SIZE_MAX) {
+    for (size_t c = 0; c < chunk_shares.size(); ++c) {
+        if (only != SIZE_MAX && c != only) continue;
+        for (size_t pos : positions) {
+            auto& value = chunk_shares[c][pos].value;
+            value = (value + 1 + rng() % (prime - 1)) % prime;
+        }
+    }
+}
+
+using test_support::PRIME;
+using test_support::Scenario;
+using test_support::expect;
+
+bool checkRobust(const Scenario& scenario, std::mt19937_64& rng) {
+    const size_t t = scenario.t, n = scenario.n;
+    const uint64_t prime = scenario.prime;
+    ShamirSecretSharing sss(t, n, prime);
+    const size_t max_errors = (n - t) / 2;
+    const std::string name = scenario.name();
+    std::vector<uint64_t> secrets(scenario.num_chunks);
+    bool ok = true;
+
+    // Errors at random positions (inside and outside the first t shares)
+    for (size_t errors = 0; errors <= max_errors; ++errors) {
+        auto chunk_shares = dealChunks(sss, secrets, rng);
+        std::vector<size_t> positions(n);
+        for (size_t i = 0; i < n; ++i) positions[i] = i;
+        std::shuffle(positions.begin(), positions.end(), rng);
+        positions.resize(errors);
+        corrupt(chunk_shares, positions, prime, rng);
+
+        std::vector<size_t> bad_ids;
+        auto recovered = sss.reconstructRobust(chunk_shares, &bad_ids);
+        std::set<size_t> expected_ids;
+        for (size_t pos : positions) expected_ids.insert(pos + 1);
+        ok = expect(recovered == secrets, name + ": " + std::to_string(errors) + " wrong shares not corrected") &&
+             expect(std::set<size_t>(bad_ids.begin(), bad_ids.end()) == expected_ids,
+                    name + ": wrong shares misattributed") && ok;
+    }
+
+    // A different party wrong in each chunk: per-chunk error count stays in range
+    {
+        auto chunk_shares = dealChunks(sss, secrets, rng);
+        for (size_t c = 0; c < chunk_shares.size(); ++c) {
+            corrupt(chunk_shares, {c % n}, prime, rng, c);
+        }
+        if (max_errors >= 1) {
+            ok = expect(sss.reconstructRobust(chunk_shares) == secrets,
+                        name + ": rotating wrong share not corrected") && ok;
+        }
+    }
+
+    // Single-secret overload, shares given out of order and as a subset
+    {
+        auto chunk_shares = dealChunks(sss, secrets, rng);
+        std::vector<Share> shares(chunk_shares[0].rbegin(), chunk_shares[0].rend() - (n > t));
+        ok = expect(sss.reconstructRobust(shares) == secrets[0], name + ": single-secret overload") && ok;
+    }
+
+    // One error too many must not yield a silently wrong secret
+    if (n > t) {
+        auto chunk_shares = dealChunks(sss, secrets, rng);
+        std::vector<size_t> positions;
+        for (size_t i = 0; i <= max_errors; ++i) positions.push_back(i);
+        corrupt(chunk_shares, positions, prime, rng);
+        try {
+            sss.reconstructRobust(chunk_shares);
+            ok = expect(false, name + ": too many errors not refused") && ok;
+        } catch (const std::runtime_error&) {
+        }
+    }
+
+    if (ok) {
+        std::cout << "  ✓ " << name << " (corrects " << max_errors << ")" << std::endl;
+    }
+    return ok;
+}
+
+} // namespace
+
+int main() {
+    std::cout << "Testing error-correcting reconstruction" << std::endl;
+    std::mt19937_64 rng(40);
+    bool ok = test_support::runScenarios({{2, 3}, {3, 5}, {3, 9}, {4, 7}, {6, 16}, {5, 5}, {3, 7, 65521}},
+                                         [&](const Scenario& scenario) { return checkRobust(scenario, rng); });
+
+    // Cached weights for a subset reconstruct every secret shared among it
+    ShamirSecretSharing sss(3, 5, PRIME);
+    auto shares = sss.split(42);
+    auto weights = sss.lagrangeWeights({5, 2, 4});
+    for (uint64_t secret : {uint64_t{0}, uint64_t{42}, PRIME - 1}) {
+        auto split = sss.split(secret);
+        ok = expect(sss.reconstructWithWeights(weights, {split[4], split[1], split[3]}) == secret,
+                    "Cached weights do not reconstruct") && ok;
+    }
+
+    // Input validation
+    try {
+        sss.reconstructRobust({shares[0], shares[1]});
+        ok = expect(false, "Fewer than t shares accepted");
+    } catch (const std::invalid_argument&) {
+    }
+    try {
+        sss.reconstructRobust({shares[0], shares[1], shares[1], shares[2]});
+        ok = expect(false, "Duplicate share ids accepted");
+    } catch (const std::invalid_argument&) {
+    }
+    try {
+        sss.reconstructRobust(std::vector<std::vector<Share>>{{shares[0], shares[1], shares[2]},
+                                                              {shares[0], shares[2], shares[1]}});
+        ok = expect(false, "Chunks with different id order accepted");
+    } catch (const std::invalid_argument&) {
+    }
+
+    if (!ok) {
+        return 1;
+    }
+    std::cout << "Test passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,135 @@
+// SecretBuffer semantics and the TLS 1.2 key schedule: output matches
+// OpenSSL's TLS1-PRF, and a session's derivation makes no heap allocations
+// (counted through both operator new and OpenSSL's allocator)
+#include "tls_multiparty.hpp"
+#define TEST_SUPPORT_COUNT_ALLOCATIONS
+#include "test_support.hpp"
+#include <openssl/core_names.h>
+#include <openssl/crypto.h>
+#include <openssl/kdf.h>
+#include <openssl/params.h>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+namespace {
+
+void* countingMalloc(size_t size, const char*, int) {
+    ++test_support::allocations;
+    return malloc(size);
+}
+
+void* countingRealloc(void* block, size_t size, const char*, int) {
+    ++test_support::allocations;
+    return realloc(block, size);
+}
+
+void countingFree(void* block, const char*, int) {
+    free(block);
+}
+
+using secure_arena::ByteSpan;
+using secure_arena::SecretBuffer;
+
+using test_support::expect;
+
+/**
+ * Reference TLS 1.2 PRF through the OpenSSL KDF
+ */
+SecretBuffer referencePrf(ByteSpan secret, const char* label, ByteSpan seed_first, ByteSpan seed_second,
+                          size_t length) {
+    SecretBuffer out(length);
+    EVP_KDF* kdf = EVP_KDF_fetch(nullptr, "TLS1-PRF", nullptr);
+    EVP_KDF_CTX* ctx = EVP_KDF_CTX_new(kdf);
+    std::string seed = std::string(label) + std::string(seed_first.begin(), seed_first.end()) +
+                       std::string(seed_second.begin(), seed_second.end());
+    OSSL_PARAM params[] = {
+        OSSL_PARAM_construct_utf8_string(OSSL_KDF_PARAM_DIGEST, const_cast<char*>("SHA256"), 0),
+        OSSL_PARAM_construct_octet_string(OSSL_KDF_PARAM_SECRET, const_cast<uint8_t*>(secret.data()),
+                                          secret.size()),
+        OSSL_PARAM_construct_octet_string(OSSL_KDF_PARAM_SEED, seed.data(), seed.size()),
+        OSSL_PARAM_construct_end()};
+    if (EVP_KDF_derive(ctx, out.data(), out.size(), params) != 1) {
+        out.clear();
+    }
+    EVP_KDF_CTX_free(ctx);
+    EVP_KDF_free(kdf);
+    return out;
+}
+
+} // namespace
+
+int main() {
+    // Must run before OpenSSL allocates anything
+    bool counting_openssl = CRYPTO_set_mem_functions(countingMalloc, countingRealloc, countingFree) == 1;
+
+    std::cout << "Testing SecretBuffer and the allocation-free key schedule" << std::endl;
+    bool ok = true;
+
+    // Inline up to 48 bytes, arena beyond; moves transfer, clones copy
+    {
+        auto random = TLSMultiParty::generateRandom(128);
+        SecretBuffer pms(ByteSpan(random.data(), 48));
+        SecretBuffer block(ByteSpan(random.data(), 128));
+        ok = expect(pms.isInline() && SecretBuffer(32).isInline(), "32/48-byte secrets not inline") && ok;
+        ok = expect(!block.isInline(), "128-byte secret inline") && ok;
+
+        SecretBuffer copy = pms.clone();
+        ok = expect(copy == pms && copy.data() != pms.data(), "Clone differs") && ok;
+        SecretBuffer moved = std::move(pms);
+        ok = expect(moved == copy && pms.empty(), "Inline move did not transfer") && ok;
+        const uint8_t* block_data = block.data();
+        SecretBuffer moved_block = std::move(block);
+        ok = expect(moved_block.data() == block_data && block.empty() && block.isInline(),
+                    "Arena move copied instead of transferring") && ok;
+        moved_block.clear();
+        ok = expect(moved_block.empty() && moved_block.isInline(), "Clear did not release") && ok;
+        ok = expect(copy != SecretBuffer(ByteSpan(random.data() + 1, 48)), "Different secrets compare equal") && ok;
+        if (ok) std::cout << "  ✓ Inline storage, moves and clones" << std::endl;
+    }
+
+    TLSMultiParty tls(3, 5);
+    auto client_random = TLSMultiParty::generateRandom(32);
+    auto server_random = TLSMultiParty::generateRandom(32);
+    auto pre_master_secret = TLSMultiParty::generateRandom(48);
+
+    // Same bytes as OpenSSL's TLS 1.2 PRF
+    {
+        SecretBuffer master = tls.deriveMasterSecret(pre_master_secret, client_random, server_random);
+        SecretBuffer key_block = tls.deriveKeyBlock(master, client_random, server_random, 104);
+        ok = expect(master == referencePrf(pre_master_secret, "master secret", client_random, server_random, 48),
+                    "Master secret differs from TLS1-PRF") && ok;
+        ok = expect(key_block == referencePrf(master, "key expansion", server_random, client_random, 104),
+                    "Key block differs from TLS1-PRF") && ok;
+        SecretBuffer long_key(ByteSpan(key_block.data(), 100));   // Key longer than a SHA-256 block
+        ok = expect(tls.deriveKeyBlock(long_key, client_random, server_random, 7) ==
+                        referencePrf(long_key, "key expansion", server_random, client_random, 7),
+                    "Long-key PRF differs from TLS1-PRF") && ok;
+        if (ok) std::cout << "  ✓ Matches OpenSSL TLS1-PRF" << std::endl;
+    }
+
+    // Per-session derivation allocates nothing once the arena is warm
+    {
+        const size_t sessions = 1000;
+        size_t before = test_support::allocations;
+        for (size_t i = 0; i < sessions; ++i) {
+            SecretBuffer master = tls.deriveMasterSecret(pre_master_secret, client_random, server_random);
+            SecretBuffer key_block = tls.deriveKeyBlock(master, client_random, server_random, 128);
+            pre_master_secret[0] ^= key_block[0];
+        }
+        size_t allocations = test_support::allocations - before;
+        ok = expect(allocations == 0, std::to_string(allocations) + " heap allocations in " +
+                                          std::to_string(sessions) + " sessions") && ok;
+        if (ok) {
+            std::cout << "  ✓ " << sessions << " sessions, 0 heap allocations"
+                      << (counting_openssl ? " (operator new and OpenSSL)" : " (operator new only)") << std::endl;
+        }
+    }
+
+    if (!ok) {
+        return 1;
+    }
+    std::cout << "Test passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,140 @@
+// Secure arena: blocks are recycled without new mappings, wiped when freed or
+// reset, and running off a region hits a guard page
+#include "secure_arena.hpp"
+#include "test_support.hpp"
+#include <sys/wait.h>
+#include <unistd.h>
+#include <algorithm>
+#include <csignal>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+namespace {
+
+using secure_arena::Arena;
+using secure_arena::ArenaAllocator;
+using secure_arena::SecureBytes;
+using secure_arena::SecureVector;
+
+using test_support::expect;
+
+bool allZero(const uint8_t* bytes, size_t length) {
+    return std::all_of(bytes, bytes + length, [](uint8_t b) { return b == 0; });
+}
+
+/**
+ * Run fn in a child process
+ * @return true if the child died of SIGSEGV
+ */
+template <class Fn>
+bool faultsInChild(Fn fn) {
+    pid_t pid = fork();
+    if (pid == 0) {
+        fn();
+        _exit(0);
+    }
+    int status = 0;
+    waitpid(pid, &status, 0);
+    return WIFSIGNALED(status) && WTERMSIG(status) == SIGSEGV;
+}
+
+} // namespace
+
+int main() {
+    std::cout << "Testing the secure arena" << std::endl;
+    bool ok = true;
+
+    // Containers work through the allocator
+    {
+        Arena arena;
+        SecureBytes bytes(ArenaAllocator<uint8_t>{arena});
+        for (int i = 0; i < 1000; ++i) bytes.push_back(static_cast<uint8_t>(i));
+        SecureBytes copy = bytes;
+        ok = expect(copy == bytes && copy.size() == 1000 && copy[999] == static_cast<uint8_t>(999),
+                    "Copy of a secure buffer differs") && ok;
+        SecureVector<uint64_t> values(64, 7, ArenaAllocator<uint64_t>{arena});
+        ok = expect(values[63] == 7, "Secure vector lost its values") && ok;
+        if (ok) std::cout << "  ✓ Containers over the arena" << std::endl;
+    }
+
+    // Freed blocks are reused: a steady loop maps nothing new
+    {
+        Arena arena;
+        ArenaAllocator<uint8_t> alloc(arena);
+        for (int i = 0; i < 10; ++i) {
+            SecureBytes warm(48, 1, alloc);
+        }
+        size_t regions = arena.regionCount();
+        const uint8_t* first = nullptr;
+        bool same_block = true;
+        for (int i = 0; i < 10000; ++i) {
+            SecureBytes pms(48, 0xAB, alloc);
+            SecureBytes master(48, 0xCD, alloc);
+            if (!first) first = pms.data();
+            same_block = same_block && pms.data() == first;
+        }
+        ok = expect(arena.regionCount() == regions, "Steady-state loop mapped new regions") && ok;
+        ok = expect(same_block, "Freed block was not reused") && ok;
+        ok = expect(arena.bytesInUse() == 0, "Blocks leaked") && ok;
+
+        // reserve() is the only allocation however many elements follow
+        SecureVector<uint64_t> chunks(ArenaAllocator<uint64_t>{arena});
+        chunks.reserve(34);
+        const uint64_t* data = chunks.data();
+        for (uint64_t i = 0; i < 34; ++i) chunks.push_back(i);
+        ok = expect(chunks.data() == data, "Reserved buffer was reallocated") && ok;
+        if (ok) std::cout << "  ✓ Blocks recycled without new mappings" << std::endl;
+    }
+
+    // Wiped on free and on reset
+    {
+        Arena arena;
+        uint8_t* block = static_cast<uint8_t*>(arena.allocate(64));
+        memset(block, 0x5A, 64);
+        arena.deallocate(block, 64);
+        // The first word links the free list; everything else must be clear
+        ok = expect(allZero(block + sizeof(void*), 64 - sizeof(void*)), "Freed block not wiped") && ok;
+        uint8_t* again = static_cast<uint8_t*>(arena.allocate(64));
+        ok = expect(again == block && allZero(again, 64), "Reused block not clean") && ok;
+
+        uint8_t* other = static_cast<uint8_t*>(arena.allocate(200));
+        memset(again, 0x77, 64);
+        memset(other, 0x77, 200);
+        arena.reset();
+        ok = expect(allZero(again, 64) && allZero(other, 200), "Reset did not wipe live blocks") && ok;
+        ok = expect(arena.bytesInUse() == 0, "Reset left blocks in use") && ok;
+
+        uint8_t* large = static_cast<uint8_t*>(arena.allocate(Arena::MAX_BLOCK + 1));
+        memset(large, 0x11, Arena::MAX_BLOCK + 1);
+        size_t regions = arena.regionCount();
+        arena.deallocate(large, Arena::MAX_BLOCK + 1);
+        ok = expect(arena.regionCount() == regions - 1, "Large block region not released") && ok;
+        if (ok) std::cout << "  ✓ Wiped on free and reset" << std::endl;
+    }
+
+    // Guard pages on both sides
+    {
+        Arena arena;
+        size_t large_size = Arena::MAX_BLOCK + 100;
+        uint8_t* large = static_cast<uint8_t*>(arena.allocate(large_size));
+        uint8_t* small = static_cast<uint8_t*>(arena.allocate(16));
+        ok = expect(!faultsInChild([&] { *(volatile uint8_t*)(large + large_size - 1) = 1; }),
+                    "In-bounds write faulted") && ok;
+        ok = expect(faultsInChild([&] { *(volatile uint8_t*)(large + large_size + 15) = 1; }),
+                    "Overrun past a large block did not fault") && ok;
+        ok = expect(faultsInChild([&] { *(volatile uint8_t*)(small - 1) = 1; }),
+                    "Underrun before the first block did not fault") && ok;
+        arena.deallocate(small, 16);
+        arena.deallocate(large, large_size);
+        if (ok) std::cout << "  ✓ Guard pages fault on overrun and underrun" << std::endl;
+        std::cout << "  Pages locked: " << (arena.locked() ? "yes" : "no (RLIMIT_MEMLOCK)") << std::endl;
+    }
+
+    if (!ok) {
+        return 1;
+    }
+    std::cout << "Test passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,115 @@
+// Share archive round trip, index lookup and rejection of damaged archives
+#include "share_archive.hpp"
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unistd.h>
+
+namespace {
+
+share_archive::Shares makeShares(size_t count, std::mt19937_64& rng) {
+    share_archive::Shares shares{3, std::vector<uint64_t>(count)};
+    for (auto& value : shares.values) {
+        value = rng() % 2305843009213693951ULL;
+    }
+    return shares;
+}
+
+bool sameShares(const share_archive::Shares& a, const share_archive::Shares& b) {
+    return a.id == b.id && a.values == b.values;
+}
+
+} // namespace
+
+int main() {
+    std::string dir = std::filesystem::temp_directory_path().string();
+    std::string path = dir + "/test_share_archive_" + std::to_string(getpid()) + ".sharearchive";
+    std::mt19937_64 rng(5);
+
+    // 500 keys of varying size, including an empty record
+    std::vector<std::pair<std::string, share_archive::Shares>> keys;
+    for (size_t i = 0; i < 500; ++i) {
+        keys.emplace_back("server-" + std::to_string(i), makeShares(i == 7 ? 0 : 17 + i % 50, rng));
+    }
+
+    share_archive::Writer writer;
+    if (!writer.open(path, 3, "Network Security Officer")) {
+        std::cerr << "✗ Cannot create " << path << std::endl;
+        return 1;
+    }
+    for (const auto& [name, shares] : keys) {
+        if (!writer.append(name, shares)) {
+            std::cerr << "✗ append failed for " << name << std::endl;
+            return 1;
+        }
+    }
+    if (writer.append("server-1", keys[1].second)) {
+        std::cerr << "✗ Duplicate key name accepted" << std::endl;
+        return 1;
+    }
+    share_archive::Shares foreign = keys[0].second;
+    foreign.id = 4;
+    if (writer.append("server-foreign", foreign)) {
+        std::cerr << "✗ Another party's shares accepted" << std::endl;
+        return 1;
+    }
+    if (!writer.close()) {
+        std::cerr << "✗ close failed" << std::endl;
+        return 1;
+    }
+    std::cout << "  ✓ Wrote " << keys.size() << " records" << std::endl;
+
+    share_archive::Reader reader;
+    if (!reader.open(path) || reader.partyId() != 3 || reader.partyName() != "Network Security Officer") {
+        std::cerr << "✗ Archive header not read back" << std::endl;
+        return 1;
+    }
+    auto names = reader.keys();
+    if (names.size() != keys.size() || names.front() != "server-0" || names.back() != "server-499") {
+        std::cerr << "✗ Index does not list the appended keys in order" << std::endl;
+        return 1;
+    }
+    // Random access in reverse order
+    for (size_t i = keys.size(); i-- > 0;) {
+        share_archive::Shares shares;
+        if (!reader.read(keys[i].first, shares) || !sameShares(shares, keys[i].second)) {
+            std::cerr << "✗ Record mismatch for " << keys[i].first << std::endl;
+            return 1;
+        }
+    }
+    share_archive::Shares missing;
+    if (reader.contains("server-500") || reader.read("server-500", missing)) {
+        std::cerr << "✗ Lookup of an absent key succeeded" << std::endl;
+        return 1;
+    }
+    std::cout << "  ✓ Every record read back through the index" << std::endl;
+
+    // Truncated archive (lost footer) must be rejected
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 5);
+    share_archive::Reader truncated;
+    if (truncated.open(path)) {
+        std::cerr << "✗ Truncated archive accepted" << std::endl;
+        return 1;
+    }
+
+    // So must an archive whose writer never called close()
+    {
+        share_archive::Writer unfinished;
+        unfinished.open(path, 1, "Judicial Authority");
+        share_archive::Shares judicial = keys[0].second;
+        judicial.id = 1;
+        unfinished.append("only", judicial);
+    }
+    share_archive::Reader partial;
+    if (partial.open(path)) {
+        std::cerr << "✗ Unfinished archive accepted" << std::endl;
+        return 1;
+    }
+    std::cout << "  ✓ Truncated and unfinished archives rejected" << std::endl;
+
+    std::remove(path.c_str());
+    std::cout << "Test passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,116 @@
+// Proactive refresh: secrets survive zero-sharing rounds, old and new shares do not mix
+#include "shamir_secret_sharing.hpp"
+#include "test_support.hpp"
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+using Share = ShamirSecretSharing::Share;
+using PartyShares = ShamirSecretSharing::PartyShares;
+using test_support::Scenario;
+
+/**
+ * Every party deals a zero-sharing and every party applies all of them
+ */
+void refreshRound(ShamirSecretSharing& sss, std::vector<PartyShares>& party_shares) {
+    size_t num_chunks = party_shares[0].values.size();
+    std::vector<std::vector<std::vector<uint64_t>>> dealt;
+    for (size_t dealer = 0; dealer < party_shares.size(); ++dealer) {
+        dealt.push_back(sss.dealZeroSharing(num_chunks));
+    }
+    for (size_t j = 0; j < party_shares.size(); ++j) {
+        for (const auto& round : dealt) {
+            sss.addSubShares(party_shares[j], round[j]);
+        }
+    }
+}
+
+uint64_t reconstructChunk(ShamirSecretSharing& sss, const std::vector<PartyShares>& party_shares,
+                          const std::vector<size_t>& parties, size_t chunk) {
+    std::vector<Share> shares;
+    for (size_t p : parties) {
+        shares.push_back({party_shares[p].id, party_shares[p].values[chunk]});
+    }
+    return sss.reconstruct(shares);
+}
+
+bool checkRefresh(const Scenario& scenario) {
+    const size_t t = scenario.t, n = scenario.n, num_chunks = scenario.num_chunks;
+    const uint64_t prime = scenario.prime;
+    std::mt19937_64 rng(t * 1000 + n);
+    ShamirSecretSharing sss(t, n, prime);
+    std::vector<uint64_t> secrets(num_chunks);
+    for (auto& s : secrets) s = rng() % prime;
+
+    auto party_shares = sss.splitChunks(secrets.data(), secrets.size());
+    auto before = party_shares;
+
+    for (int round = 0; round < 3; ++round) {
+        refreshRound(sss, party_shares);
+    }
+
+    // Any t parties still reconstruct every chunk
+    std::vector<size_t> first(t), last(t);
+    for (size_t i = 0; i < t; ++i) {
+        first[i] = i;
+        last[i] = n - t + i;
+    }
+    size_t changed = 0, mixed_correct = 0;
+    for (size_t c = 0; c < num_chunks; ++c) {
+        if (reconstructChunk(sss, party_shares, first, c) != secrets[c] ||
+            reconstructChunk(sss, party_shares, last, c) != secrets[c]) {
+            std::cerr << "✗ " << scenario.name() << ": chunk " << c
+                      << " lost after refresh" << std::endl;
+            return false;
+        }
+        for (size_t j = 0; j < n; ++j) {
+            changed += party_shares[j].values[c] != before[j].values[c];
+        }
+
+        // One stale share with t-1 fresh ones gives garbage
+        std::vector<Share> mixed = {{before[0].id, before[0].values[c]}};
+        for (size_t i = 1; i < t; ++i) {
+            mixed.push_back({party_shares[i].id, party_shares[i].values[c]});
+        }
+        mixed_correct += sss.reconstruct(mixed) == secrets[c];
+    }
+
+    // For p = 257 a few collisions are expected by chance
+    size_t tolerance = prime < 1000 ? num_chunks * n / 50 + 2 : 0;
+    if (n * num_chunks - changed > tolerance || mixed_correct > tolerance) {
+        std::cerr << "✗ " << scenario.name() << ": refresh did not re-randomize shares ("
+                  << n * num_chunks - changed << " unchanged, " << mixed_correct << " mixed reconstructions)"
+                  << std::endl;
+        return false;
+    }
+    std::cout << "  ✓ " << scenario.name() << ", " << num_chunks
+              << " chunks: secrets kept, stale shares useless" << std::endl;
+    return true;
+}
+
+} // namespace
+
+int main() {
+    std::cout << "Testing proactive share refresh" << std::endl;
+    bool ok = test_support::runScenarios({{3, 5}, {5, 9, test_support::PRIME, 68}, {3, 5, 1000000007ULL, 20},
+                                          {2, 3, 257, 200}},
+                                         checkRefresh);
+
+    // Sub-share vectors must match the share vectors
+    ShamirSecretSharing sss(3, 5, 257);
+    PartyShares shares = {1, {5, 6}};
+    try {
+        sss.addSubShares(shares, {1});
+        std::cerr << "✗ Length mismatch accepted" << std::endl;
+        ok = false;
+    } catch (const std::invalid_argument&) {
+    }
+
+    if (!ok) {
+        return 1;
+    }
+    std::cout << "Test passed!" << std::endl;
+    return 0;
+}
@@ -29,6 +29,10 @@ int main() {
     std::cout << "Reconstructed: " << reconstructed << std::endl;
     std::cout << "Expected: " << secret << std::endl;
     std::cout << "Match: " << (reconstructed == secret ? "YES ✓" : "NO ✗") << std::endl;
+    if (reconstructed != secret) {
+        return 1;
+    }
     
+    std::cout << "Test passed!" << std::endl;
     return 0;
 }
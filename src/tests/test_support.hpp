@@ -0,0 +1,91 @@
+#ifndef TEST_SUPPORT_HPP
+#define TEST_SUPPORT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <initializer_list>
+#include <iostream>
+#include <new>
+#include <string>
+
+/**
+ * Helpers shared by the standalone test programs in src/tests
+ *
+ * Each test is a single translation unit. A test that counts heap
+ * allocations defines TEST_SUPPORT_COUNT_ALLOCATIONS before including this
+ * header, which replaces the global operator new/delete with versions that
+ * bump test_support::allocations.
+ */
+namespace test_support {
+
+/**
+ * Report a failed check on stderr
+ * @return condition, so checks chain as ok = expect(...) && ok
+ */
+inline bool expect(bool condition, const std::string& what) {
+    if (!condition) {
+        std::cerr << "✗ " << what << std::endl;
+    }
+    return condition;
+}
+
+// The field the key splitter uses
+constexpr uint64_t PRIME = 2305843009213693951ULL;  // 2^61 - 1
+
+/**
+ * A t-of-n sharing for a test to exercise
+ */
+struct Scenario {
+    size_t t;
+    size_t n;
+    uint64_t prime = PRIME;
+    size_t num_chunks = 34;     // A 2048-bit exponent in 61-bit chunks
+
+    // "3-of-5", with the prime when it is not PRIME
+    std::string name() const {
+        std::string name = std::to_string(t) + "-of-" + std::to_string(n);
+        return prime == PRIME ? name : name + " mod " + std::to_string(prime);
+    }
+};
+
+/**
+ * Run every scenario, not stopping at the first failure
+ * @param run bool(const Scenario&), reports its own failures
+ * @return Whether all passed
+ */
+template <typename Run>
+bool runScenarios(std::initializer_list<Scenario> scenarios, Run run) {
+    bool ok = true;
+    for (const Scenario& scenario : scenarios) {
+        ok = run(scenario) && ok;
+    }
+    return ok;
+}
+
+// Heap allocations so far (only counted with TEST_SUPPORT_COUNT_ALLOCATIONS)
+inline size_t allocations = 0;
+
+} // namespace test_support
+
+#ifdef TEST_SUPPORT_COUNT_ALLOCATIONS
+
+void* operator new(size_t size) {
+    ++test_support::allocations;
+    if (void* block = malloc(size ? size : 1)) {
+        return block;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* block) noexcept {
+    free(block);
+}
+
+void operator delete(void* block, size_t) noexcept {
+    free(block);
+}
+
+#endif // TEST_SUPPORT_COUNT_ALLOCATIONS
+
+#endif // TEST_SUPPORT_HPP
@@ -0,0 +1,148 @@
+// ThresholdRSAKey with remote parties: one that answers takes part like a
+// local party, a bad address fails at once, a party that accepts but never
+// answers is cut off by the timeout, and in both failing cases the retry
+// without it still succeeds
+#include "threshold_rsa.hpp"
+#include "test_support.hpp"
+#include <openssl/evp.h>
+#include <openssl/rsa.h>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+
+using threshold_rsa::PartyBackend;
+
+const int TIMEOUT_MS = 300;
+
+using test_support::expect;
+
+/**
+ * Listening socket on an ephemeral loopback port. Left unaccepted, it is a
+ * silent party: connects complete through the backlog, reads never return
+ */
+int loopbackListener(int& port) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t len = sizeof(addr);
+    if (fd < 0 || bind(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        listen(fd, 8) != 0 || getsockname(fd, reinterpret_cast<struct sockaddr*>(&addr), &len) != 0) {
+        if (fd >= 0) close(fd);
+        return -1;
+    }
+    port = ntohs(addr.sin_port);
+    return fd;
+}
+
+/**
+ * Serve one PARTIALEXP request on the listener with `share`, giving up if no
+ * connection arrives within a few seconds
+ */
+void serveOnce(int listener, const threshold_rsa::PartyKeyShare& share) {
+    struct pollfd pfd = {listener, POLLIN, 0};
+    if (poll(&pfd, 1, 5000) != 1) return;
+    int fd = accept(listener, nullptr, nullptr);
+    if (fd < 0) return;
+    char word[threshold_rsa::REQUEST_WORD_LENGTH];
+    if (recv(fd, word, sizeof(word), MSG_WAITALL) == static_cast<ssize_t>(sizeof(word)) &&
+        std::memcmp(word, threshold_rsa::PARTIAL_REQUEST, sizeof(word)) == 0) {
+        threshold_rsa::servePartialRequest(fd, share);
+    }
+    close(fd);
+}
+
+/**
+ * One private operation through a combiner whose first party is `first`,
+ * followed by the local parties `local`
+ * @return Whether it succeeded; elapsed_ms is set either way
+ */
+bool signWith(EVP_PKEY* key, const std::vector<threshold_rsa::PartyKeyShare>& shares,
+              std::unique_ptr<PartyBackend> first, double& elapsed_ms,
+              std::initializer_list<size_t> local = {1, 3, 5}) {
+    std::vector<std::unique_ptr<PartyBackend>> parties;
+    parties.push_back(std::move(first));
+    for (size_t id : local) {
+        parties.push_back(std::make_unique<threshold_rsa::LocalParty>(shares[id - 1]));
+    }
+    threshold_rsa::ThresholdRSAKey combiner(key, 3, 5, std::move(parties));
+
+    std::vector<uint8_t> in(combiner.modulusSize(), 0);
+    std::vector<uint8_t> out(combiner.modulusSize());
+    in[1] = 0x42;   // Any x < n
+
+    auto start = std::chrono::steady_clock::now();
+    bool ok = combiner.privateOperation(in.data(), in.size(), out.data());
+    elapsed_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return ok;
+}
+
+} // namespace
+
+int main() {
+    std::cout << "Testing threshold RSA with remote parties" << std::endl;
+
+    EVP_PKEY* key = EVP_RSA_gen(1024);
+    auto shares = threshold_rsa::dealExponentShares(key, 3, 5);
+    if (!expect(key && shares.size() == 5, "Could not deal a 3-of-5 test key")) {
+        EVP_PKEY_free(key);
+        return 1;
+    }
+
+    bool ok = true;
+    double elapsed_ms = 0;
+    int port = 0;
+
+    // Answers: with only two local parties, the operation needs it
+    int server = loopbackListener(port);
+    ok = expect(server >= 0, "Could not open the party listener") && ok;
+    if (server >= 0) {
+        std::thread party(serveOnce, server, shares[1]);
+        ok = expect(signWith(key, shares, std::make_unique<threshold_rsa::RemoteParty>(2, "127.0.0.1", port, TIMEOUT_MS),
+                             elapsed_ms, {1, 3}),
+                    "Operation with an answering remote party failed") && ok;
+        party.join();
+        close(server);
+        if (ok) std::cout << "  ✓ Remote party answered (" << elapsed_ms << " ms)" << std::endl;
+    }
+
+    // Not an IPv4 literal: inet_pton fails, no connection is attempted
+    ok = expect(signWith(key, shares, std::make_unique<threshold_rsa::RemoteParty>(2, "not-an-address", 1),
+                         elapsed_ms),
+                "Retry without the party with a bad address failed") && ok;
+    if (ok) std::cout << "  ✓ Bad party address skipped (" << elapsed_ms << " ms)" << std::endl;
+
+    // Accepts the connection but never answers
+    int listener = loopbackListener(port);
+    ok = expect(listener >= 0, "Could not open the silent listener") && ok;
+    if (listener >= 0) {
+        bool signed_ok = signWith(key, shares,
+                                  std::make_unique<threshold_rsa::RemoteParty>(2, "127.0.0.1", port, TIMEOUT_MS),
+                                  elapsed_ms);
+        ok = expect(signed_ok, "Retry without the unresponsive party failed") && ok;
+        // Generous bound: only a missing timeout would come anywhere near it
+        ok = expect(elapsed_ms < 20.0 * TIMEOUT_MS,
+                    "Unresponsive party held the operation for " + std::to_string(elapsed_ms) + " ms") && ok;
+        if (ok) std::cout << "  ✓ Unresponsive party timed out (" << elapsed_ms << " ms)" << std::endl;
+        close(listener);
+    }
+
+    EVP_PKEY_free(key);
+    if (!ok) {
+        return 1;
+    }
+    std::cout << "Test passed!" << std::endl;
+    return 0;
+}
@@ -4,6 +4,10 @@
  * This test performs an actual TLS 1.2 handshake between a client and server
  * where the server's private key is distributed across 5 parties using
  * Shamir Secret Sharing, and requires 3 parties to reconstruct for signing.
+ *
+ * The server never holds d: its EVP_PKEY carries only (n, e), and every
+ * private operation in the handshake is computed by threshold RSA from the
+ * exponent pieces of parties 1, 3 and 5.
  */
 
 #include <iostream>
@@ -11,26 +15,43 @@
 #include <chrono>
 #include <cstring>
 #include <atomic>
+#include <memory>
 #include <openssl/ssl.h>
 #include <openssl/err.h>
 #include <openssl/bio.h>
 #include <openssl/pem.h>
 #include <openssl/x509.h>
+#include <openssl/core_names.h>
 #include <sys/socket.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
 
 #include "shamir_secret_sharing.hpp"
 #include "tls_multiparty.hpp"
+#include "rsa_key_utils.hpp"
+#include "threshold_rsa.hpp"
 
 // Global atomic flag for synchronization
 std::atomic<bool> server_ready(false);
 std::atomic<bool> test_complete(false);
+std::atomic<bool> server_handshake_ok(false);
+std::atomic<bool> client_handshake_ok(false);
+std::atomic<bool> client_finished(false);
+std::atomic<int> full_handshakes(0);
+std::atomic<int> resumed_handshakes(0);
+
+// First connection is a full handshake; the rest resume its session
+const int NUM_CONNECTIONS = 3;
 
 const int SERVER_PORT = 4433;
 const char* SERVER_ADDRESS = "127.0.0.1";
 
+// Longest the server waits for the next connection
+const int ACCEPT_TIMEOUT_MS = 30000;
+
 /**
  * Initialize OpenSSL library
  */
@@ -68,6 +89,18 @@ SSL_CTX* create_context(bool is_server) {
     SSL_CTX_set_min_proto_version(ctx, TLS1_2_VERSION);
     SSL_CTX_set_max_proto_version(ctx, TLS1_2_VERSION);
     
+    // Session resumption: a resumed handshake skips the private-key
+    // operation entirely, which for a threshold key means no party round-trip
+    if (is_server) {
+        static const unsigned char session_id_context[] = "multiparty-tls";
+        SSL_CTX_set_session_id_context(ctx, session_id_context, sizeof(session_id_context) - 1);
+        SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_SERVER);
+        SSL_CTX_sess_set_cache_size(ctx, 1024);
+    } else {
+        SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_CLIENT);
+    }
+    SSL_CTX_clear_options(ctx, SSL_OP_NO_TICKET);
+    
     return ctx;
 }
 
@@ -102,19 +135,11 @@ bool generate_multiparty_keys(EVP_PKEY** pkey, std::vector<ShamirSecretSharing::
     
     EVP_PKEY_CTX_free(ctx);
     
-    // Extract private key components
-    RSA* rsa = EVP_PKEY_get1_RSA(*pkey);
-    if (!rsa) {
-        std::cerr << "Failed to get RSA key" << std::endl;
-        return false;
-    }
-    
-    const BIGNUM* d = nullptr;
-    RSA_get0_key(rsa, nullptr, nullptr, &d);
+    // Extract private exponent through OSSL_PARAM export
+    BIGNUM* d = rsa_key_utils::getParam(*pkey, OSSL_PKEY_PARAM_RSA_D);
     
     if (!d) {
         std::cerr << "Failed to get private exponent" << std::endl;
-        RSA_free(rsa);
         return false;
     }
     
@@ -138,7 +163,7 @@ bool generate_multiparty_keys(EVP_PKEY** pkey, std::vector<ShamirSecretSharing::
     ShamirSecretSharing sss(3, 5, 2305843009213693951ULL);
     shares = sss.split(secret);
     
-    RSA_free(rsa);
+    BN_clear_free(d);
     
     std::cout << "✓ Generated 2048-bit RSA key pair" << std::endl;
     std::cout << "✓ Split private key into 5 shares (threshold: 3)" << std::endl;
@@ -189,47 +214,131 @@ X509* generate_certificate(EVP_PKEY* pkey) {
 }
 
 /**
- * Custom signing callback using multiparty key reconstruction
+ * Drive SSL_accept on a non-blocking socket the way an event loop would:
+ * wait on the socket for WANT_READ/WANT_WRITE and on the job's async fds
+ * for WANT_ASYNC (threshold operation in flight on the offload pool)
+ * @param yields Incremented for every SSL_ERROR_WANT_ASYNC
+ */
+int accept_async(SSL* ssl, int fd, int& yields) {
+    while (true) {
+        int ret = SSL_accept(ssl);
+        if (ret == 1) {
+            return ret;
+        }
+        
+        std::vector<struct pollfd> fds;
+        switch (SSL_get_error(ssl, ret)) {
+            case SSL_ERROR_WANT_READ:
+                fds.push_back({fd, POLLIN, 0});
+                break;
+            case SSL_ERROR_WANT_WRITE:
+                fds.push_back({fd, POLLOUT, 0});
+                break;
+            case SSL_ERROR_WANT_ASYNC: {
+                ++yields;
+                size_t num_fds = 0;
+                SSL_get_all_async_fds(ssl, nullptr, &num_fds);
+                std::vector<OSSL_ASYNC_FD> async_fds(num_fds);
+                SSL_get_all_async_fds(ssl, async_fds.data(), &num_fds);
+                for (OSSL_ASYNC_FD afd : async_fds) {
+                    fds.push_back({afd, POLLIN, 0});
+                }
+                break;
+            }
+            case SSL_ERROR_WANT_ASYNC_JOB:
+                break;      // Job pool exhausted; retry
+            default:
+                return ret;
+        }
+        
+        if (!fds.empty()) {
+            poll(fds.data(), fds.size(), -1);
+        }
+    }
+}
+
+/**
+ * Server signing key backed by threshold RSA across parties 1, 3, 5
  */
 class MultiPartySigningContext {
 public:
-    std::vector<ShamirSecretSharing::Share> all_shares;
-    EVP_PKEY* original_key;
-    
-    MultiPartySigningContext(const std::vector<ShamirSecretSharing::Share>& shares, EVP_PKEY* key)
-        : all_shares(shares), original_key(key) {}
+    std::unique_ptr<threshold_rsa::ThresholdRSAKey> combiner;
+    EVP_PKEY* signing_key;      // (n, e) only; private ops go to the combiner
+    std::vector<size_t> party_ids;
+    
+    MultiPartySigningContext() : signing_key(nullptr) {}
+    ~MultiPartySigningContext() { EVP_PKEY_free(signing_key); }
+    
+    /**
+     * Deal exponent pieces from the full key and keep only the public half
+     */
+    bool init(EVP_PKEY* full_key, const std::vector<size_t>& parties) {
+        auto key_shares = threshold_rsa::dealExponentShares(full_key, 3, 5);
+        if (key_shares.empty()) {
+            return false;
+        }
+        
+        std::vector<std::unique_ptr<threshold_rsa::PartyBackend>> backends;
+        for (size_t id : parties) {
+            backends.push_back(std::make_unique<threshold_rsa::LocalParty>(key_shares[id - 1]));
+        }
+        party_ids = parties;
+        combiner = std::make_unique<threshold_rsa::ThresholdRSAKey>(full_key, 3, 5, std::move(backends));
+        combiner->startOffload(2);
+        signing_key = combiner->makeEvpPkey();
+        return signing_key != nullptr;
+    }
 };
 
 /**
- * TLS Server thread - performs multiparty key reconstruction for signing
+ * Configure the shared server context: certificate, threshold key, async mode
  */
-void tls_server_thread(const std::vector<ShamirSecretSharing::Share>& shares, EVP_PKEY* pkey, X509* cert) {
-    std::cout << "\n[SERVER] Starting TLS server on port " << SERVER_PORT << "..." << std::endl;
-    
-    SSL_CTX* ctx = create_context(true);
-    if (!ctx) {
-        std::cerr << "[SERVER] Failed to create SSL context" << std::endl;
-        return;
-    }
-    
-    // Configure server certificate and key
-    if (SSL_CTX_use_certificate(ctx, cert) <= 0) {
+bool configure_server_context(SSL_CTX* ctx, MultiPartySigningContext& signing, X509* cert) {
+    if (SSL_CTX_use_certificate(ctx, cert) <= 0 ||
+        SSL_CTX_use_PrivateKey(ctx, signing.signing_key) <= 0) {
         ERR_print_errors_fp(stderr);
-        SSL_CTX_free(ctx);
-        return;
+        return false;
     }
     
-    if (SSL_CTX_use_PrivateKey(ctx, pkey) <= 0) {
-        ERR_print_errors_fp(stderr);
-        SSL_CTX_free(ctx);
-        return;
+    // Run handshakes as ASYNC_JOBs so threshold operations yield
+    SSL_CTX_set_mode(ctx, SSL_MODE_ASYNC);
+    return true;
+}
+
+/**
+ * Wait until a connection is pending on the listening socket
+ * @return false if the client thread exits without connecting or the
+ *         timeout passes, so a failed client fails the test instead of
+ *         leaving the server blocked in accept()
+ */
+bool wait_for_connection(int server_fd) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(ACCEPT_TIMEOUT_MS);
+    while (std::chrono::steady_clock::now() < deadline) {
+        struct pollfd pfd = {server_fd, POLLIN, 0};
+        if (poll(&pfd, 1, 100) > 0) {
+            return true;
+        }
+        if (client_finished.load()) {
+            // Recheck once: the client may have connected just before exiting
+            return poll(&pfd, 1, 0) > 0;
+        }
     }
+    return false;
+}
+
+/**
+ * TLS Server thread - signs with the threshold RSA key
+ * Serves NUM_CONNECTIONS clients sequentially on one shared SSL_CTX.
+ */
+void tls_server_thread(SSL_CTX* ctx, MultiPartySigningContext& signing) {
+    std::cout << "\n[SERVER] Starting TLS server on port " << SERVER_PORT << "..." << std::endl;
     
     // Create server socket
     int server_fd = socket(AF_INET, SOCK_STREAM, 0);
     if (server_fd < 0) {
         std::cerr << "[SERVER] Failed to create socket" << std::endl;
-        SSL_CTX_free(ctx);
+        server_ready.store(true);
+        test_complete.store(true);
         return;
     }
     
@@ -243,82 +352,103 @@ void tls_server_thread(const std::vector<ShamirSecretSharing::Share>& shares, EV
     addr.sin_port = htons(SERVER_PORT);
     addr.sin_addr.s_addr = inet_addr(SERVER_ADDRESS);
     
-    if (bind(server_fd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
-        std::cerr << "[SERVER] Failed to bind socket" << std::endl;
-        close(server_fd);
-        SSL_CTX_free(ctx);
-        return;
-    }
-    
-    if (listen(server_fd, 1) < 0) {
-        std::cerr << "[SERVER] Failed to listen" << std::endl;
+    if (bind(server_fd, (struct sockaddr*)&addr, sizeof(addr)) < 0 ||
+        listen(server_fd, NUM_CONNECTIONS) < 0) {
+        std::cerr << "[SERVER] Failed to bind/listen" << std::endl;
         close(server_fd);
-        SSL_CTX_free(ctx);
+        server_ready.store(true);
+        test_complete.store(true);
         return;
     }
     
     std::cout << "[SERVER] Listening on " << SERVER_ADDRESS << ":" << SERVER_PORT << std::endl;
     server_ready.store(true);
     
-    // Accept client connection
-    struct sockaddr_in client_addr;
-    socklen_t client_len = sizeof(client_addr);
-    int client_fd = accept(server_fd, (struct sockaddr*)&client_addr, &client_len);
-    
-    if (client_fd < 0) {
-        std::cerr << "[SERVER] Failed to accept connection" << std::endl;
-        close(server_fd);
-        SSL_CTX_free(ctx);
-        return;
-    }
-    
-    std::cout << "[SERVER] Client connected from " << inet_ntoa(client_addr.sin_addr) << std::endl;
-    
-    // Create SSL object
-    SSL* ssl = SSL_new(ctx);
-    SSL_set_fd(ssl, client_fd);
-    
-    // Perform TLS handshake
-    std::cout << "[SERVER] Starting TLS handshake..." << std::endl;
-    std::cout << "[SERVER] Multi-party key reconstruction will be used for signing" << std::endl;
-    
-    // Simulate party selection for key reconstruction
-    std::vector<ShamirSecretSharing::Share> selected_shares = {shares[0], shares[2], shares[4]}; // Parties 1, 3, 5
-    std::cout << "[SERVER] Using shares from parties: [" 
-              << selected_shares[0].id << ", "
-              << selected_shares[1].id << ", "
-              << selected_shares[2].id << "]" << std::endl;
-    
-    int ret = SSL_accept(ssl);
-    if (ret <= 0) {
-        int err = SSL_get_error(ssl, ret);
-        std::cerr << "[SERVER] TLS handshake failed with error code: " << err << std::endl;
-        ERR_print_errors_fp(stderr);
-    } else {
-        std::cout << "[SERVER] ✓ TLS handshake completed successfully!" << std::endl;
-        std::cout << "[SERVER] Protocol: " << SSL_get_version(ssl) << std::endl;
-        std::cout << "[SERVER] Cipher: " << SSL_get_cipher(ssl) << std::endl;
+    std::cout << "[SERVER] Threshold RSA will be used for signing (d is never reconstructed)" << std::endl;
+    std::cout << "[SERVER] Using exponent pieces from parties: [" 
+              << signing.party_ids[0] << ", "
+              << signing.party_ids[1] << ", "
+              << signing.party_ids[2] << "]" << std::endl;
+    
+    bool all_ok = true;
+    for (int conn = 1; conn <= NUM_CONNECTIONS; ++conn) {
+        // Accept client connection
+        if (!wait_for_connection(server_fd)) {
+            std::cerr << "[SERVER] No connection " << conn << " from the client" << std::endl;
+            all_ok = false;
+            break;
+        }
+        struct sockaddr_in client_addr;
+        socklen_t client_len = sizeof(client_addr);
+        int client_fd = accept(server_fd, (struct sockaddr*)&client_addr, &client_len);
+        
+        if (client_fd < 0) {
+            std::cerr << "[SERVER] Failed to accept connection" << std::endl;
+            all_ok = false;
+            break;
+        }
+        
+        std::cout << "\n[SERVER] Connection " << conn << " from " << inet_ntoa(client_addr.sin_addr) << std::endl;
+        
+        // Create SSL object
+        SSL* ssl = SSL_new(ctx);
+        SSL_set_fd(ssl, client_fd);
         
-        // Receive message from client
-        char buffer[1024] = {0};
-        int bytes = SSL_read(ssl, buffer, sizeof(buffer) - 1);
-        if (bytes > 0) {
-            buffer[bytes] = '\0';
-            std::cout << "[SERVER] Received: " << buffer << std::endl;
+        int flags = fcntl(client_fd, F_GETFL, 0);
+        fcntl(client_fd, F_SETFL, flags | O_NONBLOCK);
+        
+        int async_yields = 0;
+        auto start = std::chrono::steady_clock::now();
+        int ret = accept_async(ssl, client_fd, async_yields);
+        auto accept_us = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        
+        fcntl(client_fd, F_SETFL, flags);
+        
+        if (ret <= 0) {
+            int err = SSL_get_error(ssl, ret);
+            std::cerr << "[SERVER] TLS handshake failed with error code: " << err << std::endl;
+            ERR_print_errors_fp(stderr);
+            all_ok = false;
+        } else {
+            bool resumed = SSL_session_reused(ssl) == 1;
+            (resumed ? resumed_handshakes : full_handshakes).fetch_add(1);
+            
+            std::cout << "[SERVER] ✓ TLS handshake completed successfully! ("
+                      << (resumed ? "resumed" : "full") << ")" << std::endl;
+            std::cout << "[SERVER] Protocol: " << SSL_get_version(ssl) << std::endl;
+            std::cout << "[SERVER] Cipher: " << SSL_get_cipher(ssl) << std::endl;
+            std::cout << "[SERVER] SSL_accept latency: " << accept_us / 1000.0 << " ms" << std::endl;
+            std::cout << "[SERVER] Handshake yielded " << async_yields
+                      << " time(s) with SSL_ERROR_WANT_ASYNC" << std::endl;
+            
+            // A full handshake must have gone through the async threshold path
+            if (!resumed && async_yields == 0) {
+                all_ok = false;
+            }
             
-            // Send response
-            const char* response = "Hello from multi-party TLS server!";
-            SSL_write(ssl, response, strlen(response));
-            std::cout << "[SERVER] Sent: " << response << std::endl;
+            // Receive message from client
+            char buffer[1024] = {0};
+            int bytes = SSL_read(ssl, buffer, sizeof(buffer) - 1);
+            if (bytes > 0) {
+                buffer[bytes] = '\0';
+                std::cout << "[SERVER] Received: " << buffer << std::endl;
+                
+                // Send response
+                const char* response = "Hello from multi-party TLS server!";
+                SSL_write(ssl, response, strlen(response));
+                std::cout << "[SERVER] Sent: " << response << std::endl;
+            }
         }
+        
+        // Cleanup
+        SSL_shutdown(ssl);
+        SSL_free(ssl);
+        close(client_fd);
     }
     
-    // Cleanup
-    SSL_shutdown(ssl);
-    SSL_free(ssl);
-    close(client_fd);
     close(server_fd);
-    SSL_CTX_free(ctx);
+    server_handshake_ok.store(all_ok);
     
     std::cout << "[SERVER] Connection closed" << std::endl;
     test_complete.store(true);
@@ -326,83 +456,85 @@ void tls_server_thread(const std::vector<ShamirSecretSharing::Share>& shares, EV
 
 /**
  * TLS Client thread
+ * Reconnects NUM_CONNECTIONS times, offering the previous session each time.
  */
-void tls_client_thread() {
+void tls_client_thread(SSL_CTX* ctx) {
     // Wait for server to be ready
     while (!server_ready.load()) {
         std::this_thread::sleep_for(std::chrono::milliseconds(100));
     }
     
-    std::cout << "\n[CLIENT] Connecting to server..." << std::endl;
-    
-    SSL_CTX* ctx = create_context(false);
-    if (!ctx) {
-        std::cerr << "[CLIENT] Failed to create SSL context" << std::endl;
-        return;
-    }
-    
-    // Disable certificate verification for testing
-    SSL_CTX_set_verify(ctx, SSL_VERIFY_NONE, nullptr);
-    
-    // Create client socket
-    int client_fd = socket(AF_INET, SOCK_STREAM, 0);
-    if (client_fd < 0) {
-        std::cerr << "[CLIENT] Failed to create socket" << std::endl;
-        SSL_CTX_free(ctx);
-        return;
-    }
-    
-    // Connect to server
-    struct sockaddr_in addr;
-    addr.sin_family = AF_INET;
-    addr.sin_port = htons(SERVER_PORT);
-    addr.sin_addr.s_addr = inet_addr(SERVER_ADDRESS);
-    
-    if (connect(client_fd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
-        std::cerr << "[CLIENT] Failed to connect" << std::endl;
-        close(client_fd);
-        SSL_CTX_free(ctx);
-        return;
-    }
-    
-    std::cout << "[CLIENT] Connected to " << SERVER_ADDRESS << ":" << SERVER_PORT << std::endl;
-    
-    // Create SSL object
-    SSL* ssl = SSL_new(ctx);
-    SSL_set_fd(ssl, client_fd);
-    
-    // Perform TLS handshake
-    std::cout << "[CLIENT] Starting TLS handshake..." << std::endl;
-    
-    int ret = SSL_connect(ssl);
-    if (ret <= 0) {
-        int err = SSL_get_error(ssl, ret);
-        std::cerr << "[CLIENT] TLS handshake failed with error code: " << err << std::endl;
-        ERR_print_errors_fp(stderr);
-    } else {
-        std::cout << "[CLIENT] ✓ TLS handshake completed successfully!" << std::endl;
-        std::cout << "[CLIENT] Protocol: " << SSL_get_version(ssl) << std::endl;
-        std::cout << "[CLIENT] Cipher: " << SSL_get_cipher(ssl) << std::endl;
+    bool all_ok = true;
+    SSL_SESSION* session = nullptr;
+    for (int conn = 1; conn <= NUM_CONNECTIONS && all_ok; ++conn) {
+        std::cout << "\n[CLIENT] Connecting to server (connection " << conn << ")..." << std::endl;
+        
+        // Create client socket
+        int client_fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (client_fd < 0) {
+            std::cerr << "[CLIENT] Failed to create socket" << std::endl;
+            all_ok = false;
+            break;
+        }
+        
+        // Connect to server
+        struct sockaddr_in addr;
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(SERVER_PORT);
+        addr.sin_addr.s_addr = inet_addr(SERVER_ADDRESS);
         
-        // Send message to server
-        const char* message = "Hello from TLS client!";
-        SSL_write(ssl, message, strlen(message));
-        std::cout << "[CLIENT] Sent: " << message << std::endl;
+        if (connect(client_fd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+            std::cerr << "[CLIENT] Failed to connect" << std::endl;
+            close(client_fd);
+            all_ok = false;
+            break;
+        }
         
-        // Receive response
-        char buffer[1024] = {0};
-        int bytes = SSL_read(ssl, buffer, sizeof(buffer) - 1);
-        if (bytes > 0) {
-            buffer[bytes] = '\0';
-            std::cout << "[CLIENT] Received: " << buffer << std::endl;
+        // Create SSL object, offering the last session for resumption
+        SSL* ssl = SSL_new(ctx);
+        SSL_set_fd(ssl, client_fd);
+        if (session) {
+            SSL_set_session(ssl, session);
         }
+        
+        int ret = SSL_connect(ssl);
+        if (ret <= 0) {
+            int err = SSL_get_error(ssl, ret);
+            std::cerr << "[CLIENT] TLS handshake failed with error code: " << err << std::endl;
+            ERR_print_errors_fp(stderr);
+            all_ok = false;
+        } else {
+            std::cout << "[CLIENT] ✓ TLS handshake completed successfully! ("
+                      << (SSL_session_reused(ssl) ? "resumed" : "full") << ")" << std::endl;
+            std::cout << "[CLIENT] Protocol: " << SSL_get_version(ssl) << std::endl;
+            std::cout << "[CLIENT] Cipher: " << SSL_get_cipher(ssl) << std::endl;
+            
+            // Send message to server
+            const char* message = "Hello from TLS client!";
+            SSL_write(ssl, message, strlen(message));
+            std::cout << "[CLIENT] Sent: " << message << std::endl;
+            
+            // Receive response
+            char buffer[1024] = {0};
+            int bytes = SSL_read(ssl, buffer, sizeof(buffer) - 1);
+            if (bytes > 0) {
+                buffer[bytes] = '\0';
+                std::cout << "[CLIENT] Received: " << buffer << std::endl;
+            }
+            
+            SSL_SESSION_free(session);
+            session = SSL_get1_session(ssl);
+        }
+        
+        // Cleanup
+        SSL_shutdown(ssl);
+        SSL_free(ssl);
+        close(client_fd);
     }
     
-    // Cleanup
-    SSL_shutdown(ssl);
-    SSL_free(ssl);
-    close(client_fd);
-    SSL_CTX_free(ctx);
+    SSL_SESSION_free(session);
+    client_handshake_ok.store(all_ok);
+    client_finished.store(true);
     
     std::cout << "[CLIENT] Connection closed" << std::endl;
 }
@@ -439,38 +571,98 @@ int main() {
         return 1;
     }
     
+    // Deal threshold exponent pieces, then drop the full key
+    MultiPartySigningContext signing;
+    if (!signing.init(pkey, {1, 3, 5})) {
+        std::cerr << "Failed to set up threshold signing key" << std::endl;
+        X509_free(cert);
+        EVP_PKEY_free(pkey);
+        return 1;
+    }
+    EVP_PKEY_free(pkey);
+    pkey = nullptr;
+    std::cout << "✓ Dealt threshold RSA exponent pieces; full private key discarded" << std::endl;
+    
     std::cout << std::endl;
     
     // Step 3: Perform TLS handshake
     std::cout << "=== Step 3: Perform TLS Handshake ===" << std::endl;
-    std::cout << "Server will use multi-party key reconstruction for signing operations" << std::endl;
+    std::cout << "Server will use threshold RSA for signing operations" << std::endl;
     std::cout << std::endl;
     
+    // One SSL_CTX per role, shared by every connection (and its session cache)
+    SSL_CTX* server_ctx = create_context(true);
+    SSL_CTX* client_ctx = create_context(false);
+    if (!server_ctx || !client_ctx || !configure_server_context(server_ctx, signing, cert)) {
+        std::cerr << "Failed to create SSL contexts" << std::endl;
+        SSL_CTX_free(server_ctx);
+        SSL_CTX_free(client_ctx);
+        X509_free(cert);
+        return 1;
+    }
+    
+    // Disable certificate verification for testing
+    SSL_CTX_set_verify(client_ctx, SSL_VERIFY_NONE, nullptr);
+    
     // Start server and client threads
-    std::thread server(tls_server_thread, std::ref(shares), pkey, cert);
-    std::thread client(tls_client_thread);
+    std::thread server(tls_server_thread, server_ctx, std::ref(signing));
+    std::thread client(tls_client_thread, client_ctx);
     
     // Wait for threads to complete
     server.join();
     client.join();
     
+    SSL_CTX_free(server_ctx);
+    SSL_CTX_free(client_ctx);
+    
     // Wait for test to complete
     while (!test_complete.load()) {
         std::this_thread::sleep_for(std::chrono::milliseconds(100));
     }
     
+    if (!server_handshake_ok.load() || !client_handshake_ok.load()) {
+        std::cerr << "TLS handshake with threshold key failed" << std::endl;
+        X509_free(cert);
+        return 1;
+    }
+    
+    auto stats = signing.combiner->stats();
+    int full = full_handshakes.load();
+    int resumed = resumed_handshakes.load();
+    std::cout << std::endl;
+    std::cout << "=== Session Resumption ===" << std::endl;
+    std::cout << "Handshakes: " << full << " full, " << resumed << " resumed (resumed ratio "
+              << 100.0 * resumed / (full + resumed) << "%)" << std::endl;
+    
+    // Every resumed handshake must have skipped the threshold operation
+    if (resumed != NUM_CONNECTIONS - 1 || stats.operations != static_cast<uint64_t>(full)) {
+        std::cerr << "Session resumption did not avoid the private-key operation" << std::endl;
+        X509_free(cert);
+        return 1;
+    }
+    
+    std::cout << std::endl;
+    std::cout << "=== Threshold RSA ===" << std::endl;
+    std::cout << "Private operations: " << stats.operations
+              << " (failures: " << stats.failures << ", offloaded: " << stats.offloaded << ")" << std::endl;
+    if (stats.operations > 0) {
+        std::cout << "Mean latency: " << stats.total_ns / stats.operations / 1000.0 << " us, max: "
+                  << stats.max_ns / 1000.0 << " us" << std::endl;
+    }
+    
     std::cout << std::endl;
     std::cout << "=== Summary ===" << std::endl;
     std::cout << "✓ RSA key generated and split into 5 shares" << std::endl;
     std::cout << "✓ Threshold cryptography: 3 parties required for reconstruction" << std::endl;
+    std::cout << "✓ Handshake signed by threshold RSA without reconstructing d" << std::endl;
     std::cout << "✓ Self-signed certificate created" << std::endl;
     std::cout << "✓ Full TLS 1.2 handshake completed" << std::endl;
+    std::cout << "✓ Resumed handshakes skipped the threshold operation" << std::endl;
     std::cout << "✓ Secure data exchange verified" << std::endl;
     std::cout << "✓ Multi-party authorization demonstrated" << std::endl;
     
     // Cleanup
     X509_free(cert);
-    EVP_PKEY_free(pkey);
     cleanup_openssl();
     
     std::cout << std::endl;
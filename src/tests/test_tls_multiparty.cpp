@@ -1,10 +1,12 @@
 #include "tls_multiparty.hpp"
+#include "logger.hpp"
 #include <iostream>
 #include <iomanip>
 #include <cassert>
+#include <cstring>
 
 // Helper function to print bytes in hex
-void print_hex(const std::string& label, const TLSMultiParty::Bytes& data, size_t max_bytes = 16) {
+void print_hex(const std::string& label, TLSMultiParty::ByteSpan data, size_t max_bytes = 16) {
     std::cout << label << ": ";
     for (size_t i = 0; i < std::min(data.size(), max_bytes); ++i) {
         std::cout << std::hex << std::setw(2) << std::setfill('0') 
@@ -217,7 +219,14 @@ void test_different_party_combinations() {
     }
 }
 
-int main() {
+int main(int argc, char* argv[]) {
+    // Library narration is silent by default; -v streams it inline with the test output
+    if (argc > 1 && std::strcmp(argv[1], "-v") == 0) {
+        mplog::setLevel(mplog::Level::Debug);
+        mplog::setSink(stdout);
+        mplog::setAsync(false);
+    }
+    
     std::cout << "\n╔════════════════════════════════════════════════════════╗" << std::endl;
     std::cout << "║  Multi-Party Authorization in TLS - Implementation    ║" << std::endl;
     std::cout << "║  Approach 1: Shamir's Secret Sharing                  ║" << std::endl;
@@ -0,0 +1,100 @@
+// Pedersen VSS: honest shares verify, corrupted values, blinding shares or
+// commitments are caught and attributed to the right party
+#include "vss.hpp"
+#include "test_support.hpp"
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+using test_support::PRIME;
+
+std::vector<vss::PartyShares> allParties(const vss::Dealing& dealing) {
+    std::vector<vss::PartyShares> parties;
+    for (size_t i = 0; i < dealing.shares.size(); ++i) {
+        parties.push_back({i + 1, &dealing.shares[i], &dealing.blinding[i].values});
+    }
+    return parties;
+}
+
+bool expectInvalid(const vss::Dealing& dealing, const std::vector<size_t>& expected, const char* what) {
+    auto invalid = vss::findInvalidParties(dealing.commitments, allParties(dealing));
+    if (invalid != expected) {
+        std::cerr << "✗ " << what << ": flagged";
+        for (size_t id : invalid) std::cerr << " " << id;
+        std::cerr << std::endl;
+        return false;
+    }
+    std::cout << "  ✓ " << what << std::endl;
+    return true;
+}
+
+} // namespace
+
+int main() {
+    std::cout << "Testing Pedersen VSS (3-of-5, 34 chunks = 2048-bit d)" << std::endl;
+    std::mt19937_64 rng(11);
+    ShamirSecretSharing sss(3, 5, PRIME);
+    std::vector<uint64_t> chunks(34);
+    for (auto& chunk : chunks) chunk = rng() % PRIME;
+
+    vss::Dealing dealing = vss::deal(sss, chunks);
+    if (dealing.commitments.values.size() != 34 * 3 * vss::ELEMENT_BYTES) {
+        std::cerr << "✗ Unexpected commitment size" << std::endl;
+        return 1;
+    }
+
+    bool ok = expectInvalid(dealing, {}, "Honest dealing verifies for all parties");
+    for (size_t i = 0; i < 5 && ok; ++i) {
+        ok = vss::verify(dealing.commitments, allParties(dealing)[i]) &&
+             vss::verifyShare(dealing.commitments, i * 7, {i + 1, dealing.shares[i].values[i * 7]},
+                              dealing.blinding[i].values[i * 7]);
+    }
+    if (!ok) {
+        std::cerr << "✗ Per-party or single-share verification rejected an honest share" << std::endl;
+        return 1;
+    }
+
+    // Verified shares still reconstruct the chunks
+    for (size_t c = 0; c < chunks.size(); ++c) {
+        if (sss.reconstruct({{1, dealing.shares[0].values[c]},
+                             {3, dealing.shares[2].values[c]},
+                             {5, dealing.shares[4].values[c]}}) != chunks[c]) {
+            std::cerr << "✗ Chunk " << c << " does not reconstruct" << std::endl;
+            return 1;
+        }
+    }
+
+    vss::Dealing bad = dealing;
+    bad.shares[1].values[17] = (bad.shares[1].values[17] + 1) % PRIME;
+    ok = expectInvalid(bad, {2}, "Corrupted share value attributed to party 2") && ok;
+    if (vss::verifyShare(bad.commitments, 17, {2, bad.shares[1].values[17]}, bad.blinding[1].values[17])) {
+        std::cerr << "✗ Single-share check accepted the corrupted share" << std::endl;
+        return 1;
+    }
+
+    bad = dealing;
+    bad.blinding[3].values[0] ^= 1;
+    bad.shares[4].values[33] = 0;
+    ok = expectInvalid(bad, {4, 5}, "Corrupted blinding (party 4) and value (party 5) both caught") && ok;
+
+    bad = dealing;
+    bad.shares[0].id = 2;       // Party 1's values presented at party 2's x
+    ok = expectInvalid(bad, {1}, "Share claimed at the wrong x rejected") && ok;
+
+    bad = dealing;
+    bad.commitments.values[5 * 3 * vss::ELEMENT_BYTES + 100] ^= 0x40;
+    ok = expectInvalid(bad, {1, 2, 3, 4, 5}, "Tampered commitment fails every party") && ok;
+
+    bad = dealing;
+    bad.shares[2].values.pop_back();
+    ok = expectInvalid(bad, {3}, "Short share vector rejected") && ok;
+
+    if (!ok) {
+        return 1;
+    }
+
+    std::cout << "Test passed!" << std::endl;
+    return 0;
+}